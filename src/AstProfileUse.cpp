@@ -21,6 +21,7 @@
 #include "profile/ProgramRun.h"
 #include "profile/Reader.h"
 #include "profile/Relation.h"
+#include <algorithm>
 #include <limits>
 #include <string>
 
@@ -61,4 +62,41 @@ size_t AstProfileUse::getRelationSize(const AstRelationIdentifier& rel) {
     }
 }
 
+/**
+ * Get the average size of the delta relation of a recursive relation from the profile,
+ * i.e., the number of tuples derived per productive iteration of its fixpoint loop
+ */
+size_t AstProfileUse::getDeltaSize(const AstRelationIdentifier& rel) {
+    const auto* profRel = programRun->getRelation(rel.getName());
+    if (profRel == nullptr) {
+        return std::numeric_limits<size_t>::max();
+    }
+
+    size_t tuples = 0;
+    size_t iterations = 0;
+    for (const auto& iter : profRel->getIterations()) {
+        if (iter->size() > 0) {
+            tuples += iter->size();
+            iterations++;
+        }
+    }
+
+    // relations without recorded iterations are not evaluated semi-naively
+    if (iterations == 0) {
+        return profRel->size();
+    }
+    return std::max<size_t>(tuples / iterations, 1);
+}
+
+/**
+ * Get the estimated number of distinct values of a column of a relation from the
+ * statistics sampled by the profiler
+ */
+size_t AstProfileUse::getDistinctValues(const AstRelationIdentifier& rel, size_t column) {
+    if (const auto* profRel = programRun->getRelation(rel.getName())) {
+        return profRel->getColumnDistinct(column);
+    }
+    return 0;
+}
+
 }  // end of namespace souffle
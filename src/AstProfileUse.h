@@ -51,6 +51,12 @@ public:
 
     /** Return size of relation in the profile */
     size_t getRelationSize(const AstRelationIdentifier& rel);
+
+    /** Return the average number of new tuples per iteration of a recursive relation in the profile */
+    size_t getDeltaSize(const AstRelationIdentifier& rel);
+
+    /** Return the estimated number of distinct values of a column of a relation, 0 if unknown */
+    size_t getDistinctValues(const AstRelationIdentifier& rel, size_t column);
 };
 
 }  // end of namespace souffle
@@ -59,6 +59,9 @@
 /* Relation uses a union relation */
 #define EQREL_RELATION (0x100)
 
+/* Relation uses btree indexes referencing a single copy of each tuple */
+#define INDIRECT_RELATION (0x200)
+
 /* Relation warnings are suppressed */
 #define SUPPRESSED_RELATION (0x800)
 
@@ -123,6 +126,8 @@ public:
             representation = RelationRepresentation::BRIE;
         } else if (q & BTREE_RELATION) {
             representation = RelationRepresentation::BTREE;
+        } else if (q & INDIRECT_RELATION) {
+            representation = RelationRepresentation::INDIRECT;
         }
 
         if (q & INPUT_RELATION) {
@@ -267,6 +267,26 @@ void AstSemanticChecker::checkProgram(AstTranslationUnit& translationUnit) {
         }
     });
 
+    // - replicated execution -
+    // every process creates symbols and counter values on its own, such that they differ between processes
+    if (Global::config().get("engine") == "mpi-replicated") {
+        const std::string unsupported = " is not supported by the execution engine mpi-replicated";
+        visitDepthFirst(nodes, [&](const AstIntrinsicFunctor& fun) {
+            if (fun.isSymbolic()) {
+                report.addError("Symbolic functor" + unsupported, fun.getSrcLoc());
+            }
+        });
+        visitDepthFirst(nodes, [&](const AstUserDefinedFunctor& fun) {
+            const AstFunctorDeclaration* funDecl = program.getFunctorDeclaration(fun.getName());
+            if (funDecl != nullptr && funDecl->isSymbolic()) {
+                report.addError("Symbolic functor" + unsupported, fun.getSrcLoc());
+            }
+        });
+        visitDepthFirst(nodes, [&](const AstCounter& counter) {
+            report.addError("Auto-increment functor" + unsupported, counter.getSrcLoc());
+        });
+    }
+
     // - binary relation -
     visitDepthFirst(nodes, [&](const AstBinaryConstraint& constraint) {
         // only interested in non-equal constraints
@@ -621,6 +641,14 @@ void AstSemanticChecker::checkRelationDeclaration(ErrorReport& report, const Typ
         if (typeEnv.isType(typeName)) {
             const Type& type = typeEnv.getType(typeName);
             if (isRecordType(type)) {
+                // records are packed by every process of a replicated execution on its own
+                if (Global::config().get("engine") == "mpi-replicated") {
+                    report.addError("Record types are not supported by the execution engine mpi-replicated. "
+                                    "Attribute " +
+                                            attr->getAttributeName() + " has record type " +
+                                            toString(attr->getTypeName()),
+                            attr->getSrcLoc());
+                }
                 // TODO (#467) remove the next line to enable subprogram compilation for record types
                 Global::config().unset("engine");
 
@@ -54,6 +54,7 @@
 #include <iostream>
 #include <map>
 #include <memory>
+#include <numeric>
 #include <set>
 #include <typeinfo>
 #include <utility>
@@ -79,7 +80,7 @@ void AstTranslator::makeIODirective(IODirectives& ioDirective, const AstRelation
     }
 
     // load intermediate relations from correct files
-    if (ioDirective.getIOType() == "file") {
+    if (ioDirective.hasFileIOType()) {
         // all intermediate relations are given the default delimiter and have no headers
         if (isIntermediate) {
             ioDirective.set("intermediate", "true");
@@ -89,11 +90,12 @@ void AstTranslator::makeIODirective(IODirectives& ioDirective, const AstRelation
 
         // set filename by relation if not given, or if relation is intermediate
         if (!ioDirective.has("filename") || isIntermediate) {
-            ioDirective.setFileName(ioDirective.getRelationName() + fileExt);
+            const bool isBinary = ioDirective.getIOType() == "binary";
+            ioDirective.setFileName(ioDirective.getRelationName() + (isBinary ? ".bin" : fileExt));
         }
 
         // if filename is not an absolute path, concat with cmd line facts directory
-        if (ioDirective.getIOType() == "file" && ioDirective.getFileName().front() != '/') {
+        if (ioDirective.getFileName().front() != '/') {
             ioDirective.setFileName(filePath + "/" + ioDirective.getFileName());
         }
     }
@@ -621,6 +623,148 @@ std::unique_ptr<RamCondition> AstTranslator::ProvenanceClauseTranslator::createC
     return nullptr;
 }
 
+/**
+ * Checks whether the hypergraph of the given variable sets is cyclic, by the GYO reduction
+ * repeatedly removing variables occurring in a single set and sets contained in others.
+ */
+static bool isCyclic(std::vector<std::set<std::string>> edges) {
+    bool changed = true;
+    while (changed && !edges.empty()) {
+        changed = false;
+
+        // remove variables occurring in a single edge
+        std::map<std::string, int> occurrences;
+        for (const auto& edge : edges) {
+            for (const std::string& var : edge) {
+                occurrences[var]++;
+            }
+        }
+        for (auto& edge : edges) {
+            for (auto it = edge.begin(); it != edge.end();) {
+                if (occurrences[*it] == 1) {
+                    it = edge.erase(it);
+                    changed = true;
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        // remove edges contained in another edge
+        for (size_t i = 0; i < edges.size(); ++i) {
+            for (size_t j = 0; j < edges.size(); ++j) {
+                if (i != j && std::includes(edges[j].begin(), edges[j].end(), edges[i].begin(),
+                                      edges[i].end())) {
+                    edges.erase(edges.begin() + i);
+                    changed = true;
+                    --i;
+                    break;
+                }
+            }
+        }
+        if (edges.size() == 1 && edges[0].empty()) {
+            edges.clear();
+        }
+    }
+    return !edges.empty();
+}
+
+std::unique_ptr<RamStatement> AstTranslator::ClauseTranslator::translateLeapfrogClause(
+        const AstClause& clause, const AstClause& originalClause) {
+    // the rule must consist of atoms with distinct variables as arguments, and constraints over them
+    const std::vector<AstAtom*> atoms = clause.getAtoms();
+    std::vector<std::set<std::string>> edges;
+    std::vector<std::string> variables;
+    std::map<std::string, int> occurrences;
+    for (const AstAtom* atom : atoms) {
+        auto rep = translator.translateRelation(atom)->get()->getRepresentation();
+        if (atom->getArity() == 0 ||
+                (rep != RelationRepresentation::DEFAULT && rep != RelationRepresentation::BTREE &&
+                        rep != RelationRepresentation::INDIRECT)) {
+            return nullptr;
+        }
+        std::set<std::string> edge;
+        for (const AstArgument* arg : atom->getArguments()) {
+            const auto* var = dynamic_cast<const AstVariable*>(arg);
+            if (var == nullptr || !edge.insert(var->getName()).second) {
+                return nullptr;
+            }
+            if (occurrences[var->getName()]++ == 0) {
+                variables.push_back(var->getName());
+            }
+        }
+        edges.push_back(edge);
+    }
+    bool supported = true;
+    visitDepthFirst(clause, [&](const AstAggregator&) { supported = false; });
+    visitDepthFirst(clause, [&](const AstRecordInit&) { supported = false; });
+    visitDepthFirst(clause, [&](const AstVariable& var) {
+        supported = supported && occurrences.count(var.getName()) > 0;
+    });
+    if (!supported || !isCyclic(edges)) {
+        return nullptr;
+    }
+
+    // bind variables shared by most atoms first
+    std::stable_sort(variables.begin(), variables.end(),
+            [&](const std::string& a, const std::string& b) { return occurrences[a] > occurrences[b]; });
+    std::map<std::string, int> rank;
+    for (size_t i = 0; i < variables.size(); ++i) {
+        rank[variables[i]] = i;
+    }
+
+    // the variable of each level is the only element of its tuple
+    for (const AstAtom* atom : atoms) {
+        for (const AstArgument* arg : atom->getArguments()) {
+            const auto* var = static_cast<const AstVariable*>(arg);
+            valueIndex.addVarReference(*var, rank[var->getName()], 0);
+        }
+    }
+
+    std::unique_ptr<RamOperation> op = createOperation(clause);
+    for (const auto& lit : clause.getBodyLiterals()) {
+        if (auto condition = translator.translateConstraint(lit, valueIndex)) {
+            op = std::make_unique<RamFilter>(std::move(condition), std::move(op));
+        }
+    }
+
+    // intersect the atoms containing the variable of each level, indexed in the order of the variables
+    for (int level = variables.size() - 1; level >= 0; --level) {
+        std::vector<std::unique_ptr<RamRelationReference>> relations;
+        std::vector<std::vector<int>> orders;
+        std::vector<std::vector<std::unique_ptr<RamExpression>>> prefixes;
+        for (const AstAtom* atom : atoms) {
+            std::vector<int> order(atom->getArity());
+            std::iota(order.begin(), order.end(), 0);
+            auto rankOf = [&](int pos) {
+                return rank[static_cast<const AstVariable*>(atom->getArgument(pos))->getName()];
+            };
+            std::sort(order.begin(), order.end(), [&](int a, int b) { return rankOf(a) < rankOf(b); });
+
+            std::vector<std::unique_ptr<RamExpression>> prefix;
+            for (int pos : order) {
+                if (rankOf(pos) >= level) {
+                    break;
+                }
+                prefix.push_back(std::make_unique<RamTupleElement>(rankOf(pos), 0));
+            }
+            if (prefix.size() < order.size() && rankOf(order[prefix.size()]) == level) {
+                relations.push_back(translator.translateRelation(atom));
+                orders.push_back(order);
+                prefixes.push_back(std::move(prefix));
+            }
+        }
+        op = std::make_unique<RamIntersection>(
+                level, std::move(relations), std::move(orders), std::move(prefixes), std::move(op));
+    }
+
+    std::unique_ptr<RamCondition> cond = createCondition(originalClause);
+    if (cond != nullptr) {
+        return std::make_unique<RamQuery>(std::make_unique<RamFilter>(std::move(cond), std::move(op)));
+    }
+    return std::make_unique<RamQuery>(std::move(op));
+}
+
 /** generate RAM code for a clause */
 std::unique_ptr<RamStatement> AstTranslator::ClauseTranslator::translateClause(
         const AstClause& clause, const AstClause& originalClause, const int version) {
@@ -647,6 +791,14 @@ std::unique_ptr<RamStatement> AstTranslator::ClauseTranslator::translateClause(
     // the rest should be rules
     assert(clause.isRule());
 
+    // evaluate cyclic rule bodies by worst-case optimal joins if requested, unless the order is imposed
+    if (Global::config().has("leapfrog-joins") && !Global::config().has("provenance") &&
+            !clause.hasFixedExecutionPlan()) {
+        if (auto stmt = translateLeapfrogClause(clause, originalClause)) {
+            return stmt;
+        }
+    }
+
     createValueIndex(clause);
 
     // -- create RAM statement --
@@ -1027,6 +1179,14 @@ std::unique_ptr<RamStatement> AstTranslator::translateRecursiveRelation(
                                 std::unique_ptr<RamRelationReference>(relNew[rel]->clone())),
                         std::make_unique<RamClear>(
                                 std::unique_ptr<RamRelationReference>(relNew[rel]->clone()))));
+#ifdef USE_MPI
+        /* in replicated evaluation, each process continues with its own share of the new delta */
+        if (Global::config().get("engine") == "mpi-replicated") {
+            appendStmt(updateRelTable,
+                    std::make_unique<RamPartition>(
+                            std::unique_ptr<RamRelationReference>(relDelta[rel]->clone())));
+        }
+#endif
 
         /* measure update time for each relation */
         if (Global::config().has("profile")) {
@@ -1049,6 +1209,12 @@ std::unique_ptr<RamStatement> AstTranslator::translateRecursiveRelation(
         appendStmt(preamble,
                 std::make_unique<RamMerge>(std::unique_ptr<RamRelationReference>(relDelta[rel]->clone()),
                         std::unique_ptr<RamRelationReference>(rrel[rel]->clone())));
+#ifdef USE_MPI
+        if (Global::config().get("engine") == "mpi-replicated") {
+            appendStmt(preamble, std::make_unique<RamPartition>(
+                                         std::unique_ptr<RamRelationReference>(relDelta[rel]->clone())));
+        }
+#endif
 
         /* Add update operations of relations to parallel statements */
         updateTable->add(std::move(updateRelTable));
@@ -1114,8 +1280,34 @@ std::unique_ptr<RamStatement> AstTranslator::translateRecursiveRelation(
                     }
                 }
 
-                std::unique_ptr<RamStatement> rule =
-                        ClauseTranslator(*this).translateClause(*r1, *cl, version);
+                std::unique_ptr<RamStatement> rule;
+                const auto* plan = cl->getExecutionPlan();
+                const size_t numAtoms = r1->getAtoms().size();
+                if (Global::config().has("adaptive-joins") && numAtoms > 1 &&
+                        (plan == nullptr || !plan->hasOrderFor(version))) {
+                    // keep one variant per atom scanned first, the interpreter picks one per iteration
+                    std::string message;
+                    if (Global::config().has("profile")) {
+                        message = LogStatement::vRecursiveRule(toString(rel->getName()), version,
+                                cl->getSrcLoc(), stringify(toString(*cl)));
+                    }
+                    auto adaptive = std::make_unique<RamAdaptiveQuery>(message);
+                    for (size_t first = 0; first < numAtoms; ++first) {
+                        std::vector<unsigned int> order = {static_cast<unsigned int>(first)};
+                        for (size_t k = 0; k < numAtoms; ++k) {
+                            if (k != first) {
+                                order.push_back(k);
+                            }
+                        }
+                        std::unique_ptr<AstClause> variant(r1->clone());
+                        variant->clearExecutionPlan();
+                        variant->reorderAtoms(order);
+                        adaptive->add(ClauseTranslator(*this).translateClause(*variant, *cl, version));
+                    }
+                    rule = std::move(adaptive);
+                } else {
+                    rule = ClauseTranslator(*this).translateClause(*r1, *cl, version);
+                }
 
                 /* add logging */
                 if (Global::config().has("profile")) {
@@ -1177,11 +1369,26 @@ std::unique_ptr<RamStatement> AstTranslator::translateRecursiveRelation(
                                        std::unique_ptr<RamRelationReference>(relNew[rel]->clone())));
     }
 
+    /* compute the new tuples of all processes before checking for termination */
+    std::unique_ptr<RamStatement> exchange;
+#ifdef USE_MPI
+    if (Global::config().get("engine") == "mpi-replicated") {
+        for (const AstRelation* rel : scc) {
+            appendStmt(exchange, std::make_unique<RamExchange>(
+                                         std::unique_ptr<RamRelationReference>(relNew[rel]->clone())));
+        }
+    }
+#endif
+
     /* construct fixpoint loop  */
     std::unique_ptr<RamStatement> res;
     if (preamble) appendStmt(res, std::move(preamble));
     if (!loopSeq->getStatements().empty() && exitCond && updateTable) {
-        appendStmt(res, std::make_unique<RamLoop>(std::move(loopSeq),
+        std::unique_ptr<RamStatement> loopBody = std::move(loopSeq);
+        if (exchange) {
+            loopBody = std::make_unique<RamSequence>(std::move(loopBody), std::move(exchange));
+        }
+        appendStmt(res, std::make_unique<RamLoop>(std::move(loopBody),
                                 std::make_unique<RamExit>(std::move(exitCond)), std::move(updateTable)));
     }
     if (postamble) {
@@ -1442,6 +1649,11 @@ void AstTranslator::translateProgram(const AstTranslationUnit& translationUnit)
     // handle the case of an empty SCC graph
     if (sccGraph.getNumberOfSCCs() == 0) return;
 
+    // whether the strata are executed as separate subprograms, as opposed to all processes of a
+    // replicated execution running the whole program
+    const bool isSubprogram =
+            Global::config().has("engine") && Global::config().get("engine") != "mpi-replicated";
+
     // a function to load relations
     const auto& makeRamLoad = [&](std::unique_ptr<RamStatement>& current, const AstRelation* relation,
                                       const std::string& inputDirectory, const std::string& fileExtension) {
@@ -1495,6 +1707,10 @@ void AstTranslator::translateProgram(const AstTranslationUnit& translationUnit)
     const auto& makeRamWait = [&](std::unique_ptr<RamStatement>& current, const size_t count) {
         appendStmt(current, std::make_unique<RamWait>(count));
     };
+
+    const auto& makeRamBroadcast = [&](std::unique_ptr<RamStatement>& current, const AstRelation* relation) {
+        appendStmt(current, std::make_unique<RamBroadcast>(translateRelation(relation)));
+    };
 #endif
 
     // maintain the index of the SCC within the topological order
@@ -1556,10 +1772,16 @@ void AstTranslator::translateProgram(const AstTranslationUnit& translationUnit)
             // load all internal input relations from the facts dir with a .facts extension
             for (const auto& relation : internIns) {
                 makeRamLoad(current, relation, "fact-dir", ".facts");
+#ifdef USE_MPI
+                // the master process loads the input relations, the others obtain a copy
+                if (Global::config().get("engine") == "mpi-replicated") {
+                    makeRamBroadcast(current, relation);
+                }
+#endif
             }
 
-            // if a communication engine has been specified...
-            if (Global::config().has("engine")) {
+            // if the current SCC is executed as a subprogram...
+            if (isSubprogram) {
                 // load all external output predecessor relations from the output dir with a .csv
                 // extension
                 for (const auto& relation : externOutPreds) {
@@ -1578,6 +1800,16 @@ void AstTranslator::translateProgram(const AstTranslationUnit& translationUnit)
                                          *((const AstRelation*)*allInterns.begin()), recursiveClauses)
                                : translateRecursiveRelation(allInterns, recursiveClauses);
         appendStmt(current, std::move(bodyStatement));
+
+        // log the column statistics of the computed relations for profile-guided optimisations
+        if (Global::config().has("profile")) {
+            for (const auto& relation : allInterns) {
+                const std::string logStatistics =
+                        LogStatement::sRelationStatistics(toString(relation->getName()));
+                appendStmt(current,
+                        std::make_unique<RamLogStatistics>(translateRelation(relation), logStatistics));
+            }
+        }
 #ifdef USE_MPI
         // note that the order of sends is first by relation then second destination
         if (Global::config().get("engine") == "mpi") {
@@ -1595,8 +1827,8 @@ void AstTranslator::translateProgram(const AstTranslationUnit& translationUnit)
         } else
 #endif
         {
-            // if a communication engine is enabled...
-            if (Global::config().has("engine")) {
+            // if the current SCC is executed as a subprogram...
+            if (isSubprogram) {
                 // store all internal non-output relations with external successors to the output dir with
                 // a .facts extension
                 for (const auto& relation : internNonOutsWithExternSuccs) {
@@ -1612,8 +1844,8 @@ void AstTranslator::translateProgram(const AstTranslationUnit& translationUnit)
 
         // if provenance is not enabled...
         if (!Global::config().has("provenance")) {
-            // if a communication engine is enabled...
-            if (Global::config().has("engine")) {
+            // if the current SCC is executed as a subprogram...
+            if (isSubprogram) {
                 // drop all internal relations
                 for (const auto& relation : allInterns) {
                     makeRamDrop(current, relation);
@@ -339,6 +339,13 @@ private:
 
         void createValueIndex(const AstClause& clause);
 
+        /**
+         * translate a rule with a cyclic body into a worst-case optimal join, binding one variable
+         * per level by a leapfrog join of the atoms containing it; null if the rule is not eligible
+         */
+        std::unique_ptr<RamStatement> translateLeapfrogClause(
+                const AstClause& clause, const AstClause& originalClause);
+
     protected:
         AstTranslator& translator;
 
@@ -476,6 +476,21 @@ protected:
             return sum;
         }
 
+        /**
+         * Counts the number of entries contained in the sub-tree rooted
+         * by this node, stopping once more than the given limit is reached.
+         */
+        size_type countEntries(size_type limit) const {
+            size_type sum = this->numElements;
+            if (this->isLeaf()) {
+                return sum;
+            }
+            for (unsigned i = 0; i <= this->numElements && sum <= limit; ++i) {
+                sum += getChild(i)->countEntries(limit - sum);
+            }
+            return sum;
+        }
+
         /**
          * Determines the amount of memory used by the sub-tree rooted
          * by this node.
@@ -1240,7 +1255,10 @@ protected:
 public:
     enum {
         // the maximum number of keys stored per node
-        max_keys_per_node = node::maxKeys
+        max_keys_per_node = node::maxKeys,
+
+        // the size ratio of trees beyond which insertSorted inserts elements instead of merging
+        bulk_merge_ratio = 8
     };
 
     // -- ctors / dtors --
@@ -1293,6 +1311,12 @@ public:
         return (root) ? root->countEntries() : 0;
     }
 
+    // determines whether this tree contains more than n elements, in time proportional to n
+    // rather than to the size of the tree
+    bool hasMoreThan(size_type n) const {
+        return root != nullptr && root->countEntries(n) > n;
+    }
+
     /**
      * Inserts the given key into this tree.
      */
@@ -1685,19 +1709,83 @@ public:
         }
     }
 
+    /**
+     * Inserts the given range of elements, which has to be sorted with respect
+     * to the order of this tree. Unless the range is small compared to this tree,
+     * the range is merged with the elements of this tree and the tree is rebuilt
+     * bottom-up from densely packed nodes. Otherwise, the elements are inserted
+     * one by one, which benefits from the operation hints due to the ordering.
+     *
+     * Unlike insert, this operation must not run concurrently with any other
+     * operation on this tree.
+     */
+    template <typename Iter>
+    void insertSorted(const Iter& a, const Iter& b) {
+        const size_type count = std::distance(a, b);
+        if (count == 0) {
+            return;
+        }
+
+        // trees updating elements on insertion have to use the regular insertion
+        if (!std::is_same<Comparator, WeakComparator>::value || hasMoreThan(count * bulk_merge_ratio)) {
+            insert(a, b);
+            return;
+        }
+
+        // merge the two ordered sequences, dropping duplicates in sets
+        std::vector<Key> merged;
+        merged.reserve(size() + count);
+        auto append = [&](const Key& k) {
+            if (!isSet || merged.empty() || !equal(merged.back(), k)) {
+                merged.push_back(k);
+            }
+        };
+        auto cur = begin();
+        auto stop = end();
+        Iter next = a;
+        while (cur != stop && next != b) {
+            if (less(*next, *cur)) {
+                append(*next);
+                ++next;
+            } else {
+                append(*cur);
+                ++cur;
+            }
+        }
+        for (; cur != stop; ++cur) {
+            append(*cur);
+        }
+        for (; next != b; ++next) {
+            append(*next);
+        }
+
+        // rebuild this tree
+        clear();
+        root = buildTree(merged.begin(), merged.size());
+        leftmost = getLeftmost(root);
+    }
+
     /**
      * Inserts all elements of the given b-tree into this tree.
      * This can be a more effective alternative to the ordered insertion
-     * of elements utilizing iterators.
+     * of elements utilizing iterators. The other tree has to be ordered
+     * like this tree.
      */
     void insertAll(const btree& other) {
         // shortcut for non-sense operation
-        if (this == &other) {
+        if (this == &other || other.empty()) {
+            return;
+        }
+
+        // merge the ordered sequences of comparably sized trees
+        const size_type count = other.size();
+        if (std::is_same<Comparator, WeakComparator>::value && !hasMoreThan(count * bulk_merge_ratio)) {
+            insertSorted(other.begin(), other.end());
             return;
         }
 
         // make sure bigger tree is inserted in smaller tree
-        if ((size() + 10000) < other.size()) {
+        if (count > 10000 && !hasMoreThan(count - 10001)) {
             // switch sides
             btree tmp = other;
             tmp.insertAll(*this);
@@ -2102,17 +2190,11 @@ public:
             return R();
         }
 
-        // resolve tree recursively
-        auto root = buildSubTree(a, b - 1);
-
-        // find leftmost node
-        node* leftmost = root;
-        while (!leftmost->isLeaf()) {
-            leftmost = leftmost->getChild(0);
-        }
+        // build tree bottom-up
+        auto root = buildTree(a, b - a);
 
         // build result
-        return R(b - a, root, static_cast<leaf_node*>(leftmost));
+        return R(b - a, root, getLeftmost(root));
     }
 
 protected:
@@ -2154,62 +2236,79 @@ private:
         return !node->isEmpty() && !less(k, node->keys[0]) && less(k, node->keys[node->numElements - 1]);
     }
 
-    // Utility function for the load operation above.
+    /**
+     * Builds a tree bottom-up from the given number of ordered elements and
+     * returns its root, or nullptr if there are no elements. Leaves are
+     * filled first, and every element between two leaves becomes a key of
+     * the level above. All nodes of a level hold the same number of keys
+     * up to one, such that leaves and inner nodes are densely packed.
+     */
     template <typename Iter>
-    static node* buildSubTree(const Iter& a, const Iter& b) {
-        const int N = node::maxKeys;
-
-        // divide range in N+1 sub-ranges
-        int length = (b - a) + 1;
-
-        // terminal case: length is less then maxKeys
-        if (length <= N) {
-            // create a leaf node
-            node* res = new leaf_node();
-            res->numElements = length;
-
-            for (int i = 0; i < length; ++i) {
-                res->keys[i] = a[i];
+    static node* buildTree(Iter cur, size_type count) {
+        const size_type N = node::maxKeys;
+        if (count == 0) {
+            return nullptr;
+        }
+
+        // create the leaves and collect the keys separating them
+        std::vector<node*> nodes;
+        std::vector<Key> separators;
+        const size_type numLeaves = (count + N + 1) / (N + 1);
+        const size_type numLeafKeys = count - (numLeaves - 1);
+        for (size_type i = 0; i < numLeaves; ++i) {
+            node* leaf = new leaf_node();
+            leaf->numElements = numLeafKeys / numLeaves + ((i < numLeafKeys % numLeaves) ? 1 : 0);
+            for (size_type j = 0; j < leaf->numElements; ++j, ++cur) {
+                leaf->keys[j] = *cur;
+            }
+            nodes.push_back(leaf);
+            if (i + 1 < numLeaves) {
+                separators.push_back(*cur);
+                ++cur;
             }
-
-            return res;
         }
 
-        // recursive case - compute step size
-        int numKeys = N;
-        int step = ((length - numKeys) / (numKeys + 1));
-
-        while (numKeys > 1 && (step < N / 2)) {
-            numKeys--;
-            step = ((length - numKeys) / (numKeys + 1));
+        // create the inner levels, grouping up to N+1 nodes per parent
+        while (nodes.size() > 1) {
+            std::vector<node*> parents;
+            std::vector<Key> parentSeparators;
+            const size_type numParents = (nodes.size() + N) / (N + 1);
+            size_type child = 0;
+            for (size_type i = 0; i < numParents; ++i) {
+                const size_type numChildren =
+                        nodes.size() / numParents + ((i < nodes.size() % numParents) ? 1 : 0);
+                inner_node* parent = new inner_node();
+                parent->numElements = numChildren - 1;
+                for (size_type j = 0; j < numChildren; ++j, ++child) {
+                    node* n = nodes[child];
+                    n->parent = parent;
+                    n->position = j;
+                    parent->children[j] = n;
+                    if (j + 1 < numChildren) {
+                        parent->keys[j] = separators[child];
+                    }
+                }
+                parents.push_back(parent);
+                if (i + 1 < numParents) {
+                    parentSeparators.push_back(separators[child - 1]);
+                }
+            }
+            nodes.swap(parents);
+            separators.swap(parentSeparators);
         }
 
-        // create inner node
-        node* res = new inner_node();
-        res->numElements = numKeys;
-
-        Iter c = a;
-        for (int i = 0; i < numKeys; i++) {
-            // get dividing key
-            res->keys[i] = c[step];
-
-            // get sub-tree
-            auto child = buildSubTree(c, c + (step - 1));
-            child->parent = res;
-            child->position = i;
-            res->getChildren()[i] = child;
+        return nodes.front();
+    }
 
-            c = c + (step + 1);
+    // Obtains the left-most leaf of the tree with the given root.
+    static leaf_node* getLeftmost(node* root) {
+        if (root == nullptr) {
+            return nullptr;
         }
-
-        // and the remaining part
-        auto child = buildSubTree(c, b);
-        child->parent = res;
-        child->position = numKeys;
-        res->getChildren()[numKeys] = child;
-
-        // done
-        return res;
+        while (!root->isLeaf()) {
+            root = root->getChild(0);
+        }
+        return static_cast<leaf_node*>(root);
     }
 };  // namespace souffle
 
@@ -0,0 +1,78 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2019, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file BinaryFormat.h
+ *
+ * Layout of the binary columnar relation files read and written by IO=binary
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "RamTypes.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace souffle {
+
+/**
+ * The header of a binary relation file.
+ *
+ * A binary relation file consists of
+ *  - the header,
+ *  - one byte per column, 's' for symbol and 'i' for number columns,
+ *  - the symbol dictionary, each symbol as its uint32_t length followed by its characters,
+ *  - the columns, each holding one RamDomain per tuple.
+ *
+ * Symbol columns hold indices into the dictionary rather than symbol table indices,
+ * such that files may be exchanged between programs. The column types and the dictionary
+ * are padded to a multiple of BINARY_ALIGNMENT bytes, such that the columns of a mapped
+ * file can be accessed in place. Values are stored in the byte order of the writer. The
+ * whole file may be gzip-compressed.
+ */
+struct BinaryFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t domainSize;
+    uint64_t arity;
+    uint64_t numTuples;
+    uint64_t numSymbols;
+    uint64_t dictionarySize;
+
+    static constexpr const char* MAGIC = "SOUFFLEB";
+    static constexpr uint32_t VERSION = 1;
+
+    /** Create a header for a file of the current format */
+    static BinaryFileHeader create(uint64_t arity) {
+        BinaryFileHeader header{};
+        std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+        header.version = VERSION;
+        header.domainSize = sizeof(RamDomain);
+        header.arity = arity;
+        return header;
+    }
+
+    /** Whether this header describes a file of the current format */
+    bool isValid() const {
+        return std::memcmp(magic, MAGIC, sizeof(magic)) == 0 && version == VERSION &&
+               domainSize == sizeof(RamDomain);
+    }
+};
+
+/** Alignment of the sections of a binary relation file in bytes */
+constexpr size_t BINARY_ALIGNMENT = 8;
+
+/** The number of bytes padding the given size to a multiple of BINARY_ALIGNMENT */
+inline size_t binaryPadding(size_t size) {
+    return (BINARY_ALIGNMENT - size % BINARY_ALIGNMENT) % BINARY_ALIGNMENT;
+}
+
+}  // end of namespace souffle
@@ -23,6 +23,7 @@
 #include "EquivalenceRelation.h"
 #include "IterUtils.h"
 #include "RamTypes.h"
+#include "SimdSearch.h"
 #include "Util.h"
 #include <cassert>
 #include <iterator>
@@ -0,0 +1,70 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2019, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file CompiledInstances.h
+ *
+ * The instantiations of the relation templates shared by most synthesized
+ * programs, compiled ahead of time by souffle-compile.
+ *
+ * souffle-compile compiles a translation unit defining __SOUFFLE_PRECOMPILING__
+ * once per set of compiler flags into its cache, which instantiates the indexes
+ * listed below and the profile event processors. Programs compiled with
+ * __SOUFFLE_PRECOMPILED__ are linked against this object and merely declare
+ * the instantiations, such that none of their translation units compiles them.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/BTree.h"
+#include "souffle/CompiledIndexUtils.h"
+#include "souffle/CompiledTuple.h"
+#include "souffle/RamTypes.h"
+
+#include <memory>
+
+#if defined(__SOUFFLE_PRECOMPILED__) || defined(__SOUFFLE_PRECOMPILING__)
+
+#ifdef __SOUFFLE_PRECOMPILING__
+#define SOUFFLE_INSTANCE(...) template class __VA_ARGS__;
+#else
+#define SOUFFLE_INSTANCE(...) extern template class __VA_ARGS__;
+#endif
+
+// a full index of the given arity and lexicographical order, as synthesized for relations
+#define SOUFFLE_INDEX(ARITY, ...)                                                                         \
+    SOUFFLE_INSTANCE(detail::btree<ram::Tuple<RamDomain, ARITY>,                                          \
+            ram::index_utils::comparator<__VA_ARGS__>, std::allocator<ram::Tuple<RamDomain, ARITY>>, 256, \
+            detail::default_strategy<ram::Tuple<RamDomain, ARITY>>::type, true>)                          \
+    SOUFFLE_INSTANCE(btree_set<ram::Tuple<RamDomain, ARITY>, ram::index_utils::comparator<__VA_ARGS__>>)
+
+namespace souffle {
+
+// the natural order of each arity, used by the master index of most relations
+SOUFFLE_INDEX(1, 0)
+SOUFFLE_INDEX(2, 0, 1)
+SOUFFLE_INDEX(3, 0, 1, 2)
+SOUFFLE_INDEX(4, 0, 1, 2, 3)
+SOUFFLE_INDEX(5, 0, 1, 2, 3, 4)
+SOUFFLE_INDEX(6, 0, 1, 2, 3, 4, 5)
+
+// the reverse order of binary relations, e.g. of edges searched by their target
+SOUFFLE_INDEX(2, 1, 0)
+
+// the orders of ternary relations searched by their second or third element
+SOUFFLE_INDEX(3, 1, 0, 2)
+SOUFFLE_INDEX(3, 2, 0, 1)
+
+}  // end of namespace souffle
+
+#undef SOUFFLE_INDEX
+#undef SOUFFLE_INSTANCE
+
+#endif
@@ -17,13 +17,9 @@
 #pragma once
 
 #include "CompiledTuple.h"
-#include "ParallelUtils.h"
-#include "Util.h"
+#include "RecordTable.h"
 
-#include <limits>
-#include <memory>
-#include <unordered_map>
-#include <vector>
+#include <cstddef>
 
 namespace souffle {
 
@@ -77,76 +73,41 @@ namespace detail {
  */
 template <typename Tuple>
 class RecordMap {
-    // create blocks of a million entries
-    static const std::size_t BLOCK_SIZE = 1 << 20;
-
     /** The definition of the tuple type handled by this instance */
     using tuple_type = Tuple;
 
-    /** The definition of the type of a tuple block */
-    using block_type = std::array<tuple_type, BLOCK_SIZE>;
-
-    /** The type utilized for the block index */
-    using block_index_type = std::vector<std::unique_ptr<block_type>>;
-
-    /** The mapping from tuples to references/indices */
-    std::unordered_map<tuple_type, RamDomain> r2i;
-
-    /** The mapping from indices to tuples */
-    block_index_type i2r;
-
-    /** a lock for the pack operation */
-    Lock pack_lock;
+    /** The underlying mapping between the values of tuples and references */
+    ConcurrentRecordMap map;
 
 public:
-    RecordMap() = default;
+    RecordMap() : map(tuple_type::arity) {}
 
     /**
      * Packs the given tuple -- and may create a new reference if necessary.
      */
     RamDomain pack(const tuple_type& tuple) {
-        RamDomain index;
-
-        {
-            // lock pack operation
-            auto leas = pack_lock.acquire();  // lock hold till end of scope
-            (void)leas;                       // avoid warning
-
-            // try lookup
-            auto pos = r2i.find(tuple);
-            if (pos != r2i.end()) {
-                // take the previously assigned value
-                index = pos->second;
-            } else {
-                // add tuple to index
-                index = r2i.size() + 1;  // since 0 is skipped for the Nil element
-                r2i[tuple] = index;
-
-                // assert that new index is smaller than the range
-                assert(index != std::numeric_limits<RamDomain>::max());
-
-                if (index / BLOCK_SIZE == i2r.size()) {
-                    i2r.push_back(std::make_unique<block_type>());
-                }
-
-                // create entry for unpacking
-                auto& list = i2r[index / BLOCK_SIZE];
-
-                // insert tuple
-                (*list)[index % BLOCK_SIZE] = tuple;
-            }
-        }
-
-        // done
-        return index;
+        return map.pack(&tuple[0]);
     }
 
     /**
      * Obtains a pointer to the tuple addressed by the given index.
      */
     const tuple_type& unpack(RamDomain index) {
-        // just look up the right spot
-        return (*(i2r[index / BLOCK_SIZE]))[index % BLOCK_SIZE];
+        return *reinterpret_cast<const tuple_type*>(map.unpack(index));
+    }
+
+    /**
+     * Obtains the number of records stored in this map.
+     */
+    std::size_t size() const {
+        return map.size();
+    }
+
+    /**
+     * Obtains the number of pack operations, including those hitting an existing record.
+     */
+    std::size_t getPackCount() {
+        return map.getPackCount();
     }
 };
 
@@ -163,6 +124,12 @@ public:
         static ram::Tuple<RamDomain, 0> empty;
         return empty;
     }
+    std::size_t size() const {
+        return 1;
+    }
+    std::size_t getPackCount() {
+        return 0;
+    }
 };
 
 /**
@@ -18,6 +18,7 @@
 
 #include "souffle/Brie.h"
 #include "souffle/CompiledIndexUtils.h"
+#include "souffle/CompiledInstances.h"
 #include "souffle/CompiledOptions.h"
 #include "souffle/CompiledRecord.h"
 #include "souffle/CompiledRelation.h"
@@ -31,12 +32,14 @@
 #include "souffle/SignalHandler.h"
 #include "souffle/SouffleInterface.h"
 #include "souffle/SymbolTable.h"
+#include "souffle/TupleArena.h"
 #include "souffle/Util.h"
 #include "souffle/WriteStream.h"
 #ifdef USE_MPI
 #include "souffle/Mpi.h"
 #endif
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cassert>
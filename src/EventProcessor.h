@@ -176,6 +176,9 @@ private:
     }
 };
 
+// programs linked against the precompiled instances of CompiledInstances.h share their processors
+#if !defined(__SOUFFLE_PRECOMPILED__) || defined(__SOUFFLE_PRECOMPILING__)
+
 /**
  * Non-Recursive Rule Timing Profile Event Processor
  */
@@ -286,6 +289,26 @@ public:
     }
 } recursiveRuleNumberProcessor;
 
+/**
+ * Recursive Rule Variant Profile Event Processor
+ */
+const class RecursiveRuleVariantProcessor : public EventProcessor {
+public:
+    RecursiveRuleVariantProcessor() {
+        EventProcessorSingleton::instance().registerEventProcessor("@v-recursive-rule", this);
+    }
+    void process(ProfileDatabase& db, const std::vector<std::string>& signature, va_list& args) override {
+        const std::string& relation = signature[1];
+        const std::string& version = signature[2];
+        const std::string& rule = signature[4];
+        size_t variant = va_arg(args, size_t);
+        std::string iteration = std::to_string(va_arg(args, size_t));
+        db.addSizeEntry({"program", "relation", relation, "iteration", iteration, "recursive-rule", rule,
+                                version, "variant"},
+                variant);
+    }
+} recursiveRuleVariantProcessor;
+
 /**
  * Non-Recursive Relation Number Profile Event Processor
  */
@@ -535,6 +558,46 @@ public:
 
 } relationReadsProcessor;
 
+/**
+ * Relation Statistics Processor
+ */
+const class RelationStatisticsProcessor : public EventProcessor {
+public:
+    RelationStatisticsProcessor() {
+        EventProcessorSingleton::instance().registerEventProcessor("@relation-statistics", this);
+    }
+    /** process event input */
+    void process(ProfileDatabase& db, const std::vector<std::string>& signature, va_list& args) override {
+        const std::string& relation = signature[1];
+        const std::string& column = signature[2];
+        size_t number = va_arg(args, size_t);
+        if (signature.size() > 3) {
+            db.addSizeEntry({"program", "relation", relation, "statistics", column, signature[3]}, number);
+        } else {
+            db.addSizeEntry({"program", "relation", relation, "statistics", column}, number);
+        }
+    }
+
+} relationStatisticsProcessor;
+
+/**
+ * Record Map Processor
+ */
+const class RecordsProcessor : public EventProcessor {
+public:
+    RecordsProcessor() {
+        EventProcessorSingleton::instance().registerEventProcessor("@records", this);
+    }
+    /** process event input */
+    void process(ProfileDatabase& db, const std::vector<std::string>& signature, va_list& args) override {
+        const std::string& arity = signature[1];
+        const std::string& key = signature[2];
+        size_t number = va_arg(args, size_t);
+        db.addSizeEntry({"program", "records", arity, key}, number);
+    }
+
+} recordsProcessor;
+
 /**
  * Config entry processor
  */
@@ -566,5 +629,7 @@ public:
     }
 } textProcessor;
 
+#endif
+
 }  // namespace profile
 }  // namespace souffle
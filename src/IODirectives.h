@@ -55,6 +55,15 @@ public:
         return directives.count(key) > 0;
     }
 
+    /** Whether the IO type reads or writes the file given by the filename directive */
+    bool hasFileIOType() const {
+        if (!has("IO")) {
+            return false;
+        }
+        const std::string& type = getIOType();
+        return type == "file" || type == "mmap" || type == "binary";
+    }
+
     const std::string& getFileName() const {
         return get("filename");
     }
@@ -0,0 +1,193 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2019, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file JitCompiler.cpp
+ *
+ * Implementation of the just-in-time compiler of strata
+ *
+ ***********************************************************************/
+
+#include "JitCompiler.h"
+#include "Global.h"
+#include "RamExpression.h"
+#include "RamOperation.h"
+#include "RamProgram.h"
+#include "RamTranslationUnit.h"
+#include "RamVisitor.h"
+#include "SymbolTable.h"
+#include "Synthesiser.h"
+
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <dlfcn.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace souffle {
+
+JitCompiler::JitCompiler(RamTranslationUnit& tUnit, const std::string& compileCmd, long threshold)
+        : id(identifier(simpleName(Global::config().get("")))), compileCmd(compileCmd), threshold(threshold) {
+    const RamStatement& main = *tUnit.getProgram()->getMain();
+
+    // collect the relations of each stratum, and whether its state is shared with the compiled program
+    visitDepthFirst(main, [&](const RamStratum& stratum) {
+        StratumRelations& rels = relations[stratum.getIndex()];
+        visitDepthFirst(stratum, [&](const RamCreate& create) { rels.created.push_back(&create.getRelation()); });
+        visitDepthFirst(stratum, [&](const RamDrop& drop) { rels.dropped.push_back(&drop.getRelation()); });
+        visitDepthFirst(
+                stratum, [&](const RamRelationReference& ref) { rels.used.insert(ref.get()->getName()); });
+
+        bool isShared = true;
+        visitDepthFirst(stratum, [&](const RamPackRecord&) { isShared = false; });
+        visitDepthFirst(stratum, [&](const RamUnpackRecord&) { isShared = false; });
+        visitDepthFirst(stratum, [&](const RamAutoIncrement&) { isShared = false; });
+        visitDepthFirst(stratum, [&](const RamUserDefinedOperator&) { isShared = false; });
+        eligible[stratum.getIndex()] = isShared;
+    });
+
+    // synthesize the program while its symbol table holds the constants only
+    directory = tempDir();
+    const std::string baseFilename = directory + "/" + id;
+    const std::string headerFilename = baseFilename + ".h";
+    sourceFilenames.push_back(baseFilename + ".cpp");
+    libraryFilename = baseFilename + ".so";
+
+    std::ofstream hdr(headerFilename);
+    std::ofstream os(sourceFilenames.front());
+    std::map<std::string, std::string> units;
+    bool withSharedLibrary;
+    Synthesiser(tUnit).generateCode(hdr, os, units, baseName(headerFilename), id, withSharedLibrary);
+    for (const auto& unit : units) {
+        sourceFilenames.push_back(baseFilename + "_" + unit.first + ".cpp");
+        std::ofstream(sourceFilenames.back()) << unit.second;
+    }
+
+    generatedFilenames = sourceFilenames;
+    generatedFilenames.push_back(headerFilename);
+    generatedFilenames.push_back(libraryFilename);
+}
+
+JitCompiler::~JitCompiler() {
+    // abandon an ongoing compilation
+    if (compiler.joinable()) {
+        // the compiler re-checks the flag once the process group exists, such that one of both kills it
+        abandoned.store(true);
+        pid_t pid = process.load();
+        if (pid > 0) {
+            kill(-pid, SIGTERM);
+        }
+        compiler.join();
+    }
+
+    // the program is destroyed by the library that created it
+    program.reset();
+    if (library != nullptr) {
+        dlclose(library);
+    }
+
+    for (const std::string& filename : generatedFilenames) {
+        remove(filename.c_str());
+    }
+    remove(directory.c_str());
+}
+
+void JitCompiler::enter(const RamStratum& /*stratum*/) {
+    start = now();
+}
+
+void JitCompiler::checkpoint(const RamStratum& stratum) {
+    if (compiler.joinable() || duration_in_us(start, now()) < threshold * 1000) {
+        return;
+    }
+    if (Global::config().has("verbose")) {
+        std::cout << "Stratum " << stratum.getIndex() << " is hot, compiling the program" << std::endl;
+    }
+    compiler = std::thread([this]() { compile(); });
+}
+
+void JitCompiler::leave(const RamStratum& stratum) {
+    checkpoint(stratum);
+    if (!loaded.load(std::memory_order_acquire)) {
+        return;
+    }
+    for (const RamRelation* rel : getRelations(stratum).dropped) {
+        if (isResident(rel->getName())) {
+            program->getRelation(rel->getName())->purge();
+            setResident(rel->getName(), false);
+        }
+    }
+}
+
+void JitCompiler::syncSymbols(const SymbolTable& source, SymbolTable& target) {
+    const size_t size = source.size();
+    std::vector<std::string> symbols;
+    for (size_t i = target.size(); i < size; ++i) {
+        symbols.push_back(source.resolve(i));
+    }
+    target.insert(symbols);
+    assert(target.size() == size && "symbol tables diverged");
+}
+
+void JitCompiler::compile() {
+    auto compileStart = now();
+
+    // compile in a process group of its own, such that an ongoing compilation can be abandoned
+    const std::string cmd = compileCmd + " -s " + toString(join(sourceFilenames, " "));
+    pid_t pid = fork();
+    if (pid == 0) {
+        setpgid(0, 0);
+        execl("/bin/sh", "sh", "-c", cmd.c_str(), nullptr);
+        _exit(127);
+    }
+    if (pid < 0) {
+        std::cerr << "Warning: failed to start the compilation of strata\n";
+        return;
+    }
+    setpgid(pid, pid);
+    process.store(pid);
+    if (abandoned.load()) {
+        kill(-pid, SIGTERM);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    process.store(0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        if (!WIFSIGNALED(status)) {
+            std::cerr << "Warning: failed to compile strata, continuing interpretation\n";
+        }
+        return;
+    }
+
+    // functors are resolved lazily, as only strata without user-defined functors are evaluated
+    library = dlopen(libraryFilename.c_str(), RTLD_LAZY | RTLD_LOCAL);
+    if (library == nullptr) {
+        std::cerr << "Warning: failed to load compiled strata: " << dlerror() << "\n";
+        return;
+    }
+    using Factory = SouffleProgram* (*)();
+    auto factory = reinterpret_cast<Factory>(dlsym(library, ("souffle_newInstance_" + id).c_str()));
+    if (factory == nullptr) {
+        std::cerr << "Warning: failed to load compiled strata: " << dlerror() << "\n";
+        return;
+    }
+    program.reset(factory());
+
+    if (Global::config().has("verbose")) {
+        std::cout << "JIT Compilation Time: " << duration_in_us(compileStart, now()) / 1000000.0 << "sec"
+                  << std::endl;
+    }
+    loaded.store(true, std::memory_order_release);
+}
+
+}  // end of namespace souffle
@@ -0,0 +1,184 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2019, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file JitCompiler.h
+ *
+ * Compiles a RAM program at runtime, such that an interpreter may swap
+ * in the compiled code of strata once they turn out to be hot.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "RamRelation.h"
+#include "RamStatement.h"
+#include "SouffleInterface.h"
+#include "Util.h"
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/types.h>
+
+namespace souffle {
+
+class RamTranslationUnit;
+class SymbolTable;
+
+/**
+ * A just-in-time compiler of the strata of a RAM program, enabling tiered execution.
+ *
+ * The program is synthesized upon construction, before its evaluation extends the symbol
+ * table, as a set of translation units as for --split-strata. Once the interpreter has
+ * evaluated a stratum for longer than the threshold, the program is compiled to a shared
+ * library in the background by souffle-compile, whose object cache reduces the compilation
+ * of later runs to linking the library.
+ *
+ * Once the library is loaded, the compiled program takes over the evaluation of the hot
+ * stratum at the next iteration of its fixpoint loop, and of all following strata at their
+ * beginning. The interpreter transfers the relations used by a stratum to the compiled
+ * program and the relations computed by it back, keeping both symbol tables identical.
+ *
+ * Strata packing or unpacking records, using the counter or user-defined functors remain
+ * interpreted, as their state is not shared with the compiled program.
+ */
+class JitCompiler {
+public:
+    /** The relations of a stratum */
+    struct StratumRelations {
+        /** The relations created by the stratum */
+        std::vector<const RamRelation*> created;
+
+        /** The relations dropped by the stratum */
+        std::vector<const RamRelation*> dropped;
+
+        /** The names of all relations referenced by the stratum */
+        std::set<std::string> used;
+    };
+
+    /**
+     * Synthesizes the program of the given translation unit.
+     *
+     * @param compileCmd ... the path of souffle-compile
+     * @param threshold ... the time in milliseconds after which a stratum is hot
+     */
+    JitCompiler(RamTranslationUnit& tUnit, const std::string& compileCmd, long threshold);
+
+    /** Stops an ongoing compilation, unloads the library and removes the generated files */
+    ~JitCompiler();
+
+    /** Notifies the compiler of the start of the evaluation of a stratum */
+    void enter(const RamStratum& stratum);
+
+    /** Notifies the compiler of a boundary of an iteration of the current stratum */
+    void checkpoint(const RamStratum& stratum);
+
+    /**
+     * Notifies the compiler of the end of the interpretation of a stratum, discarding the
+     * copies of the relations dropped by the stratum held by the compiled program.
+     */
+    void leave(const RamStratum& stratum);
+
+    /** Checks whether the compiled program is available to evaluate the given stratum */
+    bool isCompiled(const RamStratum& stratum) const {
+        return loaded.load(std::memory_order_acquire) && eligible.at(stratum.getIndex());
+    }
+
+    /** Obtains the compiled program; it must be available */
+    SouffleProgram& getProgram() {
+        return *program;
+    }
+
+    /** Obtains the relations of a stratum */
+    const StratumRelations& getRelations(const RamStratum& stratum) const {
+        return relations.at(stratum.getIndex());
+    }
+
+    /** Checks whether the compiled program holds the contents of a relation of the interpreter */
+    bool isResident(const std::string& relation) const {
+        return resident.count(relation) > 0;
+    }
+
+    /** Marks whether the compiled program holds the contents of a relation of the interpreter */
+    void setResident(const std::string& relation, bool value) {
+        if (value) {
+            resident.insert(relation);
+        } else {
+            resident.erase(relation);
+        }
+    }
+
+    /**
+     * Appends the symbols missing in the target table, whose symbols are required to be
+     * a prefix of those of the source table, such that both tables become identical.
+     */
+    static void syncSymbols(const SymbolTable& source, SymbolTable& target);
+
+private:
+    /** Compiles and loads the library, executed by the background thread */
+    void compile();
+
+    /** The identifier of the synthesized program */
+    std::string id;
+
+    /** The command compiling the library */
+    std::string compileCmd;
+
+    /** The time in milliseconds after which a stratum is hot */
+    long threshold;
+
+    /** The directory of the generated files */
+    std::string directory;
+
+    /** The generated files, including the library */
+    std::vector<std::string> generatedFilenames;
+
+    /** The translation units to be compiled */
+    std::vector<std::string> sourceFilenames;
+
+    /** The compiled library */
+    std::string libraryFilename;
+
+    /** The relations of each stratum */
+    std::map<int, StratumRelations> relations;
+
+    /** Whether the compiled program may evaluate each stratum */
+    std::map<int, bool> eligible;
+
+    /** The relations of the interpreter whose contents are held by the compiled program */
+    std::set<std::string> resident;
+
+    /** The start of the evaluation of the current stratum */
+    time_point start;
+
+    /** The background thread compiling the library, started once a stratum is hot */
+    std::thread compiler;
+
+    /** The process group of souffle-compile while it is running */
+    std::atomic<pid_t> process{0};
+
+    /** Whether the interpreter has abandoned the compilation */
+    std::atomic<bool> abandoned{false};
+
+    /** Whether the library has been loaded and the program instantiated */
+    std::atomic<bool> loaded{false};
+
+    /** The handle of the library */
+    void* library = nullptr;
+
+    /** The compiled program */
+    std::unique_ptr<SouffleProgram> program;
+};
+
+}  // end of namespace souffle
@@ -33,12 +33,14 @@
 #include "RamOperation.h"
 #include "RamProgram.h"
 #include "RamVisitor.h"
+#include "RelationStats.h"
 #include "ReadStream.h"
 #include "SignalHandler.h"
 #include "SymbolTable.h"
 #include "Util.h"
 #include "WriteStream.h"
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
@@ -54,15 +56,71 @@
 #include <utility>
 #include <ffi.h>
 
+/*
+ * With compilers supporting computed gotos, every instruction handler jumps directly
+ * to the handler of the next instruction through a table of label addresses (threaded
+ * dispatch) instead of returning to the switch. Define LVM_SWITCH_DISPATCH to use the
+ * portable switch-based loop only.
+ *
+ * A computed goto out of a handler would neither run the destructors of its locals nor
+ * release its variable-length arrays. Handlers hence leave their scope by a plain goto to
+ * the computed goto, which the compiler duplicates into the handlers.
+ */
+#if defined(__GNUC__) && !defined(LVM_SWITCH_DISPATCH)
+#define LVM_THREADED_DISPATCH
+#define LVM_LABEL(op) LVM_LABEL_##op
+#define LVM_CASE(op) \
+    case op:         \
+        LVM_LABEL(op) :
+#define LVM_DISPATCH() goto LVM_LABEL(LVM_Dispatch)
+#else
+#define LVM_CASE(op) case op:
+#define LVM_DISPATCH() break
+#endif
+
 namespace souffle {
 
+namespace {
+
+/** Evaluate a numeric comparison fused into a superinstruction */
+inline bool compare(RamDomain op, RamDomain lhs, RamDomain rhs) {
+    switch (op) {
+        case LVM_OP_EQ:
+            return lhs == rhs;
+        case LVM_OP_NE:
+            return lhs != rhs;
+        case LVM_OP_LT:
+            return lhs < rhs;
+        case LVM_OP_LE:
+            return lhs <= rhs;
+        case LVM_OP_GT:
+            return lhs > rhs;
+        case LVM_OP_GE:
+            return lhs >= rhs;
+        default:
+            assert(false && "unsupported comparison");
+            return false;
+    }
+}
+
+}  // namespace
+
 void LVM::executeMain() {
     const RamStatement& main = *translationUnit.getProgram()->getMain();
     if (mainProgram.get() == nullptr) {
-        LVMGenerator generator(translationUnit.getSymbolTable(), main, relationEncoder);
+        LVMGenerator generator(translationUnit.getSymbolTable(), main, relationEncoder, useRegisters);
         mainProgram = generator.getCodeStream();
     }
     LVMContext ctxt;
+#ifdef _OPENMP
+    // use the requested number of threads for parallel operations
+    if (Global::config().has("jobs") && isNumber(Global::config().get("jobs").c_str())) {
+        int jobs = std::stoi(Global::config().get("jobs"));
+        if (jobs > 0) {
+            omp_set_num_threads(jobs);
+        }
+    }
+#endif
     SignalHandler::instance()->set();
     if (Global::config().has("verbose")) {
         SignalHandler::instance()->enableLogging();
@@ -98,6 +156,10 @@ void LVM::executeMain() {
         // Store count of rules
         size_t ruleCount = 0;
         visitDepthFirst(main, [&](const RamQuery& rule) { ++ruleCount; });
+        visitDepthFirst(main, [&](const RamAdaptiveQuery& adaptive) {
+            // only one variant of an adaptive query is executed at a time
+            ruleCount -= adaptive.getStatements().size() - 1;
+        });
         ProfileEventSingleton::instance().makeConfigRecord("ruleCount", std::to_string(ruleCount));
 
         execute(mainProgram, ctxt);
@@ -115,58 +177,233 @@ void LVM::executeMain() {
     SignalHandler::instance()->reset();
 }
 
+void LVM::executeParallel(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t iter,
+        std::vector<Stream> partitions, size_t ip) {
+    std::vector<LVMInsertBuffer> buffers(partitions.size());
+
+#pragma omp parallel for schedule(dynamic)
+    for (size_t i = 0; i < partitions.size(); ++i) {
+        LVMContext partCtxt;
+        partCtxt.setReturnValues(ctxt.getReturnValues());
+        partCtxt.setReturnErrors(ctxt.getReturnErrors());
+        partCtxt.setArguments(ctxt.getArguments());
+        partCtxt.setInsertBuffer(buffers[i]);
+        partCtxt.getStream(iter) = std::move(partitions[i]);
+        execute(codeStream, partCtxt, ip);
+    }
+
+    // merge buffered tuples into target relations
+    for (auto& partBuffer : buffers) {
+        for (auto& cur : partBuffer) {
+            LVMRelation& rel = *getRelation(cur.first);
+            const auto arity = rel.getArity();
+            const RamDomain* data = cur.second.second.data();
+            for (size_t j = 0; j < cur.second.first; ++j) {
+                rel.insert(TupleRef(data + j * arity, arity));
+            }
+        }
+    }
+}
+
 void LVM::execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t ip) {
     std::stack<RamDomain> stack;
     const LVMCode& code = *codeStream;
     auto& symbolTable = codeStream->getSymbolTable();
+    // registers of register-based expressions
+    std::unique_ptr<RamDomain[]> registers(new RamDomain[code.getNumOfRegisters()]);
+    RamDomain* reg = registers.get();
+#ifdef LVM_THREADED_DISPATCH
+    // addresses of the instruction handlers in the order of LVM_Type; opcodes without a handler are
+    // left to the switch. The table is constant, such that it is initialized once and the compiler
+    // does not clone the function with different label addresses.
+    static void* const dispatchTable[] = {
+            &&LVM_LABEL(LVM_Number),
+            &&LVM_LABEL(LVM_TupleElement),
+            &&LVM_LABEL(LVM_AutoIncrement),
+            &&LVM_LABEL(LVM_OP_ORD),
+            &&LVM_LABEL(LVM_OP_STRLEN),
+            &&LVM_LABEL(LVM_OP_NEG),
+            &&LVM_LABEL(LVM_OP_BNOT),
+            &&LVM_LABEL(LVM_OP_LNOT),
+            &&LVM_LABEL(LVM_OP_TONUMBER),
+            &&LVM_LABEL(LVM_OP_TOSTRING),
+            &&LVM_LABEL(LVM_OP_ADD),
+            &&LVM_LABEL(LVM_OP_SUB),
+            &&LVM_LABEL(LVM_OP_MUL),
+            &&LVM_LABEL(LVM_OP_DIV),
+            &&LVM_LABEL(LVM_OP_EXP),
+            &&LVM_LABEL(LVM_OP_MOD),
+            &&LVM_LABEL(LVM_OP_BAND),
+            &&LVM_LABEL(LVM_OP_BOR),
+            &&LVM_LABEL(LVM_OP_BXOR),
+            &&LVM_LABEL(LVM_OP_LAND),
+            &&LVM_LABEL(LVM_OP_LOR),
+            &&LVM_LABEL(LVM_OP_MAX),
+            &&LVM_LABEL(LVM_OP_MIN),
+            &&LVM_LABEL(LVM_OP_CAT),
+            &&LVM_LABEL(LVM_OP_SUBSTR),
+            &&LVM_LABEL(LVM_OP_EQ),
+            &&LVM_LABEL(LVM_OP_NE),
+            &&LVM_LABEL(LVM_OP_LT),
+            &&LVM_LABEL(LVM_OP_LE),
+            &&LVM_LABEL(LVM_OP_GT),
+            &&LVM_LABEL(LVM_OP_GE),
+            &&LVM_LABEL(LVM_OP_MATCH),
+            &&LVM_LABEL(LVM_OP_NOT_MATCH),
+            &&LVM_LABEL(LVM_OP_CONTAINS),
+            &&LVM_LABEL(LVM_OP_NOT_CONTAINS),
+            &&LVM_LABEL(LVM_CompareTupleElements),
+            &&LVM_LABEL(LVM_CompareTupleElementNumber),
+            &&LVM_LABEL(LVM_UserDefinedOperator),
+            &&LVM_LABEL(LVM_PackRecord),
+            &&LVM_LABEL(LVM_Argument),
+            &&LVM_LABEL(LVM_Aggregate_COUNT),
+            &&LVM_LABEL(LVM_Aggregate_Return),
+            &&LVM_LABEL(LVM_Conjunction),
+            &&LVM_LABEL(LVM_Negation),
+            &&LVM_LABEL(LVM_ContainCheck),
+            &&LVM_LABEL(LVM_EmptinessCheck),
+            &&LVM_LABEL(LVM_ExistenceCheck),
+            &&LVM_LABEL(LVM_ExistenceCheckOneArg),
+            &&LVM_LABEL(LVM_Switch),
+            &&LVM_LABEL(LVM_Constraint),
+            &&LVM_LABEL(LVM_True),
+            &&LVM_LABEL(LVM_False),
+            &&LVM_LABEL(LVM_Scan),
+            &&LVM_LABEL(LVM_IndexScan),
+            &&LVM_LABEL(LVM_Choice),
+            &&LVM_LABEL(LVM_IndexChoice),
+            &&LVM_LABEL(LVM_UnpackRecord),
+            &&LVM_LABEL(LVM_Aggregate),
+            &&LVM_LABEL(LVM_IndexAggregate),
+            &&LVM_LABEL(LVM_Filter),
+            &&LVM_LABEL(LVM_Project),
+            &&LVM_LABEL(LVM_ReturnValue),
+            &&LVM_LABEL(LVM_Search),
+            &&LVM_LABEL(LVM_ParallelScan),
+            &&LVM_LABEL(LVM_ParallelIndexScan),
+            &&LVM_LABEL(LVM_Sequence),
+            &&LVM_LABEL(LVM_Parallel),
+            &&LVM_LABEL(LVM_Stop_Parallel),
+            &&LVM_LABEL(LVM_Loop),
+            &&LVM_LABEL(LVM_IncIterationNumber),
+            &&LVM_LABEL(LVM_ResetIterationNumber),
+            &&LVM_LABEL(LVM_Exit),
+            &&LVM_LABEL(LVM_LogTimer),
+            &&LVM_LABEL(LVM_LogRelationTimer),
+            &&LVM_LABEL(LVM_StopLogTimer),
+            &&LVM_LABEL(LVM_DebugInfo),
+            &&LVM_LABEL(LVM_Stratum),
+            &&LVM_LABEL(LVM_Create),
+            &&LVM_LABEL(LVM_Clear),
+            &&LVM_LABEL(LVM_Drop),
+            &&LVM_LABEL(LVM_LogSize),
+            &&LVM_LABEL(LVM_LogStatistics),
+            &&LVM_LABEL(LVM_Load),
+            &&LVM_LABEL(LVM_Store),
+            &&LVM_LABEL(LVM_Fact),
+            &&LVM_LABEL(LVM_Merge),
+            &&LVM_LABEL(LVM_Swap),
+            &&LVM_LABEL(LVM_Query),
+            &&LVM_LABEL(LVM_AdaptiveQuery),
+            &&LVM_LABEL(LVM_Goto),
+            &&LVM_LABEL(LVM_Jmpnz),
+            &&LVM_LABEL(LVM_Jmpez),
+            &&LVM_LABEL(LVM_STOP),
+            &&LVM_LABEL(LVM_Switch),
+            &&LVM_LABEL(LVM_Switch),
+            &&LVM_LABEL(LVM_Switch),
+            &&LVM_LABEL(LVM_Switch),
+            &&LVM_LABEL(LVM_Switch),
+            &&LVM_LABEL(LVM_ITER_InitFullIndex),
+            &&LVM_LABEL(LVM_ITER_InitRangeIndex),
+            &&LVM_LABEL(LVM_ITER_InitRangeIndexOneArg),
+            &&LVM_LABEL(LVM_ITER_Select),
+            &&LVM_LABEL(LVM_ITER_Inc),
+            &&LVM_LABEL(LVM_ITER_NotAtEnd),
+            &&LVM_LABEL(LVM_REG_Number),
+            &&LVM_LABEL(LVM_REG_TupleElement),
+            &&LVM_LABEL(LVM_REG_Argument),
+            &&LVM_LABEL(LVM_REG_OP_NEG),
+            &&LVM_LABEL(LVM_REG_OP_BNOT),
+            &&LVM_LABEL(LVM_REG_OP_LNOT),
+            &&LVM_LABEL(LVM_REG_OP_ADD),
+            &&LVM_LABEL(LVM_REG_OP_SUB),
+            &&LVM_LABEL(LVM_REG_OP_MUL),
+            &&LVM_LABEL(LVM_REG_OP_DIV),
+            &&LVM_LABEL(LVM_REG_OP_EXP),
+            &&LVM_LABEL(LVM_REG_OP_MOD),
+            &&LVM_LABEL(LVM_REG_OP_BAND),
+            &&LVM_LABEL(LVM_REG_OP_BOR),
+            &&LVM_LABEL(LVM_REG_OP_BXOR),
+            &&LVM_LABEL(LVM_REG_OP_LAND),
+            &&LVM_LABEL(LVM_REG_OP_LOR),
+            &&LVM_LABEL(LVM_REG_OP_MAX),
+            &&LVM_LABEL(LVM_REG_OP_MIN),
+            &&LVM_LABEL(LVM_REG_OP_EQ),
+            &&LVM_LABEL(LVM_REG_OP_NE),
+            &&LVM_LABEL(LVM_REG_OP_LT),
+            &&LVM_LABEL(LVM_REG_OP_LE),
+            &&LVM_LABEL(LVM_REG_OP_GT),
+            &&LVM_LABEL(LVM_REG_OP_GE),
+            &&LVM_LABEL(LVM_REG_Conjunction),
+            &&LVM_LABEL(LVM_REG_Negation),
+            &&LVM_LABEL(LVM_REG_Push),
+    };
+    static_assert(sizeof(dispatchTable) / sizeof(dispatchTable[0]) == LVM_NumOfOpcodes,
+            "every opcode requires an entry in the dispatch table");
+#endif
     while (true) {
+#ifdef LVM_THREADED_DISPATCH
+    LVM_LABEL(LVM_Switch):
+#endif
         switch (code[ip]) {
-            case LVM_Number:
+            LVM_CASE(LVM_Number)
                 stack.push(code[ip + 1]);
                 ip += 2;
-                break;
-            case LVM_TupleElement:
+                LVM_DISPATCH();
+            LVM_CASE(LVM_TupleElement)
                 stack.push(ctxt[code[ip + 1]][code[ip + 2]]);
                 ip += 3;
-                break;
-            case LVM_AutoIncrement:
+                LVM_DISPATCH();
+            LVM_CASE(LVM_AutoIncrement)
                 stack.push(this->counter);
                 incCounter();
                 ip += 1;
-                break;
-            case LVM_OP_ORD:
+                LVM_DISPATCH();
+            LVM_CASE(LVM_OP_ORD)
                 // Does nothing
                 ip += 1;
-                break;
-            case LVM_OP_STRLEN: {
+                LVM_DISPATCH();
+            LVM_CASE(LVM_OP_STRLEN) {
                 RamDomain relNameId = stack.top();
                 stack.pop();
                 stack.push(symbolTable.resolve(relNameId).size());
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_OP_NEG: {
+            LVM_CASE(LVM_OP_NEG) {
                 RamDomain val = stack.top();
                 stack.pop();
                 stack.push(-val);
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_OP_BNOT: {
+            LVM_CASE(LVM_OP_BNOT) {
                 RamDomain val = stack.top();
                 stack.pop();
                 stack.push(~val);
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_OP_LNOT: {
+            LVM_CASE(LVM_OP_LNOT) {
                 RamDomain val = stack.top();
                 stack.pop();
                 stack.push(!val);
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_OP_TONUMBER: {
+            LVM_CASE(LVM_OP_TONUMBER) {
                 RamDomain val = stack.top();
                 stack.pop();
                 RamDomain result = 0;
@@ -180,26 +417,26 @@ void LVM::execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t
                 }
                 stack.push(result);
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_OP_TOSTRING: {
+            LVM_CASE(LVM_OP_TOSTRING) {
                 RamDomain val = stack.top();
                 RamDomain result = symbolTable.lookup(std::to_string(val));
                 stack.pop();
                 stack.push(result);
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_OP_ADD: {
+            LVM_CASE(LVM_OP_ADD) {
                 RamDomain x = stack.top();
                 stack.pop();
                 RamDomain y = stack.top();
                 stack.pop();
                 stack.push(x + y);
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_OP_SUB: {
+            LVM_CASE(LVM_OP_SUB) {
                 // Rhs was pushed last in the generator, so it should be on top.
                 RamDomain rhs = stack.top();
                 stack.pop();
@@ -207,90 +444,90 @@ void LVM::execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t
                 stack.pop();
                 stack.push(lhs - rhs);
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_OP_MUL: {
+            LVM_CASE(LVM_OP_MUL) {
                 RamDomain rhs = stack.top();
                 stack.pop();
                 RamDomain lhs = stack.top();
                 stack.pop();
                 stack.push(lhs * rhs);
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_OP_DIV: {
+            LVM_CASE(LVM_OP_DIV) {
                 RamDomain rhs = stack.top();
                 stack.pop();
                 RamDomain lhs = stack.top();
                 stack.pop();
                 stack.push(lhs / rhs);
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_OP_EXP: {
+            LVM_CASE(LVM_OP_EXP) {
                 RamDomain rhs = stack.top();
                 stack.pop();
                 RamDomain lhs = stack.top();
                 stack.pop();
                 stack.push(std::pow(lhs, rhs));
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_OP_MOD: {
+            LVM_CASE(LVM_OP_MOD) {
                 RamDomain rhs = stack.top();
                 stack.pop();
                 RamDomain lhs = stack.top();
                 stack.pop();
                 stack.push(lhs % rhs);
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_OP_BAND: {
+            LVM_CASE(LVM_OP_BAND) {
                 RamDomain rhs = stack.top();
                 stack.pop();
                 RamDomain lhs = stack.top();
                 stack.pop();
                 stack.push(lhs & rhs);
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_OP_BOR: {
+            LVM_CASE(LVM_OP_BOR) {
                 RamDomain rhs = stack.top();
                 stack.pop();
                 RamDomain lhs = stack.top();
                 stack.pop();
                 stack.push(lhs | rhs);
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_OP_BXOR: {
+            LVM_CASE(LVM_OP_BXOR) {
                 RamDomain rhs = stack.top();
                 stack.pop();
                 RamDomain lhs = stack.top();
                 stack.pop();
                 stack.push(lhs ^ rhs);
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_OP_LAND: {
+            LVM_CASE(LVM_OP_LAND) {
                 RamDomain rhs = stack.top();
                 stack.pop();
                 RamDomain lhs = stack.top();
                 stack.pop();
                 stack.push(lhs && rhs);
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_OP_LOR: {
+            LVM_CASE(LVM_OP_LOR) {
                 RamDomain rhs = stack.top();
                 stack.pop();
                 RamDomain lhs = stack.top();
                 stack.pop();
                 stack.push(lhs || rhs);
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_OP_MAX: {
+            LVM_CASE(LVM_OP_MAX) {
                 size_t size = code[ip + 1];
                 RamDomain val = MIN_RAM_DOMAIN;
                 for (size_t i = 0; i < size; ++i) {
@@ -299,9 +536,9 @@ void LVM::execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t
                 }
                 stack.push(val);
                 ip += 2;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_OP_MIN: {
+            LVM_CASE(LVM_OP_MIN) {
                 size_t size = code[ip + 1];
                 RamDomain val = MAX_RAM_DOMAIN;
                 for (size_t i = 0; i < size; ++i) {
@@ -310,9 +547,9 @@ void LVM::execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t
                 }
                 stack.push(val);
                 ip += 2;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_OP_CAT: {
+            LVM_CASE(LVM_OP_CAT) {
                 size_t size = code[ip + 1];
                 std::stringstream buf;
                 for (size_t i = 0; i < size; ++i) {
@@ -321,9 +558,9 @@ void LVM::execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t
                 }
                 stack.push(symbolTable.lookup(buf.str()));
                 ip += 2;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_OP_SUBSTR: {
+            LVM_CASE(LVM_OP_SUBSTR) {
                 RamDomain len = stack.top();
                 stack.pop();
                 RamDomain idx = stack.top();
@@ -341,63 +578,63 @@ void LVM::execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t
                 stack.push(symbolTable.lookup(sub_str));
 
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_OP_EQ: {
+            LVM_CASE(LVM_OP_EQ) {
                 RamDomain rhs = stack.top();
                 stack.pop();
                 RamDomain lhs = stack.top();
                 stack.pop();
                 stack.push(lhs == rhs);
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_OP_NE: {
+            LVM_CASE(LVM_OP_NE) {
                 RamDomain rhs = stack.top();
                 stack.pop();
                 RamDomain lhs = stack.top();
                 stack.pop();
                 stack.push(lhs != rhs);
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_OP_LT: {
+            LVM_CASE(LVM_OP_LT) {
                 RamDomain rhs = stack.top();
                 stack.pop();
                 RamDomain lhs = stack.top();
                 stack.pop();
                 stack.push(lhs < rhs);
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_OP_LE: {
+            LVM_CASE(LVM_OP_LE) {
                 RamDomain rhs = stack.top();
                 stack.pop();
                 RamDomain lhs = stack.top();
                 stack.pop();
                 stack.push(lhs <= rhs);
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_OP_GT: {
+            LVM_CASE(LVM_OP_GT) {
                 RamDomain rhs = stack.top();
                 stack.pop();
                 RamDomain lhs = stack.top();
                 stack.pop();
                 stack.push(lhs > rhs);
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_OP_GE: {
+            LVM_CASE(LVM_OP_GE) {
                 RamDomain rhs = stack.top();
                 stack.pop();
                 RamDomain lhs = stack.top();
                 stack.pop();
                 stack.push(lhs >= rhs);
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_OP_MATCH: {
+            LVM_CASE(LVM_OP_MATCH) {
                 RamDomain rhs = stack.top();
                 stack.pop();
                 RamDomain lhs = stack.top();
@@ -415,9 +652,9 @@ void LVM::execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t
                 }
                 stack.push(result);
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_OP_NOT_MATCH: {
+            LVM_CASE(LVM_OP_NOT_MATCH) {
                 RamDomain rhs = stack.top();
                 stack.pop();
                 RamDomain lhs = stack.top();
@@ -435,9 +672,9 @@ void LVM::execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t
                 }
                 stack.push(result);
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_OP_CONTAINS: {
+            LVM_CASE(LVM_OP_CONTAINS) {
                 RamDomain rhs = stack.top();
                 stack.pop();
                 RamDomain lhs = stack.top();
@@ -446,9 +683,9 @@ void LVM::execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t
                 const std::string& text = symbolTable.resolve(rhs);
                 stack.push(text.find(pattern) != std::string::npos);
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_OP_NOT_CONTAINS: {
+            LVM_CASE(LVM_OP_NOT_CONTAINS) {
                 RamDomain rhs = stack.top();
                 stack.pop();
                 RamDomain lhs = stack.top();
@@ -457,9 +694,162 @@ void LVM::execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t
                 const std::string& text = symbolTable.resolve(rhs);
                 stack.push(text.find(pattern) == std::string::npos);
                 ip += 1;
-                break;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_CompareTupleElements) {
+                RamDomain lhs = ctxt[code[ip + 2]][code[ip + 3]];
+                RamDomain rhs = ctxt[code[ip + 4]][code[ip + 5]];
+                stack.push(compare(code[ip + 1], lhs, rhs));
+                ip += 6;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_CompareTupleElementNumber) {
+                RamDomain lhs = ctxt[code[ip + 2]][code[ip + 3]];
+                stack.push(compare(code[ip + 1], lhs, code[ip + 4]));
+                ip += 5;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_REG_Number) {
+                reg[code[ip + 1]] = code[ip + 2];
+                ip += 3;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_REG_TupleElement) {
+                reg[code[ip + 1]] = ctxt[code[ip + 2]][code[ip + 3]];
+                ip += 4;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_REG_Argument) {
+                reg[code[ip + 1]] = ctxt.getArgument(code[ip + 2]);
+                ip += 3;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_REG_OP_NEG) {
+                reg[code[ip + 1]] = -reg[code[ip + 2]];
+                ip += 3;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_REG_OP_BNOT) {
+                reg[code[ip + 1]] = ~reg[code[ip + 2]];
+                ip += 3;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_REG_OP_LNOT) {
+                reg[code[ip + 1]] = !reg[code[ip + 2]];
+                ip += 3;
+                LVM_DISPATCH();
             }
-            case LVM_UserDefinedOperator: {
+            LVM_CASE(LVM_REG_Negation) {
+                reg[code[ip + 1]] = !reg[code[ip + 2]];
+                ip += 3;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_REG_OP_ADD) {
+                reg[code[ip + 1]] = reg[code[ip + 2]] + reg[code[ip + 3]];
+                ip += 4;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_REG_OP_SUB) {
+                reg[code[ip + 1]] = reg[code[ip + 2]] - reg[code[ip + 3]];
+                ip += 4;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_REG_OP_MUL) {
+                reg[code[ip + 1]] = reg[code[ip + 2]] * reg[code[ip + 3]];
+                ip += 4;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_REG_OP_DIV) {
+                reg[code[ip + 1]] = reg[code[ip + 2]] / reg[code[ip + 3]];
+                ip += 4;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_REG_OP_EXP) {
+                reg[code[ip + 1]] = std::pow(reg[code[ip + 2]], reg[code[ip + 3]]);
+                ip += 4;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_REG_OP_MOD) {
+                reg[code[ip + 1]] = reg[code[ip + 2]] % reg[code[ip + 3]];
+                ip += 4;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_REG_OP_BAND) {
+                reg[code[ip + 1]] = reg[code[ip + 2]] & reg[code[ip + 3]];
+                ip += 4;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_REG_OP_BOR) {
+                reg[code[ip + 1]] = reg[code[ip + 2]] | reg[code[ip + 3]];
+                ip += 4;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_REG_OP_BXOR) {
+                reg[code[ip + 1]] = reg[code[ip + 2]] ^ reg[code[ip + 3]];
+                ip += 4;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_REG_OP_LAND) {
+                reg[code[ip + 1]] = reg[code[ip + 2]] && reg[code[ip + 3]];
+                ip += 4;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_REG_OP_LOR) {
+                reg[code[ip + 1]] = reg[code[ip + 2]] || reg[code[ip + 3]];
+                ip += 4;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_REG_OP_MAX) {
+                reg[code[ip + 1]] = std::max(reg[code[ip + 2]], reg[code[ip + 3]]);
+                ip += 4;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_REG_OP_MIN) {
+                reg[code[ip + 1]] = std::min(reg[code[ip + 2]], reg[code[ip + 3]]);
+                ip += 4;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_REG_OP_EQ) {
+                reg[code[ip + 1]] = reg[code[ip + 2]] == reg[code[ip + 3]];
+                ip += 4;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_REG_OP_NE) {
+                reg[code[ip + 1]] = reg[code[ip + 2]] != reg[code[ip + 3]];
+                ip += 4;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_REG_OP_LT) {
+                reg[code[ip + 1]] = reg[code[ip + 2]] < reg[code[ip + 3]];
+                ip += 4;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_REG_OP_LE) {
+                reg[code[ip + 1]] = reg[code[ip + 2]] <= reg[code[ip + 3]];
+                ip += 4;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_REG_OP_GT) {
+                reg[code[ip + 1]] = reg[code[ip + 2]] > reg[code[ip + 3]];
+                ip += 4;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_REG_OP_GE) {
+                reg[code[ip + 1]] = reg[code[ip + 2]] >= reg[code[ip + 3]];
+                ip += 4;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_REG_Conjunction) {
+                reg[code[ip + 1]] = reg[code[ip + 2]] && reg[code[ip + 3]];
+                ip += 4;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_REG_Push) {
+                stack.push(reg[code[ip + 1]]);
+                ip += 2;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_UserDefinedOperator) {
                 // get name and type
                 const std::string name = symbolTable.resolve(code[ip + 1]);
                 const std::string type = symbolTable.resolve(code[ip + 2]);
@@ -517,9 +907,9 @@ void LVM::execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t
                 }
                 stack.push(result);
                 ip += 4;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_PackRecord: {
+            LVM_CASE(LVM_PackRecord) {
                 RamDomain arity = code[ip + 1];
                 RamDomain data[arity];
                 for (auto i = 0; i < arity; ++i) {
@@ -528,46 +918,46 @@ void LVM::execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t
                 }
                 stack.push(pack(data, arity));
                 ip += 2;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_Argument: {
+            LVM_CASE(LVM_Argument) {
                 stack.push(ctxt.getArgument(code[ip + 1]));
                 ip += 2;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_True: {
+            LVM_CASE(LVM_True) {
                 stack.push(1);
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             };
-            case LVM_False: {
+            LVM_CASE(LVM_False) {
                 stack.push(0);
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             };
-            case LVM_Conjunction: {
+            LVM_CASE(LVM_Conjunction) {
                 RamDomain rhs = stack.top();
                 stack.pop();
                 RamDomain lhs = stack.top();
                 stack.pop();
                 stack.push(lhs && rhs);
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_Negation: {
+            LVM_CASE(LVM_Negation) {
                 RamDomain val = stack.top();
                 stack.pop();
                 stack.push(!val);
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_EmptinessCheck: {
+            LVM_CASE(LVM_EmptinessCheck) {
                 size_t relId = code[ip + 1];
                 stack.push(getRelation(relId)->empty());
                 ip += 2;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_ContainCheck: {
+            LVM_CASE(LVM_ContainCheck) {
                 auto relPtr = getRelation(code[ip + 1]);
                 auto arity = relPtr->getArity();
                 RamDomain tuple[arity];
@@ -577,9 +967,9 @@ void LVM::execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t
                 }
                 stack.push(relPtr->contains(TupleRef(tuple, arity)));
                 ip += 2;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_ExistenceCheck: {
+            LVM_CASE(LVM_ExistenceCheck) {
                 auto relPtr = getRelation(code[ip + 1]);
                 auto arity = relPtr->getArity();
                 auto indexPos = code[ip + 2];
@@ -608,9 +998,9 @@ void LVM::execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t
                 stack.push(range.begin() != range.end());
 
                 ip += (3 + numOfTypeMasks);
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_ExistenceCheckOneArg: {
+            LVM_CASE(LVM_ExistenceCheckOneArg) {
                 auto relPtr = getRelation(code[ip + 1]);
                 auto arity = relPtr->getArity();
                 auto indexPos = code[ip + 2];
@@ -633,37 +1023,38 @@ void LVM::execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t
                 stack.push(range.begin() != range.end());
 
                 ip += 4;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_Constraint:
+            LVM_CASE(LVM_Constraint)
                 /** Does nothing, just a label */
                 ip += 1;
-                break;
-            case LVM_Scan:
+                LVM_DISPATCH();
+            LVM_CASE(LVM_Scan)
                 /** Does nothing, just a label */
                 ip += 1;
-                break;
-            case LVM_IndexScan:
+                LVM_DISPATCH();
+            LVM_CASE(LVM_IndexScan)
                 /** Does nothing, just a label */
                 ip += 1;
-                break;
-            case LVM_Choice:
+                LVM_DISPATCH();
+            LVM_CASE(LVM_Choice)
                 /** Does nothing, just a label */
                 ip += 1;
-                break;
-            case LVM_IndexChoice:
+                LVM_DISPATCH();
+            LVM_CASE(LVM_IndexChoice)
                 /** Does nothing, just a label */
                 ip += 1;
-                break;
-            case LVM_Search: {
+                LVM_DISPATCH();
+            LVM_CASE(LVM_Search) {
                 if (profile && code[ip + 1] != 0) {
                     const std::string& msg = symbolTable.resolve(code[ip + 2]);
+#pragma omp critical(LVMFrequencies)
                     this->frequencies[msg][this->getIterationNumber()]++;
                 }
                 ip += 3;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_UnpackRecord: {
+            LVM_CASE(LVM_UnpackRecord) {
                 RamDomain arity = code[ip + 1];
                 RamDomain id = code[ip + 2];
                 RamDomain exitAddress = code[ip + 3];
@@ -678,18 +1069,19 @@ void LVM::execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t
 
                 ctxt[id] = TupleRef(unpack(ref, arity), arity);
                 ip += 4;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_Filter:
+            LVM_CASE(LVM_Filter)
                 if (profile) {
                     const std::string& msg = symbolTable.resolve(code[ip + 1]);
                     if (!msg.empty()) {
+#pragma omp critical(LVMFrequencies)
                         this->frequencies[msg][this->getIterationNumber()]++;
                     }
                 }
                 ip += 2;
-                break;
-            case LVM_Project: {
+                LVM_DISPATCH();
+            LVM_CASE(LVM_Project) {
                 RamDomain arity = code[ip + 1];
                 size_t relId = code[ip + 2];
                 LVMRelation& rel = *getRelation(relId);
@@ -698,11 +1090,17 @@ void LVM::execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t
                     tuple[i] = stack.top();
                     stack.pop();
                 }
-                rel.insert(TupleRef(tuple, arity));
+                if (auto* buffer = ctxt.getInsertBuffer()) {
+                    auto& pending = (*buffer)[relId];
+                    pending.first++;
+                    pending.second.insert(pending.second.end(), tuple, tuple + arity);
+                } else {
+                    rel.insert(TupleRef(tuple, arity));
+                }
                 ip += 3;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_ReturnValue: {
+            LVM_CASE(LVM_ReturnValue) {
                 RamDomain size = code[ip + 1];
                 const std::string& types = symbolTable.resolve(code[ip + 2]);
                 for (auto i = 0; i < size; ++i) {
@@ -714,13 +1112,13 @@ void LVM::execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t
                     }
                 }
                 ip += 3;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_Sequence: {
+            LVM_CASE(LVM_Sequence) {
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_Parallel: {
+            LVM_CASE(LVM_Parallel) {
                 size_t size = code[ip + 1];
                 size_t end = code[ip + 2];
                 size_t startAddresses[size];
@@ -729,32 +1127,81 @@ void LVM::execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t
                 }
 #pragma omp parallel for
                 for (size_t i = 0; i < size; ++i) {
-                    this->execute(codeStream, ctxt, startAddresses[i]);
+                    // every statement iterates with its own streams
+                    LVMContext stmtCtxt;
+                    stmtCtxt.setReturnValues(ctxt.getReturnValues());
+                    stmtCtxt.setReturnErrors(ctxt.getReturnErrors());
+                    stmtCtxt.setArguments(ctxt.getArguments());
+                    this->execute(codeStream, stmtCtxt, startAddresses[i]);
                 }
 
                 ip = end;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_Stop_Parallel: {
-                ip += 2;
-                break;
+            LVM_CASE(LVM_ParallelScan) {
+                RamDomain dest = code[ip + 1];
+                const auto& relPtr = getRelation(code[ip + 2]);
+                size_t end = code[ip + 3];
+                executeParallel(codeStream, ctxt, dest, relPtr->partitionScan(NUM_PARTITIONS), ip + 4);
+                ip = end;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_ParallelIndexScan) {
+                RamDomain dest = code[ip + 1];
+                auto relPtr = getRelation(code[ip + 2]);
+                auto arity = relPtr->getArity();
+                RamDomain indexPos = code[ip + 3];
+                size_t end = code[ip + 4];
+                size_t numOfTypeMasks = code[ip + 5];
+
+                // create pattern tuple for range query
+                RamDomain low[arity];
+                RamDomain high[arity];
+                for (size_t i = 0; i < numOfTypeMasks; ++i) {
+                    RamDomain typeMask = code[ip + 6 + i];
+                    for (auto j = 0; j < RAM_DOMAIN_SIZE; ++j) {
+                        auto projectedIndex = i * RAM_DOMAIN_SIZE + j;
+                        if (projectedIndex >= arity) {
+                            break;
+                        }
+                        if (1 << j & typeMask) {
+                            low[projectedIndex] = stack.top();
+                            stack.pop();
+                            high[projectedIndex] = low[projectedIndex];
+                        } else {
+                            low[projectedIndex] = MIN_RAM_DOMAIN;
+                            high[projectedIndex] = MAX_RAM_DOMAIN;
+                        }
+                    }
+                }
+                executeParallel(codeStream, ctxt, dest,
+                        relPtr->partitionRange(
+                                indexPos, TupleRef(low, arity), TupleRef(high, arity), NUM_PARTITIONS),
+                        ip + 6 + numOfTypeMasks);
+                ip = end;
+                LVM_DISPATCH();
             }
-            case LVM_Loop: {
+            LVM_CASE(LVM_Stop_Parallel) {
+                // end of a block executed by a worker thread
+                assert(stack.size() == 0);
+                return;
+            }
+            LVM_CASE(LVM_Loop) {
                 /** Does nothing, jus a label */
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_IncIterationNumber: {
+            LVM_CASE(LVM_IncIterationNumber) {
                 incIterationNumber();
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             };
-            case LVM_ResetIterationNumber: {
+            LVM_CASE(LVM_ResetIterationNumber) {
                 resetIterationNumber();
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             };
-            case LVM_Exit: {
+            LVM_CASE(LVM_Exit) {
                 RamDomain val = stack.top();
                 stack.pop();
                 if (val) {
@@ -762,17 +1209,17 @@ void LVM::execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t
                     break;
                 }
                 ip += 2;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_LogTimer: {
+            LVM_CASE(LVM_LogTimer) {
                 const std::string& msg = symbolTable.resolve(code[ip + 1]);
                 size_t timerIndex = code[ip + 2];
                 Logger* logger = new Logger(msg.c_str(), this->getIterationNumber());
                 insertTimerAt(timerIndex, logger);
                 ip += 3;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_LogRelationTimer: {
+            LVM_CASE(LVM_LogRelationTimer) {
                 const std::string& msg = symbolTable.resolve(code[ip + 1]);
                 size_t timerIndex = code[ip + 2];
                 size_t relId = code[ip + 3];
@@ -781,21 +1228,21 @@ void LVM::execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t
                         msg.c_str(), this->getIterationNumber(), std::bind(&LVMRelation::size, &rel));
                 insertTimerAt(timerIndex, logger);
                 ip += 4;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_StopLogTimer: {
+            LVM_CASE(LVM_StopLogTimer) {
                 size_t timerIndex = code[ip + 1];
                 stopTimerAt(timerIndex);
                 ip += 2;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_DebugInfo: {
+            LVM_CASE(LVM_DebugInfo) {
                 const std::string& msg = symbolTable.resolve(code[ip + 1]);
                 SignalHandler::instance()->setMsg(msg.c_str());
                 ip += 2;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_Stratum: {
+            LVM_CASE(LVM_Stratum) {
                 this->level++;
                 // Record all the rleation that is created in the previous level
                 if (profile || this->level != 0) {
@@ -812,38 +1259,46 @@ void LVM::execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t
                     }
                 }
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_Create: {
+            LVM_CASE(LVM_Create) {
                 size_t relId = code[ip + 1];
                 auto res = getRelation(relId);
                 res->setLevel(level);
                 ip += 2;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_Clear: {
+            LVM_CASE(LVM_Clear) {
                 size_t relId = code[ip + 1];
                 auto relPtr = getRelation(relId);
                 relPtr->purge();
                 ip += 2;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_Drop: {
+            LVM_CASE(LVM_Drop) {
                 size_t relId = code[ip + 1];
                 dropRelation(relId);
                 ip += 2;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_LogSize: {
+            LVM_CASE(LVM_LogSize) {
                 size_t relId = code[ip + 1];
                 auto relPtr = getRelation(relId);
                 const std::string& msg = symbolTable.resolve(code[ip + 2]);
                 ProfileEventSingleton::instance().makeQuantityEvent(
                         msg, relPtr->size(), this->getIterationNumber());
                 ip += 3;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_Load: {
+            LVM_CASE(LVM_LogStatistics) {
+                size_t relId = code[ip + 1];
+                auto relPtr = getRelation(relId);
+                const std::string& msg = symbolTable.resolve(code[ip + 2]);
+                RelationStats::extractFrom(*relPtr, relPtr->getArity()).logTo(msg);
+                ip += 3;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_Load) {
                 size_t relId = code[ip + 1];
                 auto IOs = codeStream->getIODirectives()[code[ip + 2]];
 
@@ -862,9 +1317,9 @@ void LVM::execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t
                     }
                 }
                 ip += 3;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_Store: {
+            LVM_CASE(LVM_Store) {
                 size_t relId = code[ip + 1];
                 auto IOs = codeStream->getIODirectives()[code[ip + 2]];
 
@@ -883,9 +1338,9 @@ void LVM::execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t
                     }
                 }
                 ip += 3;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_Fact: {
+            LVM_CASE(LVM_Fact) {
                 size_t relId = code[ip + 1];
                 auto arity = code[ip + 2];
                 RamDomain tuple[arity];
@@ -895,9 +1350,9 @@ void LVM::execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t
                 }
                 getRelation(relId)->insert(TupleRef(tuple, arity));
                 ip += 3;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_Merge: {
+            LVM_CASE(LVM_Merge) {
                 size_t sourceId = code[ip + 1];
                 size_t targetId = code[ip + 2];
                 // get involved relation
@@ -912,54 +1367,85 @@ void LVM::execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t
                 trgPtr->insert(*srcPtr);
 
                 ip += 3;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_Swap: {
+            LVM_CASE(LVM_Swap) {
                 size_t firstRelId = code[ip + 1];
                 size_t secondRelId = code[ip + 2];
                 swapRelation(firstRelId, secondRelId);
                 ip += 3;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_Query:
+            LVM_CASE(LVM_Query)
                 /** Does nothing, just a label */
                 ip += 1;
-                break;
-            case LVM_Goto:
+                LVM_DISPATCH();
+            LVM_CASE(LVM_AdaptiveQuery) {
+                // choose the variant of the least cost for the current relation sizes
+                const std::string& msg = symbolTable.resolve(code[ip + 1]);
+                size_t numVariants = code[ip + 2];
+                size_t pos = ip + 3;
+                size_t chosen = 0;
+                size_t address = 0;
+                double minCost = 0;
+                for (size_t i = 0; i < numVariants; ++i) {
+                    size_t variantAddress = code[pos];
+                    size_t numScans = code[pos + 1];
+                    pos += 2;
+                    std::vector<std::array<size_t, 3>> scans;
+                    for (size_t j = 0; j < numScans; ++j, pos += 2) {
+                        const LVMRelation& rel = *getRelation(code[pos]);
+                        scans.push_back({{rel.size(), rel.getArity(), size_t(code[pos + 1])}});
+                    }
+                    double cost = RamAdaptiveQuery::estimateCost(scans);
+                    if (i == 0 || cost < minCost) {
+                        chosen = i;
+                        address = variantAddress;
+                        minCost = cost;
+                    }
+                }
+                if (!msg.empty()) {
+                    ProfileEventSingleton::instance().makeQuantityEvent(
+                            msg, chosen, this->getIterationNumber());
+                }
+                ip = address;
+                LVM_DISPATCH();
+            }
+            LVM_CASE(LVM_Goto)
                 ip = code[ip + 1];
-                break;
-            case LVM_Jmpnz: {
+                LVM_DISPATCH();
+            LVM_CASE(LVM_Jmpnz) {
                 RamDomain val = stack.top();
                 stack.pop();
                 ip = (val != 0 ? code[ip + 1] : ip + 2);
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_Jmpez: {
+            LVM_CASE(LVM_Jmpez) {
                 RamDomain val = stack.top();
                 stack.pop();
                 ip = (val == 0 ? code[ip + 1] : ip + 2);
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_Aggregate: {
+            LVM_CASE(LVM_Aggregate) {
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             };
-            case LVM_IndexAggregate: {
+            LVM_CASE(LVM_IndexAggregate) {
                 ip += 1;
-                break;
+                LVM_DISPATCH();
             };
-            case LVM_Aggregate_COUNT: {
+            LVM_CASE(LVM_Aggregate_COUNT) {
                 RamDomain res = 0;
                 RamDomain idx = code[ip + 1];
-                auto& stream = streamPool[idx];
+                auto& stream = ctxt.getStream(idx);
                 for (auto i = stream.begin(); i != stream.end(); ++i) {
                     res++;
                 }
                 stack.push(res);
                 ip += 2;
-                break;
+                LVM_DISPATCH();
             };
-            case LVM_Aggregate_Return: {
+            LVM_CASE(LVM_Aggregate_Return) {
                 RamDomain id = code[ip + 1];
                 RamDomain res = stack.top();
                 stack.pop();
@@ -967,17 +1453,17 @@ void LVM::execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t
                 tuple[0] = res;
                 ctxt[id] = TupleRef(tuple, 1);
                 ip += 2;
-                break;
+                LVM_DISPATCH();
             };
-            case LVM_ITER_InitFullIndex: {
+            LVM_CASE(LVM_ITER_InitFullIndex) {
                 RamDomain dest = code[ip + 1];
                 size_t relId = code[ip + 2];
                 const auto& relPtr = getRelation(relId);
-                lookUpStream(dest) = relPtr->scan();
+                ctxt.getStream(dest) = relPtr->scan();
                 ip += 3;
-                break;
+                LVM_DISPATCH();
             };
-            case LVM_ITER_InitRangeIndex: {
+            LVM_CASE(LVM_ITER_InitRangeIndex) {
                 RamDomain dest = code[ip + 1];
                 auto relPtr = getRelation(code[ip + 2]);
                 auto arity = relPtr->getArity();
@@ -1005,11 +1491,11 @@ void LVM::execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t
                     }
                 }
                 // get iterator range
-                lookUpStream(dest) = relPtr->range(indexPos, TupleRef(low, arity), TupleRef(high, arity));
+                ctxt.getStream(dest) = relPtr->range(indexPos, TupleRef(low, arity), TupleRef(high, arity));
                 ip += (4 + numOfTypeMasks);
-                break;
+                LVM_DISPATCH();
             };
-            case LVM_ITER_InitRangeIndexOneArg: {
+            LVM_CASE(LVM_ITER_InitRangeIndexOneArg) {
                 RamDomain dest = code[ip + 1];
                 auto relPtr = getRelation(code[ip + 2]);
                 auto arity = relPtr->getArity();
@@ -1030,38 +1516,43 @@ void LVM::execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t
                     }
                 }
                 // get iterator range
-                lookUpStream(dest) = relPtr->range(indexPos, TupleRef(low, arity), TupleRef(high, arity));
+                ctxt.getStream(dest) = relPtr->range(indexPos, TupleRef(low, arity), TupleRef(high, arity));
                 ip += 5;
-                break;
+                LVM_DISPATCH();
             };
-            case LVM_ITER_NotAtEnd: {
+            LVM_CASE(LVM_ITER_NotAtEnd) {
                 RamDomain idx = code[ip + 1];
-                auto& stream = lookUpStream(idx);
+                auto& stream = ctxt.getStream(idx);
                 stack.push(stream.begin() != stream.end());
                 ip += 2;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_ITER_Select: {
+            LVM_CASE(LVM_ITER_Select) {
                 RamDomain idx = code[ip + 1];
                 RamDomain tupleId = code[ip + 2];
-                auto& stream = lookUpStream(idx);
+                auto& stream = ctxt.getStream(idx);
                 ctxt[tupleId] = *stream.begin();
                 ip += 3;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_ITER_Inc: {
+            LVM_CASE(LVM_ITER_Inc) {
                 RamDomain idx = code[ip + 1];
-                ++streamPool[idx].begin();
+                ++ctxt.getStream(idx).begin();
                 ip += 2;
-                break;
+                LVM_DISPATCH();
             }
-            case LVM_STOP:
+            LVM_CASE(LVM_STOP)
                 assert(stack.size() == 0);
                 return;
             default:
                 printf("Unknown. eval()\n");
                 break;
         }
+#ifdef LVM_THREADED_DISPATCH
+        continue;
+    LVM_LABEL(LVM_Dispatch):
+        goto* dispatchTable[code[ip]];
+#endif
     }
 }  // namespace souffle
 
@@ -51,7 +51,8 @@ class LVM : public LVMInterface {
 public:
     LVM(RamTranslationUnit& tUnit)
             : LVMInterface(tUnit), profile(Global::config().has("profile")),
-              provenance(Global::config().has("provenance")) {}
+              provenance(Global::config().has("provenance")),
+              useRegisters(Global::config().get("interpreter") == "LVM-REG") {}
 
     virtual ~LVM() {
         for (auto* timer : timers) {
@@ -85,7 +86,7 @@ public:
         } else {
             // Parse and cache the program
             LVMGenerator generator(translationUnit.getSymbolTable(),
-                    translationUnit.getProgram()->getSubroutine(name), relationEncoder);
+                    translationUnit.getProgram()->getSubroutine(name), relationEncoder, useRegisters);
             subroutines.emplace(std::make_pair(name, generator.getCodeStream()));
             execute(subroutines.at(name), ctxt);
         }
@@ -95,7 +96,7 @@ public:
     void printMain() {
         if (mainProgram.get() == nullptr) {
             LVMGenerator generator(translationUnit.getSymbolTable(), *translationUnit.getProgram()->getMain(),
-                    relationEncoder);
+                    relationEncoder, useRegisters);
             mainProgram = generator.getCodeStream();
         }
         mainProgram->print();
@@ -162,14 +163,6 @@ protected:
         relationEncoder[relAId].swap(relationEncoder[relBId]);
     }
 
-    /** Lookup stream, resize the pool if necessary */
-    Stream& lookUpStream(size_t idx) {
-        if (idx >= streamPool.size()) {
-            streamPool.resize(idx + 1);
-        }
-        return streamPool[idx];
-    }
-
     /** Obtain the search columns */
     SearchSignature getSearchSignature(const std::string& patterns, size_t arity) {
         SearchSignature res = 0;
@@ -190,10 +183,29 @@ private:
      * */
     void execute(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t ip = 0);
 
+    /**
+     * Execute the loop body of an outer-most scan for each partition in parallel.
+     *
+     * Every partition is evaluated in its own context with the partition stream
+     * installed at the given iterator index. Relations are not modified while the
+     * partitions are processed; projected tuples are buffered and merged into the
+     * target relations in partition order afterwards.
+     *
+     * @param ip the start of the loop body
+     */
+    void executeParallel(std::unique_ptr<LVMCode>& codeStream, LVMContext& ctxt, size_t iter,
+            std::vector<Stream> partitions, size_t ip);
+
+    /** Number of partitions an outer-most parallel scan is split into */
+    static constexpr size_t NUM_PARTITIONS = 400;
+
     bool profile;
 
     bool provenance;
 
+    /** Evaluate expressions with registers rather than the value stack */
+    bool useRegisters;
+
     /** subroutines */
     std::map<std::string, std::unique_ptr<LVMCode>> subroutines;
 
@@ -206,9 +218,6 @@ private:
     /** counters for non-existence check */
     std::map<std::string, std::atomic<size_t>> reads;
 
-    /** List of streams for range operation */
-    std::vector<Stream> streamPool;
-
     /** stratum */
     size_t level = 0;
 
@@ -216,7 +225,7 @@ private:
     std::vector<Logger*> timers;
 
     /** counter for $ operator */
-    int counter = 0;
+    std::atomic<int> counter{0};
 
     /** iteration number (in a fix-point calculation) */
     size_t iteration = 0;
@@ -195,6 +195,151 @@ void LVMCode::print() const {
                 ip += 1;
                 break;
             }
+            case LVM_CompareTupleElements: {
+                printf("%ld\tLVM_CompareTupleElements\tOp:%d\tId:%d\tPos:%d\tId:%d\tPos:%d\n", ip,
+                        code[ip + 1], code[ip + 2], code[ip + 3], code[ip + 4], code[ip + 5]);
+                ip += 6;
+                break;
+            }
+            case LVM_CompareTupleElementNumber: {
+                printf("%ld\tLVM_CompareTupleElementNumber\tOp:%d\tId:%d\tPos:%d\tNumber:%d\n", ip,
+                        code[ip + 1], code[ip + 2], code[ip + 3], code[ip + 4]);
+                ip += 5;
+                break;
+            }
+            case LVM_REG_Number:
+                printf("%ld\tLVM_REG_Number\tDst:%d\t%d\n", ip, code[ip + 1], code[ip + 2]);
+                ip += 3;
+                break;
+            case LVM_REG_TupleElement:
+                printf("%ld\tLVM_REG_TupleElement\tDst:%d\tId:%d\tPos:%d\n", ip, code[ip + 1], code[ip + 2],
+                        code[ip + 3]);
+                ip += 4;
+                break;
+            case LVM_REG_Argument:
+                printf("%ld\tLVM_REG_Argument\tDst:%d\tArg:%d\n", ip, code[ip + 1], code[ip + 2]);
+                ip += 3;
+                break;
+            case LVM_REG_OP_NEG:
+                printf("%ld\tLVM_REG_OP_NEG\tDst:%d\tSrc:%d\n", ip, code[ip + 1], code[ip + 2]);
+                ip += 3;
+                break;
+            case LVM_REG_OP_BNOT:
+                printf("%ld\tLVM_REG_OP_BNOT\tDst:%d\tSrc:%d\n", ip, code[ip + 1], code[ip + 2]);
+                ip += 3;
+                break;
+            case LVM_REG_OP_LNOT:
+                printf("%ld\tLVM_REG_OP_LNOT\tDst:%d\tSrc:%d\n", ip, code[ip + 1], code[ip + 2]);
+                ip += 3;
+                break;
+            case LVM_REG_Negation:
+                printf("%ld\tLVM_REG_Negation\tDst:%d\tSrc:%d\n", ip, code[ip + 1], code[ip + 2]);
+                ip += 3;
+                break;
+            case LVM_REG_OP_ADD:
+                printf("%ld\tLVM_REG_OP_ADD\tDst:%d\tLhs:%d\tRhs:%d\n", ip, code[ip + 1], code[ip + 2],
+                        code[ip + 3]);
+                ip += 4;
+                break;
+            case LVM_REG_OP_SUB:
+                printf("%ld\tLVM_REG_OP_SUB\tDst:%d\tLhs:%d\tRhs:%d\n", ip, code[ip + 1], code[ip + 2],
+                        code[ip + 3]);
+                ip += 4;
+                break;
+            case LVM_REG_OP_MUL:
+                printf("%ld\tLVM_REG_OP_MUL\tDst:%d\tLhs:%d\tRhs:%d\n", ip, code[ip + 1], code[ip + 2],
+                        code[ip + 3]);
+                ip += 4;
+                break;
+            case LVM_REG_OP_DIV:
+                printf("%ld\tLVM_REG_OP_DIV\tDst:%d\tLhs:%d\tRhs:%d\n", ip, code[ip + 1], code[ip + 2],
+                        code[ip + 3]);
+                ip += 4;
+                break;
+            case LVM_REG_OP_EXP:
+                printf("%ld\tLVM_REG_OP_EXP\tDst:%d\tLhs:%d\tRhs:%d\n", ip, code[ip + 1], code[ip + 2],
+                        code[ip + 3]);
+                ip += 4;
+                break;
+            case LVM_REG_OP_MOD:
+                printf("%ld\tLVM_REG_OP_MOD\tDst:%d\tLhs:%d\tRhs:%d\n", ip, code[ip + 1], code[ip + 2],
+                        code[ip + 3]);
+                ip += 4;
+                break;
+            case LVM_REG_OP_BAND:
+                printf("%ld\tLVM_REG_OP_BAND\tDst:%d\tLhs:%d\tRhs:%d\n", ip, code[ip + 1], code[ip + 2],
+                        code[ip + 3]);
+                ip += 4;
+                break;
+            case LVM_REG_OP_BOR:
+                printf("%ld\tLVM_REG_OP_BOR\tDst:%d\tLhs:%d\tRhs:%d\n", ip, code[ip + 1], code[ip + 2],
+                        code[ip + 3]);
+                ip += 4;
+                break;
+            case LVM_REG_OP_BXOR:
+                printf("%ld\tLVM_REG_OP_BXOR\tDst:%d\tLhs:%d\tRhs:%d\n", ip, code[ip + 1], code[ip + 2],
+                        code[ip + 3]);
+                ip += 4;
+                break;
+            case LVM_REG_OP_LAND:
+                printf("%ld\tLVM_REG_OP_LAND\tDst:%d\tLhs:%d\tRhs:%d\n", ip, code[ip + 1], code[ip + 2],
+                        code[ip + 3]);
+                ip += 4;
+                break;
+            case LVM_REG_OP_LOR:
+                printf("%ld\tLVM_REG_OP_LOR\tDst:%d\tLhs:%d\tRhs:%d\n", ip, code[ip + 1], code[ip + 2],
+                        code[ip + 3]);
+                ip += 4;
+                break;
+            case LVM_REG_OP_MAX:
+                printf("%ld\tLVM_REG_OP_MAX\tDst:%d\tLhs:%d\tRhs:%d\n", ip, code[ip + 1], code[ip + 2],
+                        code[ip + 3]);
+                ip += 4;
+                break;
+            case LVM_REG_OP_MIN:
+                printf("%ld\tLVM_REG_OP_MIN\tDst:%d\tLhs:%d\tRhs:%d\n", ip, code[ip + 1], code[ip + 2],
+                        code[ip + 3]);
+                ip += 4;
+                break;
+            case LVM_REG_OP_EQ:
+                printf("%ld\tLVM_REG_OP_EQ\tDst:%d\tLhs:%d\tRhs:%d\n", ip, code[ip + 1], code[ip + 2],
+                        code[ip + 3]);
+                ip += 4;
+                break;
+            case LVM_REG_OP_NE:
+                printf("%ld\tLVM_REG_OP_NE\tDst:%d\tLhs:%d\tRhs:%d\n", ip, code[ip + 1], code[ip + 2],
+                        code[ip + 3]);
+                ip += 4;
+                break;
+            case LVM_REG_OP_LT:
+                printf("%ld\tLVM_REG_OP_LT\tDst:%d\tLhs:%d\tRhs:%d\n", ip, code[ip + 1], code[ip + 2],
+                        code[ip + 3]);
+                ip += 4;
+                break;
+            case LVM_REG_OP_LE:
+                printf("%ld\tLVM_REG_OP_LE\tDst:%d\tLhs:%d\tRhs:%d\n", ip, code[ip + 1], code[ip + 2],
+                        code[ip + 3]);
+                ip += 4;
+                break;
+            case LVM_REG_OP_GT:
+                printf("%ld\tLVM_REG_OP_GT\tDst:%d\tLhs:%d\tRhs:%d\n", ip, code[ip + 1], code[ip + 2],
+                        code[ip + 3]);
+                ip += 4;
+                break;
+            case LVM_REG_OP_GE:
+                printf("%ld\tLVM_REG_OP_GE\tDst:%d\tLhs:%d\tRhs:%d\n", ip, code[ip + 1], code[ip + 2],
+                        code[ip + 3]);
+                ip += 4;
+                break;
+            case LVM_REG_Conjunction:
+                printf("%ld\tLVM_REG_Conjunction\tDst:%d\tLhs:%d\tRhs:%d\n", ip, code[ip + 1], code[ip + 2],
+                        code[ip + 3]);
+                ip += 4;
+                break;
+            case LVM_REG_Push:
+                printf("%ld\tLVM_REG_Push\tSrc:%d\n", ip, code[ip + 1]);
+                ip += 2;
+                break;
             case LVM_UserDefinedOperator: {  // TODO Later
                 printf("%ld\tLVM_UserDefinedOperator\n", ip);
                 printf("\t%s\t%s\t\n", symbolTable.resolve(code[ip + 1]).c_str(),
@@ -263,6 +408,17 @@ void LVMCode::print() const {
                 printf("%ld\tLVM_IndexScan\n", ip);
                 ip += 1;
                 break;
+            case LVM_ParallelScan:
+                printf("%ld\tLVM_ParallelScan\tIterID:%d\tRelationName:%s\tEnd:%d\n", ip, code[ip + 1],
+                        symbolTable.resolve(code[ip + 2]).c_str(), code[ip + 3]);
+                ip += 4;
+                break;
+            case LVM_ParallelIndexScan: {
+                printf("%ld\tLVM_ParallelIndexScan\tIterID:%d\tRelationName:%s\tEnd:%d\n", ip, code[ip + 1],
+                        symbolTable.resolve(code[ip + 2]).c_str(), code[ip + 4]);
+                ip += 6 + code[ip + 5];
+                break;
+            }
             case LVM_Search: {
                 printf("%ld\tLVM_Search\t\n", ip);
                 ip += 3;
@@ -379,6 +535,12 @@ void LVMCode::print() const {
                 ip += 3;
                 break;
             }
+            case LVM_LogStatistics: {
+                printf("%ld\tLVM_LogStatistics\t\n", ip);
+                printf("\tRelation:%d\t%s\t\n", code[ip + 1], symbolTable.resolve(code[ip + 2]).c_str());
+                ip += 3;
+                break;
+            }
             case LVM_Load: {
                 printf("%ld\tLVM_Load\t\n", ip);
                 printf("\t%s\t IODirectivesID:%d\n", symbolTable.resolve(code[ip + 1]).c_str(), code[ip + 2]);
@@ -415,6 +577,20 @@ void LVMCode::print() const {
                 printf("%ld\tLVM_Query\t\n", ip);
                 ip += 1;
                 break;
+            case LVM_AdaptiveQuery: {
+                printf("%ld\tLVM_AdaptiveQuery\t\n", ip);
+                size_t numVariants = code[ip + 2];
+                ip += 3;
+                for (size_t i = 0; i < numVariants; ++i) {
+                    size_t numScans = code[ip + 1];
+                    printf("\tVariant at: %d\n", code[ip]);
+                    for (size_t j = 0; j < numScans; ++j) {
+                        printf("\t\tRelation: %d\tBound: %d\n", code[ip + 2 + 2 * j], code[ip + 3 + 2 * j]);
+                    }
+                    ip += 2 + 2 * numScans;
+                }
+                break;
+            }
             case LVM_Goto:
                 printf("%ld\tLVM_GOTO\t%d\n", ip, code[ip + 1]);
                 ip += 2;
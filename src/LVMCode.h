@@ -70,6 +70,10 @@ enum LVM_Type {
     LVM_OP_CONTAINS,
     LVM_OP_NOT_CONTAINS,
 
+    // Superinstructions fusing a numeric comparison with its operands
+    LVM_CompareTupleElements,
+    LVM_CompareTupleElementNumber,
+
     LVM_UserDefinedOperator,
     LVM_PackRecord,
     LVM_Argument,
@@ -100,6 +104,8 @@ enum LVM_Type {
     LVM_Project,
     LVM_ReturnValue,
     LVM_Search,
+    LVM_ParallelScan,
+    LVM_ParallelIndexScan,
 
     // LVM Stmts
     LVM_Sequence,
@@ -118,12 +124,14 @@ enum LVM_Type {
     LVM_Clear,
     LVM_Drop,
     LVM_LogSize,
+    LVM_LogStatistics,
     LVM_Load,
     LVM_Store,
     LVM_Fact,
     LVM_Merge,
     LVM_Swap,
     LVM_Query,
+    LVM_AdaptiveQuery,
 
     // LVM Branch
     LVM_Goto,
@@ -145,6 +153,39 @@ enum LVM_Type {
     LVM_ITER_Inc,
     LVM_ITER_NotAtEnd,
 
+    // Register-based expressions: operands and results are held in registers
+    // instead of on the value stack
+    LVM_REG_Number,
+    LVM_REG_TupleElement,
+    LVM_REG_Argument,
+    LVM_REG_OP_NEG,
+    LVM_REG_OP_BNOT,
+    LVM_REG_OP_LNOT,
+    LVM_REG_OP_ADD,
+    LVM_REG_OP_SUB,
+    LVM_REG_OP_MUL,
+    LVM_REG_OP_DIV,
+    LVM_REG_OP_EXP,
+    LVM_REG_OP_MOD,
+    LVM_REG_OP_BAND,
+    LVM_REG_OP_BOR,
+    LVM_REG_OP_BXOR,
+    LVM_REG_OP_LAND,
+    LVM_REG_OP_LOR,
+    LVM_REG_OP_MAX,
+    LVM_REG_OP_MIN,
+    LVM_REG_OP_EQ,
+    LVM_REG_OP_NE,
+    LVM_REG_OP_LT,
+    LVM_REG_OP_LE,
+    LVM_REG_OP_GT,
+    LVM_REG_OP_GE,
+    LVM_REG_Conjunction,
+    LVM_REG_Negation,
+    LVM_REG_Push,
+
+    // Number of opcodes, must be the last entry
+    LVM_NumOfOpcodes,
 };
 
 /**
@@ -188,6 +229,16 @@ public:
         return symbolTable;
     }
 
+    /** Return the number of registers used by register-based expressions */
+    size_t getNumOfRegisters() const {
+        return numOfRegisters;
+    }
+
+    /** Set the number of registers used by register-based expressions */
+    void setNumOfRegisters(size_t num) {
+        numOfRegisters = num;
+    }
+
     /** Print out the code stream */
     virtual void print() const;
 
@@ -199,6 +250,9 @@ private:
 
     /** Class for converting string to number and vice versa */
     SymbolTable& symbolTable;
+
+    /** Number of registers */
+    size_t numOfRegisters = 0;
 };
 
 }  // End of namespace souffle
@@ -19,11 +19,16 @@
 #include "LVMRelation.h"
 #include "RamTypes.h"
 #include <cassert>
+#include <map>
 #include <memory>
+#include <utility>
 #include <vector>
 
 namespace souffle {
 
+/** Tuples projected by a partition of a parallel operation, grouped by target relation id */
+using LVMInsertBuffer = std::map<size_t, std::pair<size_t, std::vector<RamDomain>>>;
+
 /**
  * Evaluation context for Interpreter operations
  */
@@ -34,6 +39,8 @@ class LVMContext {
     std::vector<bool>* returnErrors = nullptr;
     const std::vector<RamDomain>* args = nullptr;
     std::vector<std::unique_ptr<RamDomain[]>> allocatedDataContainer;
+    std::vector<Stream> streams;
+    LVMInsertBuffer* insertBuffer = nullptr;
 
 public:
     LVMContext(size_t size = 0) : data(size) {}
@@ -90,6 +97,23 @@ public:
         assert(args != nullptr && i < args->size() && "argument out of range");
         return (*args)[i];
     }
+
+    /** Lookup stream, resize the pool if necessary */
+    Stream& getStream(size_t idx) {
+        if (idx >= streams.size()) {
+            streams.resize(idx + 1);
+        }
+        return streams[idx];
+    }
+
+    /** Get buffer for projected tuples; if not set, tuples are inserted immediately */
+    LVMInsertBuffer* getInsertBuffer() const {
+        return insertBuffer;
+    }
+
+    void setInsertBuffer(LVMInsertBuffer& buffer) {
+        insertBuffer = &buffer;
+    }
 };
 
 }  // end of namespace souffle
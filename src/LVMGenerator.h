@@ -94,6 +94,9 @@ private:
             case RelationRepresentation::EQREL:
                 return std::make_unique<LVMEqRelation>(
                         rel.getArity(), rel.getName(), rel.getAttributeTypeQualifiers(), orderSet);
+            case RelationRepresentation::INDIRECT:
+                return std::make_unique<LVMIndirectRelation>(
+                        rel.getArity(), rel.getName(), rel.getAttributeTypeQualifiers(), orderSet);
             case RelationRepresentation::DEFAULT:
                 return std::make_unique<LVMRelation>(
                         rel.getArity(), rel.getName(), rel.getAttributeTypeQualifiers(), orderSet);
@@ -114,12 +117,15 @@ public:
      * This is done by traversing the tree twice, in order to find the necessary information (Jump
      * destination) for LVM branch operations.
      */
-    LVMGenerator(SymbolTable& symbolTable, const RamStatement& entry, RelationEncoder& relationEncoder)
-            : symbolTable(symbolTable), code(new LVMCode(symbolTable)), relationEncoder(relationEncoder) {
+    LVMGenerator(SymbolTable& symbolTable, const RamStatement& entry, RelationEncoder& relationEncoder,
+            bool useRegisters = false)
+            : symbolTable(symbolTable), code(new LVMCode(symbolTable)), relationEncoder(relationEncoder),
+              useRegisters(useRegisters) {
         (*this)(entry, 0);
         (*this).cleanUp();
         (*this)(entry, 0);
         code->push_back(LVM_STOP);
+        code->setNumOfRegisters(numOfRegisters);
     }
 
     virtual std::unique_ptr<LVMCode> getCodeStream() {
@@ -145,6 +151,10 @@ protected:
     }
 
     void visitIntrinsicOperator(const RamIntrinsicOperator& op, size_t exitAddress) override {
+        if (isRegisterEvaluable(op)) {
+            emitRegisterRoot(op);
+            return;
+        }
         const auto& args = op.getArguments();
         switch (op.getOperator()) {
             // Unary Functor Operator
@@ -305,12 +315,20 @@ protected:
     }
 
     void visitConjunction(const RamConjunction& conj, size_t exitAddress) override {
+        if (isRegisterEvaluable(conj)) {
+            emitRegisterRoot(conj);
+            return;
+        }
         visit(conj.getLHS(), exitAddress);
         visit(conj.getRHS(), exitAddress);
         code->push_back(LVM_Conjunction);
     }
 
     void visitNegation(const RamNegation& neg, size_t exitAddress) override {
+        if (isRegisterEvaluable(neg)) {
+            emitRegisterRoot(neg);
+            return;
+        }
         visit(neg.getOperand(), exitAddress);
         code->push_back(LVM_Negation);
     }
@@ -381,6 +399,13 @@ protected:
     }
 
     void visitConstraint(const RamConstraint& relOp, size_t exitAddress) override {
+        if (emitFusedConstraint(relOp)) {
+            return;
+        }
+        if (isRegisterEvaluable(relOp)) {
+            emitRegisterRoot(relOp);
+            return;
+        }
         code->push_back(LVM_Constraint);
         visit(relOp.getLHS(), exitAddress);
         visit(relOp.getRHS(), exitAddress);
@@ -472,6 +497,24 @@ protected:
         setAddress(L1, code->size());
     }
 
+    void visitParallelScan(const RamParallelScan& pscan, size_t exitAddress) override {
+        if (!isPartitionable(pscan)) {
+            visitScan(pscan, exitAddress);
+            return;
+        }
+        size_t counterLabel = getNewIterator();
+        size_t L1 = getNewAddressLabel();
+
+        // Partition the relation, each partition is iterated by the loop below
+        code->push_back(LVM_ParallelScan);
+        code->push_back(counterLabel);
+        code->push_back(relationEncoder.encodeRelation(pscan.getRelation()));
+        code->push_back(lookupAddress(L1));
+
+        emitPartitionLoop(pscan, counterLabel);
+        setAddress(L1, code->size());
+    }
+
     void visitChoice(const RamChoice& choice, size_t exitAddress) override {
         code->push_back(LVM_Choice);
         size_t counterLabel = getNewIterator();
@@ -562,6 +605,49 @@ protected:
         setAddress(L1, code->size());
     }
 
+    void visitParallelIndexScan(const RamParallelIndexScan& pscan, size_t exitAddress) override {
+        if (!isPartitionable(pscan)) {
+            visitIndexScan(pscan, exitAddress);
+            return;
+        }
+        size_t counterLabel = getNewIterator();
+        size_t L1 = getNewAddressLabel();
+
+        // Obtain the pattern for index
+        auto patterns = pscan.getRangePattern();
+        auto arity = pscan.getRelation().getArity();
+        auto relId = relationEncoder.encodeRelation(pscan.getRelation());
+        std::vector<int> typeMask(arity);
+        bool fullIndexSearch = true;
+        for (size_t i = arity; i-- > 0;) {
+            if (!isRamUndefValue(patterns[i])) {
+                visit(patterns[i], exitAddress);
+                fullIndexSearch = false;
+                typeMask[i] = 1;
+            }
+        }
+
+        // Partition the range, each partition is iterated by the loop below
+        if (fullIndexSearch == true) {
+            code->push_back(LVM_ParallelScan);
+            code->push_back(counterLabel);
+            code->push_back(relId);
+            code->push_back(lookupAddress(L1));
+        } else {
+            size_t numOfTypeMasks = arity / RAM_DOMAIN_SIZE + (arity % RAM_DOMAIN_SIZE != 0);
+            code->push_back(LVM_ParallelIndexScan);
+            code->push_back(counterLabel);
+            code->push_back(relId);
+            code->push_back(getIndexPos(pscan));
+            code->push_back(lookupAddress(L1));
+            code->push_back(numOfTypeMasks);
+            emitTypeMasks(arity, typeMask);
+        }
+
+        emitPartitionLoop(pscan, counterLabel);
+        setAddress(L1, code->size());
+    }
+
     void visitIndexChoice(const RamIndexChoice& indexChoice, size_t exitAddress) override {
         code->push_back(LVM_IndexChoice);
         size_t counterLabel = getNewIterator();
@@ -970,6 +1056,36 @@ protected:
         setAddress(endAddress, code->size());
     }
 
+    void visitAdaptiveQuery(const RamAdaptiveQuery& adaptive, size_t exitAddress) override {
+        auto variants = adaptive.getStatements();
+        size_t size = variants.size();
+        code->push_back(LVM_AdaptiveQuery);
+        code->push_back(symbolTable.lookup(adaptive.getMessage()));
+        code->push_back(size);
+        size_t endAddress = getNewAddressLabel();
+        size_t startAddresses[size];
+
+        // encode the scanned relations of each variant for estimating its cost
+        for (size_t i = 0; i < size; ++i) {
+            startAddresses[i] = getNewAddressLabel();
+            code->push_back(lookupAddress(startAddresses[i]));
+            auto scans = adaptive.getScans(i);
+            code->push_back(scans.size());
+            for (const auto& scan : scans) {
+                code->push_back(relationEncoder.encodeRelation(*scan.first));
+                code->push_back(scan.second);
+            }
+        }
+
+        for (size_t i = 0; i < size; ++i) {
+            setAddress(startAddresses[i], code->size());
+            visit(variants[i], exitAddress);
+            code->push_back(LVM_Goto);
+            code->push_back(lookupAddress(endAddress));
+        }
+        setAddress(endAddress, code->size());
+    }
+
     void visitLoop(const RamLoop& loop, size_t exitAddress) override {
         size_t address_L0 = code->size();
         code->push_back(LVM_Loop);
@@ -1046,6 +1162,12 @@ protected:
         code->push_back(symbolTable.lookup(size.getMessage()));
     }
 
+    void visitLogStatistics(const RamLogStatistics& stats, size_t exitAddress) override {
+        code->push_back(LVM_LogStatistics);
+        code->push_back(relationEncoder.encodeRelation(stats.getRelation()));
+        code->push_back(symbolTable.lookup(stats.getMessage()));
+    }
+
     void visitLoad(const RamLoad& load, size_t exitAddress) override {
         code->push_back(LVM_Load);
         code->push_back(relationEncoder.encodeRelation(load.getRelation()));
@@ -1126,6 +1248,15 @@ private:
     /** Relation Encoder */
     RelationEncoder& relationEncoder;
 
+    /** Evaluate expressions and conditions with registers rather than the value stack */
+    bool useRegisters;
+
+    /** Next free register */
+    size_t nextRegister = 0;
+
+    /** Number of registers required by the code stream */
+    size_t numOfRegisters = 0;
+
     /** Clean up all the content except for addressMap
      *  This is for the double traverse when transforming from RAM -> LVM Bytecode.
      * */
@@ -1183,6 +1314,307 @@ private:
         return i;
     };
 
+    /**
+     * Emit a superinstruction for a numeric comparison between tuple elements and constants,
+     * which would otherwise take three to four instructions.
+     *
+     * @return false if the constraint cannot be fused
+     */
+    bool emitFusedConstraint(const RamConstraint& relOp) {
+        // comparison operator, and its converse for swapped operands
+        LVM_Type op;
+        LVM_Type converseOp;
+        switch (relOp.getOperator()) {
+            case BinaryConstraintOp::EQ:
+                op = converseOp = LVM_OP_EQ;
+                break;
+            case BinaryConstraintOp::NE:
+                op = converseOp = LVM_OP_NE;
+                break;
+            case BinaryConstraintOp::LT:
+                op = LVM_OP_LT;
+                converseOp = LVM_OP_GT;
+                break;
+            case BinaryConstraintOp::LE:
+                op = LVM_OP_LE;
+                converseOp = LVM_OP_GE;
+                break;
+            case BinaryConstraintOp::GT:
+                op = LVM_OP_GT;
+                converseOp = LVM_OP_LT;
+                break;
+            case BinaryConstraintOp::GE:
+                op = LVM_OP_GE;
+                converseOp = LVM_OP_LE;
+                break;
+            default:
+                return false;
+        }
+
+        const auto* lhsElement = dynamic_cast<const RamTupleElement*>(&relOp.getLHS());
+        const auto* rhsElement = dynamic_cast<const RamTupleElement*>(&relOp.getRHS());
+        const auto* lhsNumber = dynamic_cast<const RamNumber*>(&relOp.getLHS());
+        const auto* rhsNumber = dynamic_cast<const RamNumber*>(&relOp.getRHS());
+
+        if (lhsElement != nullptr && rhsElement != nullptr) {
+            code->push_back(LVM_CompareTupleElements);
+            code->push_back(op);
+            code->push_back(lhsElement->getTupleId());
+            code->push_back(lhsElement->getElement());
+            code->push_back(rhsElement->getTupleId());
+            code->push_back(rhsElement->getElement());
+        } else if (lhsElement != nullptr && rhsNumber != nullptr) {
+            code->push_back(LVM_CompareTupleElementNumber);
+            code->push_back(op);
+            code->push_back(lhsElement->getTupleId());
+            code->push_back(lhsElement->getElement());
+            code->push_back(rhsNumber->getConstant());
+        } else if (lhsNumber != nullptr && rhsElement != nullptr) {
+            code->push_back(LVM_CompareTupleElementNumber);
+            code->push_back(converseOp);
+            code->push_back(rhsElement->getTupleId());
+            code->push_back(rhsElement->getElement());
+            code->push_back(lhsNumber->getConstant());
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    /** Get the register instruction of a unary or binary intrinsic operator, LVM_NOP if there is none */
+    static LVM_Type getRegisterOp(FunctorOp op) {
+        switch (op) {
+            case FunctorOp::NEG:
+                return LVM_REG_OP_NEG;
+            case FunctorOp::BNOT:
+                return LVM_REG_OP_BNOT;
+            case FunctorOp::LNOT:
+                return LVM_REG_OP_LNOT;
+            case FunctorOp::ADD:
+                return LVM_REG_OP_ADD;
+            case FunctorOp::SUB:
+                return LVM_REG_OP_SUB;
+            case FunctorOp::MUL:
+                return LVM_REG_OP_MUL;
+            case FunctorOp::DIV:
+                return LVM_REG_OP_DIV;
+            case FunctorOp::EXP:
+                return LVM_REG_OP_EXP;
+            case FunctorOp::MOD:
+                return LVM_REG_OP_MOD;
+            case FunctorOp::BAND:
+                return LVM_REG_OP_BAND;
+            case FunctorOp::BOR:
+                return LVM_REG_OP_BOR;
+            case FunctorOp::BXOR:
+                return LVM_REG_OP_BXOR;
+            case FunctorOp::LAND:
+                return LVM_REG_OP_LAND;
+            case FunctorOp::LOR:
+                return LVM_REG_OP_LOR;
+            case FunctorOp::MAX:
+                return LVM_REG_OP_MAX;
+            case FunctorOp::MIN:
+                return LVM_REG_OP_MIN;
+            default:
+                return LVM_NOP;
+        }
+    }
+
+    /** Get the register instruction of a numeric constraint, LVM_NOP if there is none */
+    static LVM_Type getRegisterOp(BinaryConstraintOp op) {
+        switch (op) {
+            case BinaryConstraintOp::EQ:
+                return LVM_REG_OP_EQ;
+            case BinaryConstraintOp::NE:
+                return LVM_REG_OP_NE;
+            case BinaryConstraintOp::LT:
+                return LVM_REG_OP_LT;
+            case BinaryConstraintOp::LE:
+                return LVM_REG_OP_LE;
+            case BinaryConstraintOp::GT:
+                return LVM_REG_OP_GT;
+            case BinaryConstraintOp::GE:
+                return LVM_REG_OP_GE;
+            default:
+                return LVM_NOP;
+        }
+    }
+
+    /** Check whether a node can be evaluated by register instructions only */
+    bool isRegisterEvaluable(const RamNode& node) {
+        if (!useRegisters) {
+            return false;
+        }
+        if (dynamic_cast<const RamNumber*>(&node) != nullptr ||
+                dynamic_cast<const RamTupleElement*>(&node) != nullptr ||
+                dynamic_cast<const RamSubroutineArgument*>(&node) != nullptr ||
+                dynamic_cast<const RamTrue*>(&node) != nullptr ||
+                dynamic_cast<const RamFalse*>(&node) != nullptr) {
+            return true;
+        }
+        if (const auto* op = dynamic_cast<const RamIntrinsicOperator*>(&node)) {
+            return getRegisterOp(op->getOperator()) != LVM_NOP &&
+                   all_of(op->getArguments(),
+                           [&](const RamExpression* arg) { return isRegisterEvaluable(*arg); });
+        }
+        if (const auto* constraint = dynamic_cast<const RamConstraint*>(&node)) {
+            return getRegisterOp(constraint->getOperator()) != LVM_NOP &&
+                   isRegisterEvaluable(constraint->getLHS()) && isRegisterEvaluable(constraint->getRHS());
+        }
+        if (const auto* conj = dynamic_cast<const RamConjunction*>(&node)) {
+            return isRegisterEvaluable(conj->getLHS()) && isRegisterEvaluable(conj->getRHS());
+        }
+        if (const auto* neg = dynamic_cast<const RamNegation*>(&node)) {
+            return isRegisterEvaluable(neg->getOperand());
+        }
+        return false;
+    }
+
+    /** Emit register instructions evaluating a node and push its value onto the stack */
+    void emitRegisterRoot(const RamNode& node) {
+        nextRegister = 0;
+        size_t result = emitRegisterCode(node);
+        code->push_back(LVM_REG_Push);
+        code->push_back(result);
+    }
+
+    /**
+     * Emit register instructions evaluating a node.
+     * Registers used for operands are released once the result has been computed.
+     *
+     * @return the register holding the result
+     */
+    size_t emitRegisterCode(const RamNode& node) {
+        size_t dst = nextRegister++;
+        numOfRegisters = std::max(numOfRegisters, nextRegister);
+
+        if (const auto* num = dynamic_cast<const RamNumber*>(&node)) {
+            code->push_back(LVM_REG_Number);
+            code->push_back(dst);
+            code->push_back(num->getConstant());
+        } else if (const auto* access = dynamic_cast<const RamTupleElement*>(&node)) {
+            code->push_back(LVM_REG_TupleElement);
+            code->push_back(dst);
+            code->push_back(access->getTupleId());
+            code->push_back(access->getElement());
+        } else if (const auto* arg = dynamic_cast<const RamSubroutineArgument*>(&node)) {
+            code->push_back(LVM_REG_Argument);
+            code->push_back(dst);
+            code->push_back(arg->getArgument());
+        } else if (dynamic_cast<const RamTrue*>(&node) != nullptr) {
+            code->push_back(LVM_REG_Number);
+            code->push_back(dst);
+            code->push_back(1);
+        } else if (dynamic_cast<const RamFalse*>(&node) != nullptr) {
+            code->push_back(LVM_REG_Number);
+            code->push_back(dst);
+            code->push_back(0);
+        } else if (const auto* op = dynamic_cast<const RamIntrinsicOperator*>(&node)) {
+            const auto& args = op->getArguments();
+            LVM_Type instr = getRegisterOp(op->getOperator());
+            if (args.size() == 1) {
+                size_t src = emitRegisterCode(*args[0]);
+                code->push_back(instr);
+                code->push_back(dst);
+                code->push_back(src);
+            } else {
+                // fold n-ary operators (max, min) into a sequence of binary instructions
+                size_t lhs = emitRegisterCode(*args[0]);
+                for (size_t i = 1; i < args.size(); ++i) {
+                    size_t rhs = emitRegisterCode(*args[i]);
+                    code->push_back(instr);
+                    code->push_back(dst);
+                    code->push_back(lhs);
+                    code->push_back(rhs);
+                    lhs = dst;
+                }
+            }
+        } else if (const auto* constraint = dynamic_cast<const RamConstraint*>(&node)) {
+            size_t lhs = emitRegisterCode(constraint->getLHS());
+            size_t rhs = emitRegisterCode(constraint->getRHS());
+            code->push_back(getRegisterOp(constraint->getOperator()));
+            code->push_back(dst);
+            code->push_back(lhs);
+            code->push_back(rhs);
+        } else if (const auto* conj = dynamic_cast<const RamConjunction*>(&node)) {
+            size_t lhs = emitRegisterCode(conj->getLHS());
+            size_t rhs = emitRegisterCode(conj->getRHS());
+            code->push_back(LVM_REG_Conjunction);
+            code->push_back(dst);
+            code->push_back(lhs);
+            code->push_back(rhs);
+        } else if (const auto* neg = dynamic_cast<const RamNegation*>(&node)) {
+            size_t src = emitRegisterCode(neg->getOperand());
+            code->push_back(LVM_REG_Negation);
+            code->push_back(dst);
+            code->push_back(src);
+        } else {
+            assert(false && "node cannot be evaluated by register instructions");
+        }
+
+        nextRegister = dst + 1;
+        return dst;
+    }
+
+    /** Check whether an outer-most loop can be partitioned across threads */
+    bool isPartitionable(const RamRelationOperation& op) {
+        if (op.getRelation().getArity() == 0) {
+            return false;
+        }
+        // subroutines return values in evaluation order
+        bool hasReturn = false;
+        visitDepthFirst(op, [&](const RamSubroutineReturnValue&) { hasReturn = true; });
+        return !hasReturn;
+    }
+
+    /** Emit the loop iterating a single partition of a parallel scan, executed by a worker thread */
+    void emitPartitionLoop(const RamRelationOperation& scan, const size_t& counterLabel) {
+        size_t L1 = getNewAddressLabel();
+
+        // While iter is not at end
+        size_t address_L0 = code->size();
+        code->push_back(LVM_ITER_NotAtEnd);
+        code->push_back(counterLabel);
+        code->push_back(LVM_Jmpez);
+        code->push_back(lookupAddress(L1));
+
+        // Select the tuple pointed by the iter
+        code->push_back(LVM_ITER_Select);
+        code->push_back(counterLabel);
+        code->push_back(scan.getTupleId());
+
+        // Perform nested operation
+        visitTupleOperation(scan, lookupAddress(L1));
+
+        // Increment the iter and jump to the start of while loop.
+        code->push_back(LVM_ITER_Inc);
+        code->push_back(counterLabel);
+        code->push_back(LVM_Goto);
+        code->push_back(address_L0);
+
+        // Return to the thread executing the parallel scan
+        setAddress(L1, code->size());
+        code->push_back(LVM_Stop_Parallel);
+        code->push_back(LVM_NOP);
+    }
+
+    /** Emit the type masks of a search pattern */
+    void emitTypeMasks(const size_t& arity, const std::vector<int>& typeMask) {
+        size_t numOfTypeMasks = arity / RAM_DOMAIN_SIZE + (arity % RAM_DOMAIN_SIZE != 0);
+        for (size_t i = 0; i < numOfTypeMasks; ++i) {
+            RamDomain types = 0;
+            for (size_t j = 0; j < RAM_DOMAIN_SIZE; ++j) {
+                auto projectedIndex = i * RAM_DOMAIN_SIZE + j;
+                if (projectedIndex >= arity) {
+                    break;
+                }
+                types |= (typeMask[projectedIndex] << j);
+            }
+            code->push_back(types);
+        }
+    }
+
     /** Emit existence check instructions */
     void emitExistenceCheckInst(const size_t& arity, const size_t& relId, const size_t& indexPos,
             const std::vector<int>& typeMask) {
@@ -1198,17 +1630,7 @@ private:
         }
         code->push_back(relId);
         code->push_back(indexPos);
-        for (size_t i = 0; i < numOfTypeMasks; ++i) {
-            RamDomain types = 0;
-            for (size_t j = 0; j < RAM_DOMAIN_SIZE; ++j) {
-                auto projectedIndex = i * RAM_DOMAIN_SIZE + j;
-                if (projectedIndex >= arity) {
-                    break;
-                }
-                types |= (typeMask[projectedIndex] << j);
-            }
-            code->push_back(types);
-        }
+        emitTypeMasks(arity, typeMask);
     }
 
     /** Emit range index instructions */
@@ -1227,17 +1649,7 @@ private:
         code->push_back(counterLabel);
         code->push_back(relId);
         code->push_back(indexPos);
-        for (size_t i = 0; i < numOfTypeMasks; ++i) {
-            RamDomain types = 0;
-            for (size_t j = 0; j < RAM_DOMAIN_SIZE; ++j) {
-                auto projectedIndex = i * RAM_DOMAIN_SIZE + j;
-                if (projectedIndex >= arity) {
-                    break;
-                }
-                types |= (typeMask[projectedIndex] << j);
-            }
-            code->push_back(types);
-        }
+        emitTypeMasks(arity, typeMask);
     }
 
 };  // namespace souffle
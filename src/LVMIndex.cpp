@@ -158,6 +158,7 @@ public:
  */
 template <typename Structure>
 class GenericIndex : public LVMIndex {
+protected:
     using Entry = typename Structure::element_type;
     static constexpr int Arity = Entry::arity;
 
@@ -167,6 +168,7 @@ class GenericIndex : public LVMIndex {
     // the internal data structure
     Structure data;
 
+private:
     // a source adapter for streaming through data
     class Source : public Stream::Source {
         const Order& order;
@@ -235,6 +237,29 @@ public:
     }
 
     Stream range(const TupleRef& low, const TupleRef& high) const override {
+        auto bounds = getBounds(low, high);
+        return std::make_unique<Source>(order, bounds.first, bounds.second);
+    }
+
+    std::vector<Stream> partitionScan(size_t chunks) const override {
+        return partition(data.begin(), data.end(), chunks);
+    }
+
+    std::vector<Stream> partitionRange(
+            const TupleRef& low, const TupleRef& high, size_t chunks) const override {
+        auto bounds = getBounds(low, high);
+        return partition(bounds.first, bounds.second, chunks);
+    }
+
+    void clear() override {
+        data.clear();
+    }
+
+private:
+    using iter = typename Structure::iterator;
+
+    /** Obtains the iterators enclosing the elements between low and high */
+    std::pair<iter, iter> getBounds(const TupleRef& low, const TupleRef& high) const {
         Entry a = order.encode(low.asTuple<Arity>());
         Entry b = order.encode(high.asTuple<Arity>());
         // Transfer upper_bound to a equivalent lower bound
@@ -251,11 +276,16 @@ public:
             }
         }
         assert(fullIndexSearch == false && "Full index search is not allowed in range query\n");
-        return std::make_unique<Source>(order, data.lower_bound(a), data.lower_bound(b));
+        return std::make_pair(data.lower_bound(a), data.lower_bound(b));
     }
 
-    void clear() override {
-        data.clear();
+    /** Splits the given range into (roughly) the given number of streams */
+    std::vector<Stream> partition(iter begin, iter end, size_t chunks) const {
+        std::vector<Stream> res;
+        for (auto& part : make_range(begin, end).partition(chunks)) {
+            res.push_back(std::make_unique<Source>(order, part.begin(), part.end()));
+        }
+        return res;
     }
 };
 
@@ -369,6 +399,23 @@ public:
         return std::make_unique<Source>(set.lower_bound(low), set.upper_bound(high));
     }
 
+    std::vector<Stream> partitionScan(size_t chunks) const override {
+        std::vector<Stream> res;
+        for (auto& part : set.getChunks(chunks)) {
+            res.push_back(std::make_unique<Source>(part.begin(), part.end()));
+        }
+        return res;
+    }
+
+    std::vector<Stream> partitionRange(
+            const TupleRef& low, const TupleRef& high, size_t chunks) const override {
+        std::vector<Stream> res;
+        for (auto& part : make_range(set.lower_bound(low), set.upper_bound(high)).partition(chunks)) {
+            res.push_back(std::make_unique<Source>(part.begin(), part.end()));
+        }
+        return res;
+    }
+
     void clear() override {
         set.clear();
     }
@@ -396,8 +443,24 @@ using comparator = typename ram::index_utils::get_full_index<Arity>::type::compa
  */
 template <std::size_t Arity>
 class BTreeIndex : public GenericIndex<btree_set<ram::Tuple<RamDomain, Arity>, comparator<Arity>>> {
+    using Base = GenericIndex<btree_set<ram::Tuple<RamDomain, Arity>, comparator<Arity>>>;
+    using Entry = typename Base::Entry;
+
 public:
-    using GenericIndex<btree_set<ram::Tuple<RamDomain, Arity>, comparator<Arity>>>::GenericIndex;
+    using Base::GenericIndex;
+    using Base::insert;
+
+    void insert(const LVMIndex& src) override {
+        // sort the tuples of the source in the order of this index, such that
+        // the B-tree can merge them with its elements in a single pass
+        std::vector<Entry> entries;
+        entries.reserve(src.size());
+        for (const auto& cur : src.scan()) {
+            entries.push_back(this->order.encode(cur.template asTuple<Arity>()));
+        }
+        std::sort(entries.begin(), entries.end());
+        this->data.insertSorted(entries.begin(), entries.end());
+    }
 };
 
 /**
@@ -362,6 +362,27 @@ public:
      */
     virtual Stream range(const TupleRef& low, const TupleRef& high) const = 0;
 
+    /**
+     * Returns a list of streams jointly covering the entire index content,
+     * which may be traversed independently of each other.
+     */
+    virtual std::vector<Stream> partitionScan(size_t chunks) const {
+        std::vector<Stream> res;
+        res.push_back(scan());
+        return res;
+    }
+
+    /**
+     * Returns a list of streams jointly covering the elements between the
+     * given bounds, which may be traversed independently of each other.
+     */
+    virtual std::vector<Stream> partitionRange(
+            const TupleRef& low, const TupleRef& high, size_t chunks) const {
+        std::vector<Stream> res;
+        res.push_back(range(low, high));
+        return res;
+    }
+
     /**
      * Clears the content of this index, turning it empty.
      */
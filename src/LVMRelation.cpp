@@ -59,9 +59,10 @@ bool LVMRelation::insert(const TupleRef& tuple) {
 }
 
 void LVMRelation::insert(const LVMRelation& other) {
-    // TODO: cover this in a smarter way
-    for (const auto& cur : other.scan()) {
-        insert(cur);
+    assert(other.getArity() == arity);
+    // all indexes are sets, so each index can merge all tuples of the other relation
+    for (const auto& cur : indexes) {
+        cur->insert(*other.main);
     }
 }
 
@@ -78,6 +79,16 @@ Stream LVMRelation::range(const size_t& indexPos, const TupleRef& low, const Tup
     return pos->range(low, high);
 }
 
+std::vector<Stream> LVMRelation::partitionScan(size_t chunks) const {
+    return main->partitionScan(chunks);
+}
+
+std::vector<Stream> LVMRelation::partitionRange(
+        const size_t& indexPos, const TupleRef& low, const TupleRef& high, size_t chunks) const {
+    auto& pos = indexes[indexPos];
+    return pos->partitionRange(low, high, chunks);
+}
+
 void LVMRelation::swap(LVMRelation& other) {
     indexes.swap(other.indexes);
 }
@@ -142,6 +153,12 @@ bool LVMEqRelation::insert(const TupleRef& tuple) {
     return true;
 }
 
+void LVMEqRelation::insert(const LVMRelation& other) {
+    for (const auto& cur : other.scan()) {
+        insert(cur);
+    }
+}
+
 std::vector<RamDomain*> LVMEqRelation::extend(const TupleRef& tuple) {
     std::vector<RamDomain*> newTuples;
 
@@ -221,6 +238,12 @@ bool LVMIndirectRelation::insert(const RamDomain* tuple) {
     return this->insert(TupleRef(tuple, arity));
 }
 
+void LVMIndirectRelation::insert(const LVMRelation& other) {
+    for (const auto& cur : other.scan()) {
+        insert(cur);
+    }
+}
+
 void LVMIndirectRelation::purge() {
     blockList.clear();
     for (auto& cur : indexes) {
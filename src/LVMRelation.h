@@ -97,7 +97,7 @@ public:
     /**
      * Add all entries of the given relation to this relation.
      */
-    void insert(const LVMRelation& other);
+    virtual void insert(const LVMRelation& other);
 
     /**
      * Tests whether this relation contains the given tuple.
@@ -114,6 +114,17 @@ public:
      */
     Stream range(const size_t& indexPos, const TupleRef& low, const TupleRef& high) const;
 
+    /**
+     * Obtains a list of streams jointly covering the entire relation.
+     */
+    std::vector<Stream> partitionScan(size_t chunks) const;
+
+    /**
+     * Obtains a list of streams jointly covering the interval between the two given entries.
+     */
+    std::vector<Stream> partitionRange(
+            const size_t& indexPos, const TupleRef& low, const TupleRef& high, size_t chunks) const;
+
     /**
      * Swaps the content of this and the given relation, including the
      * installed indexes.
@@ -203,6 +214,9 @@ public:
     /** Insert tuple */
     bool insert(const TupleRef& tuple) override;
 
+    /** Insert all tuples of a relation, one by one to compute their closure */
+    void insert(const LVMRelation& other) override;
+
     /** Find the new knowledge generated by inserting a tuple */
     std::vector<RamDomain*> extend(const TupleRef& tuple);
 
@@ -222,6 +236,9 @@ public:
 
     bool insert(const RamDomain* tuple) override;
 
+    /** Insert all tuples of a relation, copying them into the blocks of this relation */
+    void insert(const LVMRelation& other) override;
+
     /** Clear all indexes */
     void purge() override;
 
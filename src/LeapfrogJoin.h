@@ -0,0 +1,217 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2019, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file LeapfrogJoin.h
+ *
+ * Multi-way intersection of sorted index ranges (leapfrog join), the
+ * building block of worst-case optimal joins of the interpreters and of
+ * synthesized programs.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "RamTypes.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+namespace souffle {
+
+/**
+ * A cursor over the distinct values of a column within a sorted range of tuples.
+ */
+class LeapfrogCursor {
+public:
+    virtual ~LeapfrogCursor() = default;
+
+    /** Checks whether all values have been visited */
+    virtual bool atEnd() const = 0;
+
+    /** Obtains the current value; the cursor must not be at its end */
+    virtual RamDomain getValue() const = 0;
+
+    /** Moves the cursor to the first value not less than the given value */
+    virtual void seek(RamDomain value) = 0;
+
+    /** Moves the cursor to the next distinct value */
+    void next() {
+        const RamDomain cur = getValue();
+        if (cur == MAX_RAM_DOMAIN) {
+            seekEnd();
+        } else {
+            seek(cur + 1);
+        }
+    }
+
+protected:
+    /** Moves the cursor to its end */
+    virtual void seekEnd() = 0;
+};
+
+/**
+ * A cursor over the values of a column within a range of a b-tree index, whose order
+ * is required to lead with the columns fixed for the range, followed by the column.
+ *
+ * Seeking a value probes the following tuple before searching the index from its root,
+ * such that dense intersections are processed in linear time.
+ *
+ * @tparam Iter ... the iterator type of the index, dereferencing to indexable tuples
+ * @tparam Key ... the type of search keys, supporting the subscript operator
+ * @tparam LowerBound ... the type of the function obtaining the lower bound of a key
+ */
+template <typename Iter, typename Key, typename LowerBound>
+class BTreeLeapfrogCursor : public LeapfrogCursor {
+    /** The current position and the end of the range */
+    Iter cur;
+    Iter end;
+
+    /** The search key, holding the fixed columns and the minimum value of all other columns */
+    Key low;
+
+    /** The column of the enumerated values */
+    std::size_t column;
+
+    /** The lower bound operation of the index */
+    LowerBound lowerBound;
+
+public:
+    BTreeLeapfrogCursor(Iter begin, Iter end, Key low, std::size_t column, LowerBound lowerBound)
+            : cur(std::move(begin)), end(std::move(end)), low(std::move(low)), column(column),
+              lowerBound(std::move(lowerBound)) {}
+
+    bool atEnd() const override {
+        return !(cur != end);
+    }
+
+    RamDomain getValue() const override {
+        return (*cur)[column];
+    }
+
+    void seek(RamDomain value) override {
+        if (atEnd() || getValue() >= value) {
+            return;
+        }
+
+        // probe the following tuple first
+        ++cur;
+        if (atEnd() || getValue() >= value) {
+            return;
+        }
+
+        // otherwise search from the root of the index
+        low[column] = value;
+        cur = lowerBound(low);
+    }
+
+protected:
+    void seekEnd() override {
+        cur = end;
+    }
+};
+
+/**
+ * A factory function for cursors over b-tree indexes, deducing the template parameters.
+ */
+template <typename Iter, typename Key, typename LowerBound>
+BTreeLeapfrogCursor<Iter, Key, LowerBound> makeLeapfrogCursor(
+        Iter begin, Iter end, Key low, std::size_t column, LowerBound lowerBound) {
+    return BTreeLeapfrogCursor<Iter, Key, LowerBound>(
+            std::move(begin), std::move(end), std::move(low), column, std::move(lowerBound));
+}
+
+/**
+ * Enumerates the values common to all given cursors in ascending order, as described in
+ *
+ * "Leapfrog Triejoin: A Simple, Worst-Case Optimal Join Algorithm", T. L. Veldhuizen, ICDT 2014
+ *
+ * The cursors are advanced in a round-robin fashion, each seeking the largest value
+ * found so far, until all cursors agree on a value.
+ *
+ * Usage:
+ *      for (LeapfrogJoin join({&a, &b}); !join.atEnd(); join.next()) {
+ *          ... join.getValue() ...
+ *      }
+ */
+class LeapfrogJoin {
+    /** The intersected cursors */
+    std::vector<LeapfrogCursor*> cursors;
+
+    /** The position of the cursor to be advanced next */
+    std::size_t pos = 0;
+
+    /** Whether all common values have been enumerated */
+    bool end = false;
+
+public:
+    LeapfrogJoin(std::initializer_list<LeapfrogCursor*> cursors)
+            : LeapfrogJoin(std::vector<LeapfrogCursor*>(cursors)) {}
+
+    LeapfrogJoin(std::vector<LeapfrogCursor*> cursors) : cursors(std::move(cursors)) {
+        for (const LeapfrogCursor* cur : this->cursors) {
+            if (cur->atEnd()) {
+                end = true;
+                return;
+            }
+        }
+        end = this->cursors.empty();
+        if (end) {
+            return;
+        }
+        std::sort(this->cursors.begin(), this->cursors.end(),
+                [](const LeapfrogCursor* a, const LeapfrogCursor* b) { return a->getValue() < b->getValue(); });
+        search();
+    }
+
+    /** Checks whether all common values have been enumerated */
+    bool atEnd() const {
+        return end;
+    }
+
+    /** Obtains the current common value */
+    RamDomain getValue() const {
+        return cursors[pos]->getValue();
+    }
+
+    /** Moves to the next common value */
+    void next() {
+        cursors[pos]->next();
+        if (cursors[pos]->atEnd()) {
+            end = true;
+            return;
+        }
+        pos = (pos + 1) % cursors.size();
+        search();
+    }
+
+private:
+    /** Advances the cursors until all of them agree on a value, starting at the current position */
+    void search() {
+        RamDomain max = cursors[(pos + cursors.size() - 1) % cursors.size()]->getValue();
+        while (true) {
+            LeapfrogCursor* cur = cursors[pos];
+            if (cur->getValue() == max) {
+                return;
+            }
+            cur->seek(max);
+            if (cur->atEnd()) {
+                end = true;
+                return;
+            }
+            max = cur->getValue();
+            pos = (pos + 1) % cursors.size();
+        }
+    }
+};
+
+}  // end of namespace souffle
@@ -54,6 +54,13 @@ public:
         return line.str();
     }
 
+    static const std::string sRelationStatistics(const std::string& relationName) {
+        const char* messageType = "@relation-statistics";
+        std::stringstream line;
+        line << messageType << ";" << relationName << ";";
+        return line.str();
+    }
+
     static const std::string tNonrecursiveRule(
             const std::string& relationName, const SrcLocation& srcLocation, const std::string& datalogText) {
         const char* messageType = "@t-nonrecursive-rule";
@@ -88,6 +95,15 @@ public:
         return line.str();
     }
 
+    static const std::string vRecursiveRule(const std::string& relationName, const int version,
+            const SrcLocation& srcLocation, const std::string& datalogText) {
+        const char* messageType = "@v-recursive-rule";
+        std::stringstream line;
+        line << messageType << ";" << relationName << ";" << version << ";" << srcLocation << ";"
+             << datalogText << ";";
+        return line.str();
+    }
+
     static const std::string tRecursiveRelation(
             const std::string& relationName, const SrcLocation& srcLocation) {
         const char* messageType = "@t-recursive-relation";
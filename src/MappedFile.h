@@ -0,0 +1,91 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2019, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file MappedFile.h
+ *
+ * A read-only memory mapping of a file
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace souffle {
+
+/**
+ * A file mapped read-only into memory, unmapped on destruction.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        if (data != nullptr) {
+            munmap(data, length);
+        }
+    }
+
+    /**
+     * Map the given file into memory.
+     *
+     * @return false if the file cannot be opened
+     */
+    bool open(const std::string& fileName) {
+        int fd = ::open(fileName.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat status;
+        if (fstat(fd, &status) != 0) {
+            close(fd);
+            return false;
+        }
+        length = status.st_size;
+        if (length > 0) {
+            data = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                data = nullptr;
+                close(fd);
+                throw std::invalid_argument("Cannot map file " + fileName + "\n");
+            }
+        }
+        close(fd);
+        return true;
+    }
+
+    const char* begin() const {
+        return static_cast<const char*>(data);
+    }
+
+    const char* end() const {
+        return begin() + length;
+    }
+
+    size_t size() const {
+        return length;
+    }
+
+private:
+    void* data = nullptr;
+    size_t length = 0;
+};
+
+}  // end of namespace souffle
@@ -16,11 +16,15 @@
 
 #pragma once
 
+#include "Util.h"
+
 #include <cassert>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <set>
 #include <stdexcept>
+#include <string>
 #include <vector>
 
 #include <mpi.h>
@@ -152,9 +156,9 @@ inline void pack<std::vector<std::string>>(
     int position = 0;
     MPI_Pack(&first[0], (int)first.size(), firstType, &newData[0], (int)newData.capacity(), &position,
             MPI_COMM_WORLD);
-    MPI_Pack(&second[0], (int)second.size(), secondType, &newData[0], (int)newData.capacity(), &position,
+    MPI_Pack(second.data(), (int)second.size(), secondType, &newData[0], (int)newData.capacity(), &position,
             MPI_COMM_WORLD);
-    MPI_Pack(&last[0], (int)last.size(), lastType, &newData[0], (int)newData.capacity(), &position,
+    MPI_Pack(last.data(), (int)last.size(), lastType, &newData[0], (int)newData.capacity(), &position,
             MPI_COMM_WORLD);
 }
 }  // namespace
@@ -173,11 +177,11 @@ inline void unpack<std::vector<std::string>>(
     MPI_Unpack(&oldData[0], (int)oldData.size(), &position, &first[0], (int)first.capacity(), datatype<int>(),
             MPI_COMM_WORLD);
     std::vector<int> second((size_t)first.at(0));
-    MPI_Unpack(&oldData[0], (int)oldData.size(), &position, &second[0], (int)second.capacity(),
+    MPI_Unpack(&oldData[0], (int)oldData.size(), &position, second.data(), (int)second.capacity(),
             datatype<int>(), MPI_COMM_WORLD);
     std::vector<char> last(oldData.size() - position);
-    MPI_Unpack(&oldData[0], (int)oldData.size(), &position, &last[0], (int)last.capacity(), datatype<char>(),
-            MPI_COMM_WORLD);
+    MPI_Unpack(&oldData[0], (int)oldData.size(), &position, last.data(), (int)last.capacity(),
+            datatype<char>(), MPI_COMM_WORLD);
     auto from = last.begin();
     for (auto length : second) {
         auto to = from + length;
@@ -466,5 +470,132 @@ inline void recv(T& data, const size_t length, Status& status) {
     }
 }
 }  // namespace
+
+/* replicated evaluation, where every process holds all relations and a share of their deltas */
+namespace {
+
+/** Obtains the process owning the given tuple of the given length, as determined by its hash value. */
+template <typename T>
+inline int owner(const T& tuple, const size_t length, const int size) {
+    return (int)(hashTuple(tuple, length) % (uint64_t)size);
+}
+
+/** Retains only the tuples of the given relation owned by the current process. */
+template <typename R, typename T>
+inline void partition(T& data, const size_t length) {
+    const int size = commSize();
+    // nullary relations hold at most one tuple, which is kept by every process
+    if (size == 1 || length == 0) {
+        return;
+    }
+    const int rank = commRank();
+    std::vector<R> owned;
+    for (const auto& tuple : data) {
+        if (owner(tuple, length, size) == rank) {
+            for (size_t i = 0; i < length; ++i) {
+                owned.push_back(tuple[i]);
+            }
+        }
+    }
+    data.purge();
+    for (size_t i = 0; i < owned.size(); i += length) {
+        data.insert(&owned[i]);
+    }
+}
+
+/** Extends the given relation of each process by the tuples of the relation of all other processes. */
+template <typename R, typename T>
+inline void allGather(T& data, const size_t length) {
+    const int size = commSize();
+    if (size == 1) {
+        return;
+    }
+    // a nullary relation is encoded by a single element if it is not empty
+    const size_t width = (length > 0) ? length : 1;
+    std::vector<R> local;
+    if (length > 0) {
+        for (const auto& tuple : data) {
+            for (size_t i = 0; i < length; ++i) {
+                local.push_back(tuple[i]);
+            }
+        }
+    } else if (!data.empty()) {
+        local.push_back(R());
+    }
+    int count = (int)local.size();
+    std::vector<int> counts((size_t)size);
+    MPI_Allgather(&count, 1, datatype<int>(), &counts[0], 1, datatype<int>(), MPI_COMM_WORLD);
+    std::vector<int> displacements((size_t)size, 0);
+    for (size_t i = 1; i < (size_t)size; ++i) {
+        displacements[i] = displacements[i - 1] + counts[i - 1];
+    }
+    std::vector<R> global((size_t)(displacements.back() + counts.back()) + 1);
+    MPI_Allgatherv(local.data(), count, datatype<R>(), &global[0], &counts[0], &displacements[0],
+            datatype<R>(), MPI_COMM_WORLD);
+    const int rank = commRank();
+    for (int source = 0; source < size; ++source) {
+        if (source == rank) {
+            continue;
+        }
+        const size_t end = (size_t)(displacements[source] + counts[source]);
+        for (size_t i = (size_t)displacements[source]; i < end; i += width) {
+            data.insert(&global[i]);
+        }
+    }
+}
+
+/** Copies the tuples of the given relation of the root process to the relations of all other processes. */
+template <typename R, typename T>
+inline void broadcast(T& data, const size_t length, const int root) {
+    const size_t width = (length > 0) ? length : 1;
+    std::vector<R> tuples;
+    const bool isRoot = commRank() == root;
+    if (isRoot) {
+        if (length > 0) {
+            for (const auto& tuple : data) {
+                for (size_t i = 0; i < length; ++i) {
+                    tuples.push_back(tuple[i]);
+                }
+            }
+        } else if (!data.empty()) {
+            tuples.push_back(R());
+        }
+    }
+    int count = (int)tuples.size();
+    MPI_Bcast(&count, 1, datatype<int>(), root, MPI_COMM_WORLD);
+    tuples.resize((size_t)count + 1);
+    MPI_Bcast(&tuples[0], count, datatype<R>(), root, MPI_COMM_WORLD);
+    if (!isRoot) {
+        for (size_t i = 0; i < (size_t)count; i += width) {
+            data.insert(&tuples[i]);
+        }
+    }
+}
+
+/** Copies the given strings of the root process to all other processes. */
+inline void broadcast(std::vector<std::string>& data, const int root) {
+    std::vector<char> buffer;
+    const bool isRoot = commRank() == root;
+    if (isRoot) {
+        pack(data, buffer);
+    }
+    int count = (int)buffer.size();
+    MPI_Bcast(&count, 1, datatype<int>(), root, MPI_COMM_WORLD);
+    buffer.resize((size_t)count);
+    MPI_Bcast(&buffer[0], count, datatype<char>(), root, MPI_COMM_WORLD);
+    if (!isRoot) {
+        data.clear();
+        unpack(buffer, data);
+    }
+}
+
+/** Obtains the minimum of the given values of all processes. */
+template <typename T>
+inline T allMin(const T& value) {
+    T result;
+    MPI_Allreduce(&value, &result, 1, datatype<T>(), MPI_MIN, MPI_COMM_WORLD);
+    return result;
+}
+}  // namespace
 }  // end of namespace mpi
 }  // end of namespace souffle
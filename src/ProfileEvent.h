@@ -18,6 +18,7 @@
 
 #include "EventProcessor.h"
 #include "ProfileDatabase.h"
+#include "ProfileLog.h"
 #include "Util.h"
 #include <atomic>
 #include <cassert>
@@ -27,6 +28,7 @@
 #include <iomanip>
 #include <iostream>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <sstream>
 #include <string>
@@ -46,6 +48,15 @@ class ProfileEventSingleton {
     profile::ProfileDatabase database;
     std::string filename{""};
 
+    /** log receiving the events while an output file is set, instead of the database */
+    std::unique_ptr<profile::ProfileLogWriter> log;
+
+    /** reader replaying the events of a log in the database */
+    profile::ProfileLogReader logReader;
+
+    /** protects the log reader and the database while it is replayed */
+    std::mutex logMutex;
+
     ProfileEventSingleton() = default;
 
 public:
@@ -62,6 +73,10 @@ public:
 
     /** create config record */
     void makeConfigRecord(const std::string& key, const std::string& value) {
+        if (log) {
+            log->log(profile::LogEventKind::Config, "@config", {key, value}, {});
+            return;
+        }
         profile::EventProcessorSingleton::instance().process(database, "@config", key.c_str(), value.c_str());
     }
 
@@ -70,13 +85,21 @@ public:
             const std::string& key, const std::string& value) {
         std::stringstream ss;
         ss << "@text;stratum;" << index << ';' << type << ';' << relName << ';' << key;
+        if (log) {
+            log->log(profile::LogEventKind::Text, ss.str(), {value}, {});
+            return;
+        }
         profile::EventProcessorSingleton::instance().process(database, ss.str().c_str(), value.c_str());
     }
 
     /** create time event */
     void makeTimeEvent(const std::string& txt) {
-        profile::EventProcessorSingleton::instance().process(
-                database, txt.c_str(), std::chrono::duration_cast<microseconds>(now().time_since_epoch()));
+        microseconds time = std::chrono::duration_cast<microseconds>(now().time_since_epoch());
+        if (log) {
+            log->log(profile::LogEventKind::Time, txt, {}, {time.count()});
+            return;
+        }
+        profile::EventProcessorSingleton::instance().process(database, txt.c_str(), time);
     }
 
     /** create an event for recording start and end times */
@@ -84,12 +107,22 @@ public:
             size_t endMaxRSS, size_t size, size_t iteration) {
         microseconds start_ms = std::chrono::duration_cast<microseconds>(start.time_since_epoch());
         microseconds end_ms = std::chrono::duration_cast<microseconds>(end.time_since_epoch());
+        if (log) {
+            log->log(profile::LogEventKind::Timing, txt, {},
+                    {start_ms.count(), end_ms.count(), int64_t(startMaxRSS), int64_t(endMaxRSS),
+                            int64_t(size), int64_t(iteration)});
+            return;
+        }
         profile::EventProcessorSingleton::instance().process(
                 database, txt.c_str(), start_ms, end_ms, startMaxRSS, endMaxRSS, size, iteration);
     }
 
     /** create quantity event */
     void makeQuantityEvent(const std::string& txt, size_t number, int iteration) {
+        if (log) {
+            log->log(profile::LogEventKind::Quantity, txt, {}, {int64_t(number), iteration});
+            return;
+        }
         profile::EventProcessorSingleton::instance().process(database, txt.c_str(), number, iteration);
     }
 
@@ -107,16 +140,42 @@ public:
         /* Maximum resident set size (kb) */
         size_t maxRSS = ru.ru_maxrss;
 
+        if (log) {
+            log->log(profile::LogEventKind::Utilisation, txt, {},
+                    {time.count(), int64_t(systemTime), int64_t(userTime), int64_t(maxRSS)});
+            return;
+        }
         profile::EventProcessorSingleton::instance().process(
                 database, txt.c_str(), time, systemTime, userTime, maxRSS);
     }
 
+    /**
+     * Streams all following events to a profile log, such that the events are neither retained
+     * in memory nor processed by the program; the log is read back by the profiler. Files with
+     * the extension .json receive the profile database in JSON format instead.
+     */
     void setOutputFile(std::string filename) {
+        std::lock_guard<std::mutex> guard(logMutex);
         this->filename = filename;
+        log.reset();
+        if (filename.empty() || endsWith(filename, ".json")) {
+            return;
+        }
+        log = std::make_unique<profile::ProfileLogWriter>(filename);
+        if (!log->isOpen()) {
+            std::cerr << "Cannot open profile log file <" + filename + ">";
+            log.reset();
+            this->filename.clear();
+            return;
+        }
+        logReader = profile::ProfileLogReader(filename);
     }
+
     /** Dump all events */
     void dump() {
-        if (!filename.empty()) {
+        if (log) {
+            log->close();
+        } else if (!filename.empty()) {
             std::ofstream os(filename);
             if (!os.is_open()) {
                 std::cerr << "Cannot open profile log file <" + filename + ">";
@@ -143,8 +202,24 @@ public:
         return database;
     }
 
+    /** Reads a profile log or a profile database in JSON format */
     void setDBFromFile(const std::string& filename) {
-        database = profile::ProfileDatabase(filename);
+        std::lock_guard<std::mutex> guard(logMutex);
+        if (!profile::ProfileLogReader::isLog(filename)) {
+            database = profile::ProfileDatabase(filename);
+            return;
+        }
+        database = profile::ProfileDatabase();
+        logReader = profile::ProfileLogReader(filename);
+        logReader.read(database);
+    }
+
+    /** Replays the events appended to the profile log since the last update, e.g. by a running program */
+    void update() {
+        std::lock_guard<std::mutex> guard(logMutex);
+        if (logReader.isOpen()) {
+            logReader.read(database);
+        }
     }
 
 private:
@@ -0,0 +1,351 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2019, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ProfileLog.h
+ *
+ * Streaming binary log of profile events
+ *
+ * A profile log starts with a magic number, followed by the events in the
+ * order of their occurrence. Each event consists of its kind (one byte), its
+ * event text, the strings and the 64-bit integers of its kind, where strings
+ * are stored by their length (32 bit) and their characters. Integers are
+ * stored in the byte order of the host.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "EventProcessor.h"
+#include "ProfileDatabase.h"
+
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace souffle {
+namespace profile {
+
+/** The kinds of profile events, determining the arguments passed to their event processors */
+enum class LogEventKind : uint8_t {
+    /** a string */
+    Text,
+    /** a key and a value */
+    Config,
+    /** a point in time */
+    Time,
+    /** start and end time, start and end resident set size, size and iteration */
+    Timing,
+    /** a number and an iteration */
+    Quantity,
+    /** a point in time, system and user time, and the resident set size */
+    Utilisation
+};
+
+/** The number of strings and integers of events of each kind */
+inline std::pair<size_t, size_t> getLogEventShape(LogEventKind kind) {
+    static const std::array<std::pair<size_t, size_t>, 6> shapes{
+            {{1, 0}, {2, 0}, {0, 1}, {0, 6}, {0, 2}, {0, 4}}};
+    return shapes[static_cast<size_t>(kind)];
+}
+
+/** The magic number of profile logs */
+inline const std::string& getLogMagic() {
+    static const std::string magic("SFPLOG01");
+    return magic;
+}
+
+/**
+ * Appends profile events to a log file.
+ *
+ * Events are encoded into a ring of blocks, which a background thread writes to
+ * the file once they are full or have been pending for the flush interval. The
+ * memory of the log is bounded by the ring; events wait for a free block if the
+ * file cannot keep up.
+ */
+class ProfileLogWriter {
+public:
+    /**
+     * Opens a log file
+     *
+     * @param blockSize ... the size in bytes of blocks written at once
+     * @param numBlocks ... the number of blocks of the ring
+     * @param flushInterval ... the time after which pending events are written
+     */
+    ProfileLogWriter(const std::string& filename, size_t blockSize = 1 << 20, size_t numBlocks = 8,
+            std::chrono::milliseconds flushInterval = std::chrono::milliseconds(100))
+            : file(filename, std::ios::binary | std::ios::trunc), blockSize(blockSize), blocks(numBlocks),
+              flushInterval(flushInterval) {
+        if (!file.is_open()) {
+            return;
+        }
+        file.write(getLogMagic().data(), getLogMagic().size());
+        for (auto& block : blocks) {
+            block.reserve(blockSize);
+        }
+        writer = std::thread([this]() { write(); });
+    }
+
+    ~ProfileLogWriter() {
+        close();
+    }
+
+    /** Checks whether the log file could be opened */
+    bool isOpen() const {
+        return writer.joinable();
+    }
+
+    /** Appends an event; events are ignored once the log is closed */
+    void log(LogEventKind kind, const std::string& txt, std::initializer_list<std::string> strings,
+            std::initializer_list<int64_t> values) {
+        assert(getLogEventShape(kind) == std::make_pair(strings.size(), values.size()) &&
+                "event does not match its kind");
+        size_t size = 1 + sizeof(uint32_t) + txt.size() + values.size() * sizeof(int64_t);
+        for (const auto& str : strings) {
+            size += sizeof(uint32_t) + str.size();
+        }
+
+        std::unique_lock<std::mutex> guard(lock);
+        space.wait(guard, [&]() { return closing || sealed < blocks.size(); });
+        if (!blocks[head].empty() && blocks[head].size() + size > blockSize) {
+            seal();
+            space.wait(guard, [&]() { return closing || sealed < blocks.size(); });
+        }
+        // events after closing the log are dropped, as the writer no longer frees blocks
+        if (closing) {
+            return;
+        }
+        std::vector<char>& block = blocks[head];
+        block.push_back(static_cast<char>(kind));
+        appendString(block, txt);
+        for (const auto& str : strings) {
+            appendString(block, str);
+        }
+        for (int64_t value : values) {
+            append(block, &value, sizeof(value));
+        }
+    }
+
+    /** Writes all pending events and closes the file */
+    void close() {
+        if (!writer.joinable()) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            closing = true;
+        }
+        filled.notify_one();
+        space.notify_all();
+        writer.join();
+        file.close();
+    }
+
+private:
+    static void append(std::vector<char>& block, const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        block.insert(block.end(), bytes, bytes + size);
+    }
+
+    static void appendString(std::vector<char>& block, const std::string& str) {
+        uint32_t length = str.size();
+        append(block, &length, sizeof(length));
+        append(block, str.data(), str.size());
+    }
+
+    /** Passes the current block to the writer; the lock must be held */
+    void seal() {
+        ++sealed;
+        head = (head + 1) % blocks.size();
+        filled.notify_one();
+    }
+
+    /** Writes sealed blocks until the log is closed, run by the background thread */
+    void write() {
+        std::unique_lock<std::mutex> guard(lock);
+        while (true) {
+            if (sealed == 0) {
+                if (!closing) {
+                    filled.wait_for(guard, flushInterval);
+                }
+                // write pending events of a block that is not yet full
+                if (sealed == 0 && !blocks[head].empty()) {
+                    seal();
+                }
+                if (sealed == 0) {
+                    if (closing) {
+                        break;
+                    }
+                    continue;
+                }
+            }
+
+            // the producers do not access sealed blocks, such that the file is written without the lock
+            std::vector<char>& block = blocks[tail];
+            guard.unlock();
+            file.write(block.data(), block.size());
+            file.flush();
+            block.clear();
+            guard.lock();
+            tail = (tail + 1) % blocks.size();
+            --sealed;
+            space.notify_all();
+        }
+    }
+
+    /** The log file */
+    std::ofstream file;
+
+    /** The size of a block written at once */
+    const size_t blockSize;
+
+    /** The ring of blocks */
+    std::vector<std::vector<char>> blocks;
+
+    /** The block receiving events */
+    size_t head = 0;
+
+    /** The next block to be written */
+    size_t tail = 0;
+
+    /** The number of blocks to be written */
+    size_t sealed = 0;
+
+    /** Whether the log is being closed */
+    bool closing = false;
+
+    /** The time after which pending events are written */
+    const std::chrono::milliseconds flushInterval;
+
+    /** Protects the ring */
+    std::mutex lock;
+
+    /** Signals the writer that a block has been sealed */
+    std::condition_variable filled;
+
+    /** Signals the producers that a block has been written */
+    std::condition_variable space;
+
+    /** The background thread writing the blocks */
+    std::thread writer;
+};
+
+/**
+ * Reads a profile log incrementally into a profile database.
+ *
+ * Each read replays the events appended to the log since the previous read,
+ * such that the log of a running program can be followed.
+ */
+class ProfileLogReader {
+public:
+    ProfileLogReader() = default;
+
+    ProfileLogReader(std::string filename) : filename(std::move(filename)), offset(getLogMagic().size()) {}
+
+    /** Checks whether a file is a profile log */
+    static bool isLog(const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary);
+        std::string magic(getLogMagic().size(), '\0');
+        return file.read(&magic[0], magic.size()).good() && magic == getLogMagic();
+    }
+
+    /** Checks whether the reader follows a log */
+    bool isOpen() const {
+        return !filename.empty();
+    }
+
+    /** Replays the complete events appended since the previous read in the database */
+    void read(ProfileDatabase& db) {
+        std::ifstream file(filename, std::ios::binary);
+        file.seekg(offset);
+        std::string txt;
+        std::vector<std::string> strings;
+        std::vector<int64_t> values;
+        char kind;
+        while (file.get(kind) && readString(file, txt)) {
+            // a corrupt or foreign log is read up to its first unknown event
+            if (static_cast<uint8_t>(kind) > static_cast<uint8_t>(LogEventKind::Utilisation)) {
+                break;
+            }
+            auto shape = getLogEventShape(static_cast<LogEventKind>(kind));
+            strings.resize(shape.first);
+            values.resize(shape.second);
+            bool complete = true;
+            for (auto& str : strings) {
+                complete = complete && readString(file, str);
+            }
+            for (auto& value : values) {
+                complete = complete && file.read(reinterpret_cast<char*>(&value), sizeof(value)).good();
+            }
+            // the remainder of an event is read once it has been written
+            if (!complete) {
+                break;
+            }
+            replay(db, static_cast<LogEventKind>(kind), txt, strings, values);
+            offset = file.tellg();
+        }
+    }
+
+private:
+    static bool readString(std::ifstream& file, std::string& str) {
+        uint32_t length;
+        if (!file.read(reinterpret_cast<char*>(&length), sizeof(length))) {
+            return false;
+        }
+        str.resize(length);
+        return length == 0 || file.read(&str[0], length).good();
+    }
+
+    /** Passes an event to its processor with the arguments of ProfileEventSingleton */
+    static void replay(ProfileDatabase& db, LogEventKind kind, const std::string& txt,
+            const std::vector<std::string>& strings, const std::vector<int64_t>& values) {
+        using std::chrono::microseconds;
+        auto& processor = EventProcessorSingleton::instance();
+        switch (kind) {
+            case LogEventKind::Text:
+                processor.process(db, txt.c_str(), strings[0].c_str());
+                break;
+            case LogEventKind::Config:
+                processor.process(db, txt.c_str(), strings[0].c_str(), strings[1].c_str());
+                break;
+            case LogEventKind::Time:
+                processor.process(db, txt.c_str(), microseconds(values[0]));
+                break;
+            case LogEventKind::Timing:
+                processor.process(db, txt.c_str(), microseconds(values[0]), microseconds(values[1]),
+                        size_t(values[2]), size_t(values[3]), size_t(values[4]), size_t(values[5]));
+                break;
+            case LogEventKind::Quantity:
+                processor.process(db, txt.c_str(), size_t(values[0]), int(values[1]));
+                break;
+            case LogEventKind::Utilisation:
+                processor.process(db, txt.c_str(), microseconds(values[0]), uint64_t(values[1]),
+                        uint64_t(values[2]), size_t(values[3]));
+                break;
+        }
+    }
+
+    /** The log file */
+    std::string filename;
+
+    /** The position of the first event not yet read */
+    std::streamoff offset = 0;
+};
+
+}  // namespace profile
+}  // namespace souffle
@@ -21,6 +21,7 @@
 #include "Global.h"
 #include "IODirectives.h"
 #include "IOSystem.h"
+#include "LeapfrogJoin.h"
 #include "Logger.h"
 #include "ParallelUtils.h"
 #include "ProfileEvent.h"
@@ -32,12 +33,14 @@
 #include "RamOperation.h"
 #include "RamProgram.h"
 #include "RamVisitor.h"
+#include "RelationStats.h"
 #include "ReadStream.h"
 #include "SignalHandler.h"
 #include "SymbolTable.h"
 #include "Util.h"
 #include "WriteStream.h"
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
@@ -454,11 +457,68 @@ bool RAMI::evalCond(const RamCondition& cond, const RAMIContext& ctxt) {
 /** Evaluate RAM operation */
 void RAMI::evalOp(const RamOperation& op, const RAMIContext& args) {
     class OperationEvaluator : public RamVisitor<bool> {
+        /** Tuples projected by a partition of a parallel operation, grouped by target relation */
+        using InsertBuffer = std::map<RAMIRelation*, std::pair<size_t, std::vector<RamDomain>>>;
+
         RAMI& interpreter;
         RAMIContext& ctxt;
 
+        /** Buffer for projected tuples; if not set, tuples are inserted immediately */
+        InsertBuffer* buffer;
+
     public:
-        OperationEvaluator(RAMI& interp, RAMIContext& ctxt) : interpreter(interp), ctxt(ctxt) {}
+        OperationEvaluator(RAMI& interp, RAMIContext& ctxt, InsertBuffer* buffer = nullptr)
+                : interpreter(interp), ctxt(ctxt), buffer(buffer) {}
+
+        /**
+         * Evaluate the nested operation of an outer-most loop for each partition in parallel.
+         *
+         * Relations are not modified while the partitions are processed; instead each
+         * partition buffers its projected tuples, which are merged into the target
+         * relations in partition order afterwards.
+         */
+        bool evalPartitions(const RamRelationOperation& op, const std::vector<RAMIIndex::chunk>& parts) {
+            std::vector<InsertBuffer> buffers(parts.size());
+
+#pragma omp parallel for schedule(dynamic)
+            for (size_t i = 0; i < parts.size(); i++) {  // NOLINT (modernize-loop-convert)
+                RAMIContext partCtxt;
+                partCtxt.setReturnValues(ctxt.getReturnValues());
+                partCtxt.setReturnErrors(ctxt.getReturnErrors());
+                partCtxt.setArguments(ctxt.getArguments());
+                OperationEvaluator partEval(interpreter, partCtxt, &buffers[i]);
+                for (const RamDomain* cur : parts[i]) {
+                    partCtxt[op.getTupleId()] = cur;
+                    if (!partEval.visitTupleOperation(op)) {
+                        break;
+                    }
+                }
+            }
+
+            // merge buffered tuples into target relations
+            for (auto& partBuffer : buffers) {
+                for (auto& cur : partBuffer) {
+                    RAMIRelation& rel = *cur.first;
+                    const auto arity = rel.getArity();
+                    const RamDomain* data = cur.second.second.data();
+                    for (size_t j = 0; j < cur.second.first; j++) {
+                        rel.insert(data + j * arity);
+                    }
+                }
+            }
+            return true;
+        }
+
+        /** Check whether an outer-most loop can be partitioned across threads */
+        bool isPartitionable(const RamRelationOperation& op) {
+            if (op.getRelation().getArity() == 0 || buffer != nullptr) {
+                return false;
+            }
+            // subroutines return values in evaluation order
+            bool hasReturn = false;
+            visitDepthFirst(op, [&](const RamSubroutineReturnValue&) { hasReturn = true; });
+            return !hasReturn;
+        }
 
         // -- Operations -----------------------------
 
@@ -470,6 +530,7 @@ void RAMI::evalOp(const RamOperation& op, const RAMIContext& args) {
             bool result = visitNestedOperation(search);
 
             if (Global::config().has("profile") && !search.getProfileText().empty()) {
+#pragma omp critical(RAMIFrequencies)
                 interpreter.frequencies[search.getProfileText()][interpreter.getIterationNumber()]++;
             }
             return result;
@@ -489,6 +550,16 @@ void RAMI::evalOp(const RamOperation& op, const RAMIContext& args) {
             return true;
         }
 
+        bool visitParallelScan(const RamParallelScan& pscan) override {
+            if (!isPartitionable(pscan)) {
+                return visitScan(pscan);
+            }
+
+            // partition the relation along its total index
+            const RAMIRelation& rel = interpreter.getRelation(pscan.getRelation());
+            return evalPartitions(pscan, rel.getIndex(rel.getTotalIndexKey())->partition());
+        }
+
         bool visitIndexScan(const RamIndexScan& scan) override {
             // get the targeted relation
             const RAMIRelation& rel = interpreter.getRelation(scan.getRelation());
@@ -525,6 +596,78 @@ void RAMI::evalOp(const RamOperation& op, const RAMIContext& args) {
             return true;
         }
 
+        bool visitParallelIndexScan(const RamParallelIndexScan& piscan) override {
+            if (!isPartitionable(piscan)) {
+                return visitIndexScan(piscan);
+            }
+
+            // get the targeted relation
+            const RAMIRelation& rel = interpreter.getRelation(piscan.getRelation());
+
+            // create pattern tuple for range query
+            auto arity = rel.getArity();
+            RamDomain low[arity];
+            RamDomain hig[arity];
+            auto pattern = piscan.getRangePattern();
+            for (size_t i = 0; i < arity; i++) {
+                if (!isRamUndefValue(pattern[i])) {
+                    low[i] = interpreter.evalExpr(*pattern[i], ctxt);
+                    hig[i] = low[i];
+                } else {
+                    low[i] = MIN_RAM_DOMAIN;
+                    hig[i] = MAX_RAM_DOMAIN;
+                }
+            }
+
+            // obtain index
+            auto idx = rel.getIndex(interpreter.isa->getSearchSignature(&piscan));
+
+            // partition the iterator range
+            auto range = idx->lowerUpperBound(low, hig);
+            return evalPartitions(piscan, make_range(range.first, range.second).partition(400));
+        }
+
+        bool visitIntersection(const RamIntersection& intersection) override {
+            const size_t numRelations = intersection.getNumRelations();
+
+            // create a cursor over the range of each relation fixed by the prefix
+            std::vector<std::unique_ptr<LeapfrogCursor>> cursors;
+            for (size_t i = 0; i < numRelations; i++) {
+                const RAMIRelation& rel = interpreter.getRelation(intersection.getRelation(i));
+                RAMIIndex* idx = rel.getIndex(intersection.getLexOrder(i));
+                std::vector<RamDomain> low(rel.getArity(), MIN_RAM_DOMAIN);
+                std::vector<RamDomain> high(rel.getArity(), MAX_RAM_DOMAIN);
+                const auto& order = intersection.getLexOrder(i);
+                const auto prefix = intersection.getPrefix(i);
+                for (size_t j = 0; j < prefix.size(); j++) {
+                    low[order[j]] = high[order[j]] = interpreter.evalExpr(*prefix[j], ctxt);
+                }
+                auto begin = idx->lowerBound(low.data());
+                auto end = idx->upperBound(high.data());
+                auto lowerBound = [idx](const std::vector<RamDomain>& key) {
+                    return idx->lowerBound(key.data());
+                };
+                using cursor_type = decltype(makeLeapfrogCursor(begin, end, low, 0, lowerBound));
+                cursors.push_back(std::make_unique<cursor_type>(
+                        begin, end, std::move(low), intersection.getColumn(i), lowerBound));
+            }
+
+            // enumerate the common values
+            std::vector<LeapfrogCursor*> cursorPtrs;
+            for (const auto& cur : cursors) {
+                cursorPtrs.push_back(cur.get());
+            }
+            RamDomain value;
+            ctxt[intersection.getTupleId()] = &value;
+            for (LeapfrogJoin join(cursorPtrs); !join.atEnd(); join.next()) {
+                value = join.getValue();
+                if (!visitTupleOperation(intersection)) {
+                    break;
+                }
+            }
+            return true;
+        }
+
         bool visitChoice(const RamChoice& choice) override {
             // get the targeted relation
             const RAMIRelation& rel = interpreter.getRelation(choice.getRelation());
@@ -786,6 +929,7 @@ void RAMI::evalOp(const RamOperation& op, const RAMIContext& args) {
             }
 
             if (Global::config().has("profile") && !filter.getProfileText().empty()) {
+#pragma omp critical(RAMIFrequencies)
                 interpreter.frequencies[filter.getProfileText()][interpreter.getIterationNumber()]++;
             }
             return result;
@@ -803,7 +947,13 @@ void RAMI::evalOp(const RamOperation& op, const RAMIContext& args) {
 
             // insert in target relation
             RAMIRelation& rel = interpreter.getRelation(project.getRelation());
-            rel.insert(tuple);
+            if (buffer != nullptr) {
+                auto& pending = (*buffer)[&rel];
+                pending.first++;
+                pending.second.insert(pending.second.end(), tuple, tuple + arity);
+            } else {
+                rel.insert(tuple);
+            }
             return true;
         }
 
@@ -880,10 +1030,49 @@ void RAMI::evalStmt(const RamStatement& stmt, const RAMIContext& args) {
             return cond;
         }
 
+        bool visitAdaptiveQuery(const RamAdaptiveQuery& adaptive) override {
+            // choose the variant of the least cost for the current relation sizes
+            const auto& variants = adaptive.getStatements();
+            size_t chosen = 0;
+            double minCost = 0;
+            for (size_t i = 0; i < variants.size(); i++) {
+                std::vector<std::array<size_t, 3>> scans;
+                for (const auto& scan : adaptive.getScans(i)) {
+                    const RAMIRelation& rel = interpreter.getRelation(*scan.first);
+                    scans.push_back({{rel.size(), rel.getArity(), scan.second}});
+                }
+                double cost = RamAdaptiveQuery::estimateCost(scans);
+                if (i == 0 || cost < minCost) {
+                    chosen = i;
+                    minCost = cost;
+                }
+            }
+
+            if (!adaptive.getMessage().empty()) {
+                ProfileEventSingleton::instance().makeQuantityEvent(
+                        adaptive.getMessage(), chosen, interpreter.getIterationNumber());
+            }
+            return visit(variants[chosen]);
+        }
+
         bool visitLoop(const RamLoop& loop) override {
             interpreter.resetIterationNumber();
             while (visit(loop.getBody())) {
                 interpreter.incIterationNumber();
+                // leave the stratum once the compiled program may take it over
+                if (interpreter.jit) {
+                    interpreter.jit->checkpoint(*interpreter.currentStratum);
+                    if (interpreter.jit->isCompiled(*interpreter.currentStratum)) {
+                        if (Global::config().has("verbose")) {
+                            std::cout << "Stratum " << interpreter.currentStratum->getIndex()
+                                      << " is taken over by the compiled program in iteration "
+                                      << interpreter.getIterationNumber() << std::endl;
+                        }
+                        interpreter.handOver = true;
+                        interpreter.resetIterationNumber();
+                        return false;
+                    }
+                }
             }
             interpreter.resetIterationNumber();
             return true;
@@ -928,7 +1117,27 @@ void RAMI::evalStmt(const RamStatement& stmt, const RAMIContext& args) {
                             stratum.getIndex(), "relation", cur.first, "arity", std::to_string(cur.second));
                 }
             }
-            return visit(stratum.getBody());
+
+            if (!interpreter.jit) {
+                return visit(stratum.getBody());
+            }
+
+            // evaluate hot strata by the compiled program once it is available
+            interpreter.currentStratum = &stratum;
+            interpreter.jit->enter(stratum);
+            if (!interpreter.jit->isCompiled(stratum)) {
+                visit(stratum.getBody());
+                if (!interpreter.handOver) {
+                    interpreter.jit->leave(stratum);
+                    return true;
+                }
+                interpreter.handOver = false;
+            } else if (Global::config().has("verbose")) {
+                std::cout << "Stratum " << stratum.getIndex() << " is evaluated by the compiled program"
+                          << std::endl;
+            }
+            interpreter.executeCompiled(stratum);
+            return true;
         }
 
         bool visitCreate(const RamCreate& create) override {
@@ -955,6 +1164,12 @@ void RAMI::evalStmt(const RamStatement& stmt, const RAMIContext& args) {
             return true;
         }
 
+        bool visitLogStatistics(const RamLogStatistics& stats) override {
+            const RAMIRelation& rel = interpreter.getRelation(stats.getRelation());
+            RelationStats::extractFrom(rel, rel.getArity()).logTo(stats.getMessage());
+            return true;
+        }
+
         bool visitLoad(const RamLoad& load) override {
             for (IODirectives ioDirectives : load.getIODirectives()) {
                 try {
@@ -1053,6 +1268,76 @@ void RAMI::evalStmt(const RamStatement& stmt, const RAMIContext& args) {
     // StatementEvaluator(*this).visit(stmt);
 }
 
+void RAMI::executeCompiled(const RamStratum& stratum) {
+    SouffleProgram& program = jit->getProgram();
+    const JitCompiler::StratumRelations& relations = jit->getRelations(stratum);
+    JitCompiler::syncSymbols(getSymbolTable(), program.getSymbolTable());
+
+    // transfer the relations computed by the interpreter, including those of an interrupted iteration
+    for (const std::string& name : relations.used) {
+        Relation* target = program.getRelation(name);
+        auto pos = environment.find(name);
+        if (target == nullptr || pos == environment.end() || jit->isResident(name)) {
+            continue;
+        }
+        target->purge();
+        for (const RamDomain* cur : *pos->second) {
+            tuple t(target);
+            for (size_t i = 0; i < target->getArity(); ++i) {
+                t[i] = cur[i];
+            }
+            target->insert(t);
+        }
+        jit->setResident(name, true);
+    }
+
+    // evaluate the stratum without prefixing the directories of its inputs and outputs
+    program.runAll("", "", stratum.getIndex());
+    JitCompiler::syncSymbols(program.getSymbolTable(), getSymbolTable());
+
+    // replace the relations of an interrupted evaluation, and release the dropped relations
+    for (const RamRelation* rel : relations.created) {
+        if (environment.find(rel->getName()) != environment.end()) {
+            dropRelation(*rel);
+        }
+    }
+    for (const RamRelation* rel : relations.dropped) {
+        if (environment.find(rel->getName()) != environment.end()) {
+            dropRelation(*rel);
+        }
+        jit->setResident(rel->getName(), false);
+    }
+
+    // transfer the computed relations back to the interpreter
+    for (const RamRelation* rel : relations.created) {
+        const Relation* source = program.getRelation(rel->getName());
+        bool isDropped = std::any_of(relations.dropped.begin(), relations.dropped.end(),
+                [&](const RamRelation* dropped) { return dropped->getName() == rel->getName(); });
+        if (rel->isTemp() || isDropped || source == nullptr) {
+            continue;
+        }
+        createRelation(*rel, &isa->getIndexes(*rel));
+        RAMIRelation& target = getRelation(*rel);
+        const size_t arity = rel->getArity();
+        if (arity == 0) {
+            if (source->size() > 0) {
+                RamDomain unit = 0;
+                target.insert(&unit);
+            }
+        } else {
+            std::vector<RamDomain> buffer;
+            buffer.reserve(source->size() * arity);
+            for (const tuple& cur : *source) {
+                for (size_t i = 0; i < arity; ++i) {
+                    buffer.push_back(cur[i]);
+                }
+            }
+            target.insertBatch(buffer.data(), source->size());
+        }
+        jit->setResident(rel->getName(), true);
+    }
+}
+
 /** Execute main program of a translation unit */
 void RAMI::executeMain() {
     SignalHandler::instance()->set();
@@ -1061,6 +1346,16 @@ void RAMI::executeMain() {
     }
     const RamStatement& main = *translationUnit.getProgram()->getMain();
 
+#ifdef _OPENMP
+    // use the requested number of threads for parallel operations
+    if (Global::config().has("jobs") && isNumber(Global::config().get("jobs").c_str())) {
+        int jobs = std::stoi(Global::config().get("jobs"));
+        if (jobs > 0) {
+            omp_set_num_threads(jobs);
+        }
+    }
+#endif
+
     if (!Global::config().has("profile")) {
         evalStmt(main);
     } else {
@@ -1091,6 +1386,10 @@ void RAMI::executeMain() {
         // Store count of rules
         size_t ruleCount = 0;
         visitDepthFirst(main, [&](const RamQuery& rule) { ++ruleCount; });
+        visitDepthFirst(main, [&](const RamAdaptiveQuery& adaptive) {
+            // only one variant of an adaptive query is executed at a time
+            ruleCount -= adaptive.getStatements().size() - 1;
+        });
         ProfileEventSingleton::instance().makeConfigRecord("ruleCount", std::to_string(ruleCount));
 
         evalStmt(main);
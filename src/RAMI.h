@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "JitCompiler.h"
 #include "RAMIContext.h"
 #include "RAMIInterface.h"
 #include "RAMIRelation.h"
@@ -31,6 +32,7 @@
 #include <cstdlib>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -49,7 +51,8 @@ class SymbolTable;
 
 class RAMI : public RAMIInterface {
 public:
-    RAMI(RamTranslationUnit& tUnit) : RAMIInterface(tUnit) {}
+    RAMI(RamTranslationUnit& tUnit, std::unique_ptr<JitCompiler> jit = nullptr)
+            : RAMIInterface(tUnit), jit(std::move(jit)) {}
     ~RAMI() {
         for (auto& x : environment) {
             delete x.second;
@@ -137,6 +140,12 @@ protected:
         delete &rel;
     }
 
+    /**
+     * Evaluate a stratum by the compiled program of the just-in-time compiler, transferring
+     * the relations it uses and computes between the interpreter and the compiled program
+     */
+    void executeCompiled(const RamStratum& stratum);
+
     /** Swap relation */
     void swapRelation(const RamRelation& ramRel1, const RamRelation& ramRel2) {
         RAMIRelation* rel1 = &getRelation(ramRel1);
@@ -163,13 +172,22 @@ private:
     std::map<std::string, std::atomic<size_t>> reads;
 
     /** counter for $ operator */
-    int counter = 0;
+    std::atomic<int> counter{0};
 
     /** iteration number (in a fix-point calculation) */
     size_t iteration = 0;
 
     /** Relation Environment */
     relation_map environment;
+
+    /** just-in-time compiler of hot strata, if enabled */
+    std::unique_ptr<JitCompiler> jit;
+
+    /** stratum under evaluation */
+    const RamStratum* currentStratum = nullptr;
+
+    /** whether the compiled program takes over the stratum under evaluation at the end of an iteration */
+    bool handOver = false;
 };
 
 }  // end of namespace souffle
@@ -21,6 +21,7 @@
 #include <utility>
 
 #include "BTree.h"
+#include "ParallelUtils.h"
 #include "RamTypes.h"
 #include "Util.h"
 
@@ -72,6 +73,8 @@ public:
 
     using iterator = index_set::iterator;
 
+    using chunk = index_set::chunk;
+
     RAMIIndex(LexOrder order) : theOrder(std::move(order)), set(comparator(theOrder), comparator(theOrder)) {}
 
     RAMIIndex(const RAMIIndex&& index) : theOrder(std::move(index.theOrder)), set(std::move(index.set)) {}
@@ -99,8 +102,23 @@ public:
         set.insert(a, b);
     };
 
+    /**
+     * add tuples sorted with respect to the order of the index
+     *
+     * precondition: the tuples do not exist in the index
+     */
+    template <class Iter>
+    void insertSorted(const Iter& a, const Iter& b) {
+        set.insertSorted(a, b);
+        // the nodes referenced by the hints may have been rebuilt
+        operation_hints.clear();
+    }
+
     /** check whether tuple exists in index */
     bool exists(const RamDomain* value) {
+        if (isShared()) {
+            return set.contains(value);
+        }
         return set.find(value, operation_hints) != set.end();
     }
 
@@ -124,16 +142,52 @@ public:
 
     /** return start and end iterator of a range */
     inline std::pair<iterator, iterator> lowerUpperBound(const RamDomain* low, const RamDomain* high) {
+        if (isShared()) {
+            return std::pair<iterator, iterator>(set.lower_bound(low), set.upper_bound(high));
+        }
         return std::pair<iterator, iterator>(
                 set.lower_bound(low, operation_hints), set.upper_bound(high, operation_hints));
     }
 
+    /** return iterator to the first tuple not less than the given tuple */
+    inline iterator lowerBound(const RamDomain* low) {
+        if (isShared()) {
+            return set.lower_bound(low);
+        }
+        return set.lower_bound(low, operation_hints);
+    }
+
+    /** return iterator to the first tuple greater than the given tuple */
+    inline iterator upperBound(const RamDomain* high) {
+        if (isShared()) {
+            return set.upper_bound(high);
+        }
+        return set.upper_bound(high, operation_hints);
+    }
+
     /** return start and end iterator of the index set */
     inline std::pair<iterator, iterator> getIteratorPair() const {
         return std::pair<iterator, iterator>(set.begin(), set.end());
     }
 
+    /** partition the index set into chunks of roughly equal size for parallel processing */
+    std::vector<chunk> partition() const {
+        return set.getChunks(400);
+    }
+
 private:
+    /**
+     * check whether the index may be accessed by several threads at once; the
+     * operation hints are not synchronized and must not be shared in this case
+     */
+    static bool isShared() {
+#ifdef _OPENMP
+        return omp_in_parallel();
+#else
+        return false;
+#endif
+    }
+
     /** retain the index order used to construct an object of this class */
     const LexOrder theOrder;
 
@@ -21,6 +21,7 @@
 #include "RamIndexAnalysis.h"
 #include "RamTypes.h"
 
+#include <algorithm>
 #include <deque>
 #include <map>
 #include <memory>
@@ -98,33 +99,33 @@ public:
             return;
         }
 
-        int blockIndex = num_tuples / (BLOCK_SIZE / arity);
-        int tupleIndex = (num_tuples % (BLOCK_SIZE / arity)) * arity;
-
-        if (tupleIndex == 0) {
-            blockList.push_back(std::make_unique<RamDomain[]>(BLOCK_SIZE));
-        }
-
-        RamDomain* newTuple = &blockList[blockIndex][tupleIndex];
-        for (size_t i = 0; i < arity; ++i) {
-            newTuple[i] = tuple[i];
-        }
+        RamDomain* newTuple = store(tuple);
 
         // update all indexes with new tuple
         for (auto& cur : indices) {
             cur.insert(newTuple);
         }
+    }
 
-        // increment relation size
-        num_tuples++;
+    /** Insert a batch of consecutively stored tuples, as read from an input */
+    void insertBatch(const RamDomain* tuples, size_t numTuples) {
+        std::vector<const RamDomain*> batch;
+        batch.reserve(numTuples);
+        for (size_t i = 0; i < numTuples; ++i) {
+            batch.push_back(tuples + i * arity);
+        }
+        insertBulk(std::move(batch));
     }
 
     /** Merge another relation into this relation */
     void insert(const RAMIRelation& other) {
         assert(getArity() == other.getArity());
+        std::vector<const RamDomain*> tuples;
+        tuples.reserve(other.size());
         for (const auto& cur : other) {
-            insert(cur);
+            tuples.push_back(cur);
         }
+        insertBulk(std::move(tuples));
     }
 
     /** Purge table */
@@ -150,6 +151,11 @@ public:
         return &indices[idx];
     }
 
+    /** get the index of the given lexicographical order */
+    RAMIIndex* getIndex(const LexOrder& order) const {
+        return getIndexByPos(orderSet->getOrderNum(order));
+    }
+
     /** Obtains a full index-key for this relation */
     SearchSignature getTotalIndexKey() const {
         return (1 << (getArity())) - 1;
@@ -247,7 +253,68 @@ public:
     /** Extend relation */
     virtual void extend(const RAMIRelation& rel) {}
 
+protected:
+    /**
+     * Insert the given tuples, which may be in any order and contain duplicates.
+     * The new tuples are sorted once for each index, such that the indexes can
+     * merge them with their elements rather than inserting them one by one.
+     */
+    virtual void insertBulk(std::vector<const RamDomain*> tuples) {
+        if (arity == 0) {
+            for (const RamDomain* tuple : tuples) {
+                insert(tuple);
+            }
+            return;
+        }
+
+        // drop duplicates and tuples already present, in the order of the total index
+        RAMIIndex* total = getIndex(getTotalIndexKey());
+        RAMIIndex::comparator comp(total->order());
+        std::sort(tuples.begin(), tuples.end(),
+                [&](const RamDomain* a, const RamDomain* b) { return comp.less(a, b); });
+        tuples.erase(std::unique(tuples.begin(), tuples.end(),
+                             [&](const RamDomain* a, const RamDomain* b) { return comp.equal(a, b); }),
+                tuples.end());
+        tuples.erase(std::remove_if(tuples.begin(), tuples.end(),
+                             [&](const RamDomain* tuple) { return total->exists(tuple); }),
+                tuples.end());
+
+        // store the new tuples and add them to each index in its order
+        for (auto& tuple : tuples) {
+            tuple = store(tuple);
+        }
+        total->insertSorted(tuples.begin(), tuples.end());
+        for (auto& cur : indices) {
+            if (&cur == total) {
+                continue;
+            }
+            RAMIIndex::comparator order(cur.order());
+            std::sort(tuples.begin(), tuples.end(),
+                    [&](const RamDomain* a, const RamDomain* b) { return order.less(a, b); });
+            cur.insertSorted(tuples.begin(), tuples.end());
+        }
+    }
+
 private:
+    /** Copy a tuple into the blocks of this relation and return the copy */
+    RamDomain* store(const RamDomain* tuple) {
+        int blockIndex = num_tuples / (BLOCK_SIZE / arity);
+        int tupleIndex = (num_tuples % (BLOCK_SIZE / arity)) * arity;
+
+        if (tupleIndex == 0) {
+            blockList.push_back(std::make_unique<RamDomain[]>(BLOCK_SIZE));
+        }
+
+        RamDomain* newTuple = &blockList[blockIndex][tupleIndex];
+        for (size_t i = 0; i < arity; ++i) {
+            newTuple[i] = tuple[i];
+        }
+
+        // increment relation size
+        num_tuples++;
+        return newTuple;
+    }
+
     /** Arity of relation */
     const size_t arity;
 
@@ -350,6 +417,14 @@ public:
             delete[] newTuple;
         }
     }
+
+protected:
+    /** Insert tuples one by one, such that their closure is computed */
+    void insertBulk(std::vector<const RamDomain*> tuples) override {
+        for (const RamDomain* tuple : tuples) {
+            insert(tuple);
+        }
+    }
 };
 
 }  // end of namespace souffle
@@ -15,11 +15,16 @@
  ***********************************************************************/
 
 #include "RamIndexAnalysis.h"
+#include "Global.h"
 #include "RamCondition.h"
 #include "RamNode.h"
 #include "RamOperation.h"
 #include "RamTranslationUnit.h"
 #include "RamVisitor.h"
+#include "RelationRepresentation.h"
+#include "profile/ProgramRun.h"
+#include "profile/Reader.h"
+#include "profile/Relation.h"
 #include <cstdint>
 #include <cstdlib>
 #include <iostream>
@@ -287,6 +292,11 @@ void RamIndexAnalysis::run(const RamTranslationUnit& translationUnit) {
         } else if (const auto* ramRel = dynamic_cast<const RamRelation*>(&node)) {
             MinIndexSelection& indexes = getIndexes(*ramRel);
             indexes.addSearch(getSearchSignature(ramRel));
+        } else if (const auto* intersection = dynamic_cast<const RamIntersection*>(&node)) {
+            for (size_t i = 0; i < intersection->getNumRelations(); ++i) {
+                MinIndexSelection& indexes = getIndexes(intersection->getRelation(i));
+                indexes.addRequiredOrder(intersection->getLexOrder(i));
+            }
         }
     });
 
@@ -312,12 +322,50 @@ void RamIndexAnalysis::run(const RamTranslationUnit& translationUnit) {
         for (const auto& signature : indexesB.getSearches()) {
             indexesA.addSearch(signature);
         }
+
+        // Likewise for the orders required by operations
+        for (const auto& order : indexesA.getRequiredOrders()) {
+            indexesB.addRequiredOrder(order);
+        }
+        for (const auto& order : indexesB.getRequiredOrders()) {
+            indexesA.addRequiredOrder(order);
+        }
     });
 
+    // order the columns of the indexes by the column statistics of a profile, and record the
+    // sizes of relations for the choice of their data structures
+    if (Global::config().has("profile-use") && !Global::config().has("provenance")) {
+        auto programRun = std::make_shared<profile::ProgramRun>(profile::ProgramRun());
+        profile::Reader(Global::config().get("profile-use"), programRun).processFile();
+        for (auto& cur : minIndexCover) {
+            const RamRelation& rel = *cur.first;
+            if (rel.getRepresentation() == RelationRepresentation::EQREL) {
+                continue;
+            }
+            // auxiliary relations of the semi-naive evaluation share the statistics and hence the
+            // indexes of their relation, keeping swapped relations compatible
+            std::string name = rel.getName();
+            for (const std::string prefix : {"@delta_", "@new_"}) {
+                if (name.compare(0, prefix.size(), prefix) == 0) {
+                    name = name.substr(prefix.size());
+                }
+            }
+            if (const auto* profRel = programRun->getRelation(name)) {
+                std::vector<size_t> distinct;
+                for (size_t i = 0; i < profRel->getNumStatisticsColumns(); ++i) {
+                    distinct.push_back(profRel->getColumnDistinct(i));
+                }
+                cur.second.setDistinctValues(std::move(distinct));
+                cur.second.setExpectedSize(profRel->size());
+            }
+        }
+    }
+
     // find optimal indexes for relations
     for (auto& cur : minIndexCover) {
         MinIndexSelection& indexes = cur.second;
         indexes.solve();
+        indexes.insertRequiredOrders();
     }
 
     // Only case where indexSet is still empty is when relation has arity == 0
@@ -362,14 +410,19 @@ void RamIndexAnalysis::print(std::ostream& os) const {
             os << "\n";
         }
 
-        os << "\tNumber of Indexes: " << indexes.getAllOrders().size() << "\n";
+        /* print indexes and the memory they occupy per tuple, storing tuples directly or by reference */
+        const size_t numIndexes = indexes.getAllOrders().size();
+        const size_t tupleSize = rel.getArity() * sizeof(RamDomain);
+        os << "\tNumber of Indexes: " << numIndexes << "\n";
         for (auto& order : indexes.getAllOrders()) {
             os << "\t\t";
             for (auto& i : order) {
                 os << rel.getArg(i) << " ";
             }
-            os << "\n";
+            os << "(" << tupleSize << " bytes per tuple, " << sizeof(RamDomain*) << " if indirect)\n";
         }
+        os << "\tIndex Memory per Tuple: " << numIndexes * tupleSize << " bytes, "
+           << tupleSize + numIndexes * sizeof(RamDomain*) << " if indirect\n";
     }
     os << "------ End of Auto-Index-Generation Report -------\n";
 }
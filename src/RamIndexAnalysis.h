@@ -21,6 +21,7 @@
 #include "RamRelation.h"
 #include "RamStatement.h"
 #include "RamTypes.h"
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <functional>
@@ -172,6 +173,23 @@ public:
         return searches;
     }
 
+    /** @Brief Add a lexicographical order required by an operation, e.g., by a leapfrog join */
+    void addRequiredOrder(const LexOrder& order) {
+        requiredOrders.insert(order);
+    }
+
+    /** @Brief Get the lexicographical orders required by operations */
+    const std::set<LexOrder>& getRequiredOrders() const {
+        return requiredOrders;
+    }
+
+    /** @Brief Get the number of a lexicographical order, which must be one of the indexes */
+    int getOrderNum(const LexOrder& order) const {
+        auto pos = std::find(orders.begin(), orders.end(), order);
+        assert(pos != orders.end() && "Cannot find lexicographical order");
+        return pos - orders.begin();
+    }
+
     /** @Brief Get index for a search */
     const LexOrder getLexOrder(SearchSignature cols) const {
         int idx = map(cols);
@@ -203,6 +221,26 @@ public:
     /** @Brief map the keys in the key set to lexicographical order */
     void solve();
 
+    /**
+     * @Brief set the estimated number of distinct values of each column
+     *
+     * Columns covered by the same step of a chain are ordered by decreasing number of
+     * distinct values, such that the most selective column leads the search.
+     */
+    void setDistinctValues(std::vector<size_t> values) {
+        distinctValues = std::move(values);
+    }
+
+    /** @Brief set the expected number of tuples of the relation, 0 if unknown */
+    void setExpectedSize(size_t size) {
+        expectedSize = size;
+    }
+
+    /** @Brief get the expected number of tuples of the relation, 0 if unknown */
+    size_t getExpectedSize() const {
+        return expectedSize;
+    }
+
     /** @Brief convert from a representation of A vertices to B vertices */
     static SearchSignature toB(SearchSignature a) {
         SearchSignature msb = 1;
@@ -217,6 +255,27 @@ public:
         return (b xor msb);
     }
 
+    /**
+     * @Brief insert the required orders not covered by an index yet
+     *
+     * An index whose order is a prefix of a required order is extended to it, which retains
+     * the searches covered by the index; otherwise a new index serving no searches is added.
+     */
+    void insertRequiredOrders() {
+        for (const LexOrder& order : requiredOrders) {
+            auto isPrefix = [&](const LexOrder& cur) {
+                return cur.size() <= order.size() && std::equal(cur.begin(), cur.end(), order.begin());
+            };
+            auto pos = std::find_if(orders.begin(), orders.end(), isPrefix);
+            if (pos != orders.end()) {
+                *pos = order;
+            } else {
+                chainToOrder.push_back(Chain());
+                orders.push_back(order);
+            }
+        }
+    }
+
     /** @Brief insert a total order index
      *  @param size of the index
      */
@@ -233,10 +292,13 @@ public:
     }
 
 protected:
-    SearchSet searches;          // set of search patterns on table
-    OrderCollection orders;      // collection of lexicographical orders
-    ChainOrderMap chainToOrder;  // maps order index to set of searches covered by chain
-    MaxMatching matching;        // matching problem for finding minimal number of orders
+    SearchSet searches;                  // set of search patterns on table
+    std::set<LexOrder> requiredOrders;   // set of orders required by operations on table
+    OrderCollection orders;              // collection of lexicographical orders
+    ChainOrderMap chainToOrder;          // maps order index to set of searches covered by chain
+    MaxMatching matching;                // matching problem for finding minimal number of orders
+    std::vector<size_t> distinctValues;  // estimated number of distinct values per column, if known
+    size_t expectedSize = 0;             // expected number of tuples, if known
 
     /** @Brief count the number of bits in key */
     static size_t card(SearchSignature cols) {
@@ -274,15 +336,27 @@ protected:
     void insertIndex(LexOrder& ids, SearchSignature delta) {
         int pos = 0;
         SearchSignature mask = 0;
+        LexOrder columns;
 
         while (mask < delta) {
             mask = SearchSignature(1 << (pos));
             SearchSignature result = (delta) & (mask);
             if (result) {
-                ids.push_back(pos);
+                columns.push_back(pos);
             }
             pos++;
         }
+
+        // order the columns of the delta by their selectivity, if known
+        std::stable_sort(columns.begin(), columns.end(), [&](int a, int b) {
+            return getDistinctValues(a) > getDistinctValues(b);
+        });
+        ids.insert(ids.end(), columns.begin(), columns.end());
+    }
+
+    /** @Brief get the estimated number of distinct values of a column, 0 if unknown */
+    size_t getDistinctValues(int column) const {
+        return ((size_t)column < distinctValues.size()) ? distinctValues[column] : 0;
     }
 
     /** @Brief get a chain from a matching
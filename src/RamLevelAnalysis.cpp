@@ -93,6 +93,17 @@ int RamLevelAnalysis::getLevel(const RamNode* node) const {
             return std::max(level, visit(indexAggregate.getCondition()));
         }
 
+        // intersection
+        int visitIntersection(const RamIntersection& intersection) override {
+            int level = -1;
+            for (size_t i = 0; i < intersection.getNumRelations(); ++i) {
+                for (auto& value : intersection.getPrefix(i)) {
+                    level = std::max(level, visit(value));
+                }
+            }
+            return level;
+        }
+
         // unpack record
         int visitUnpackRecord(const RamUnpackRecord& unpack) override {
             return visit(unpack.getExpression());
@@ -396,6 +396,146 @@ public:
     }
 };
 
+/**
+ * @class RamIntersection
+ * @brief Enumerate the values common to a column of several relations
+ *
+ * Each relation is searched via an index whose lexicographical order leads
+ * with the columns bound by outer operations, given by a prefix of values,
+ * followed by the intersected column. The common values are enumerated by a
+ * leapfrog join, binding a tuple of arity one. A nest of intersections, one
+ * per variable, evaluates a rule body as a worst-case optimal join.
+ *
+ * For example:
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *  QUERY
+ *   ...
+ *	 FOR t1 IN INTERSECT X.b ON INDEX X.a = t0.0, Y.c
+ *	 ...
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+class RamIntersection : public RamTupleOperation {
+public:
+    RamIntersection(int ident, std::vector<std::unique_ptr<RamRelationReference>> relRefs,
+            std::vector<std::vector<int>> lexOrders,
+            std::vector<std::vector<std::unique_ptr<RamExpression>>> prefixes,
+            std::unique_ptr<RamOperation> nested)
+            : RamTupleOperation(ident, std::move(nested)), relationRefs(std::move(relRefs)),
+              lexOrders(std::move(lexOrders)), prefixes(std::move(prefixes)) {
+        assert(relationRefs.size() == this->lexOrders.size() && relationRefs.size() == this->prefixes.size());
+        for (size_t i = 0; i < relationRefs.size(); ++i) {
+            assert(this->lexOrders[i].size() == getRelation(i).getArity() && "order must be total");
+            assert(this->prefixes[i].size() < this->lexOrders[i].size() && "no column left to intersect");
+        }
+    }
+
+    /** @brief Get number of intersected relations */
+    size_t getNumRelations() const {
+        return relationRefs.size();
+    }
+
+    /** @brief Get the i-th intersected relation */
+    const RamRelation& getRelation(size_t i) const {
+        return *relationRefs[i]->get();
+    }
+
+    /** @brief Get the lexicographical order of the index searching the i-th relation */
+    const std::vector<int>& getLexOrder(size_t i) const {
+        return lexOrders[i];
+    }
+
+    /** @brief Get the values of the leading columns of the index searching the i-th relation */
+    std::vector<RamExpression*> getPrefix(size_t i) const {
+        return toPtrVector(prefixes[i]);
+    }
+
+    /** @brief Get the intersected column of the i-th relation */
+    size_t getColumn(size_t i) const {
+        return lexOrders[i][prefixes[i].size()];
+    }
+
+    std::vector<const RamNode*> getChildNodes() const override {
+        auto res = RamTupleOperation::getChildNodes();
+        for (const auto& cur : relationRefs) {
+            res.push_back(cur.get());
+        }
+        for (const auto& prefix : prefixes) {
+            for (const auto& cur : prefix) {
+                res.push_back(cur.get());
+            }
+        }
+        return res;
+    }
+
+    void apply(const RamNodeMapper& map) override {
+        RamTupleOperation::apply(map);
+        for (auto& cur : relationRefs) {
+            cur = map(std::move(cur));
+        }
+        for (auto& prefix : prefixes) {
+            for (auto& cur : prefix) {
+                cur = map(std::move(cur));
+            }
+        }
+    }
+
+    void print(std::ostream& os, int tabpos) const override {
+        os << times(" ", tabpos);
+        os << "FOR t" << getTupleId() << " IN INTERSECT ";
+        for (size_t i = 0; i < getNumRelations(); ++i) {
+            const RamRelation& rel = getRelation(i);
+            if (i > 0) {
+                os << ", ";
+            }
+            os << rel.getName() << "." << rel.getArg(getColumn(i));
+            for (size_t j = 0; j < prefixes[i].size(); ++j) {
+                os << (j == 0 ? " ON INDEX " : " AND ");
+                os << rel.getName() << "." << rel.getArg(lexOrders[i][j]) << " = " << *prefixes[i][j];
+            }
+        }
+        os << std::endl;
+        RamTupleOperation::print(os, tabpos + 1);
+    }
+
+    RamIntersection* clone() const override {
+        std::vector<std::unique_ptr<RamRelationReference>> resRelationRefs;
+        std::vector<std::vector<std::unique_ptr<RamExpression>>> resPrefixes(prefixes.size());
+        for (size_t i = 0; i < getNumRelations(); ++i) {
+            resRelationRefs.push_back(std::unique_ptr<RamRelationReference>(relationRefs[i]->clone()));
+            for (const auto& cur : prefixes[i]) {
+                resPrefixes[i].push_back(std::unique_ptr<RamExpression>(cur->clone()));
+            }
+        }
+        return new RamIntersection(getTupleId(), std::move(resRelationRefs), lexOrders,
+                std::move(resPrefixes), std::unique_ptr<RamOperation>(getOperation().clone()));
+    }
+
+protected:
+    /** Intersected relations */
+    std::vector<std::unique_ptr<RamRelationReference>> relationRefs;
+
+    /** Lexicographical orders of the indexes searching the relations */
+    std::vector<std::vector<int>> lexOrders;
+
+    /** Values of the leading columns of the indexes */
+    std::vector<std::vector<std::unique_ptr<RamExpression>>> prefixes;
+
+    bool equal(const RamNode& node) const override {
+        assert(nullptr != dynamic_cast<const RamIntersection*>(&node));
+        const auto& other = static_cast<const RamIntersection&>(node);
+        if (!RamTupleOperation::equal(other) || !equal_targets(relationRefs, other.relationRefs) ||
+                lexOrders != other.lexOrders || prefixes.size() != other.prefixes.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < prefixes.size(); ++i) {
+            if (!equal_targets(prefixes[i], other.prefixes[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
 /**
  * @class RamAbstractChoice
  * @brief Abstract class for a choice operation
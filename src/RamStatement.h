@@ -24,6 +24,8 @@
 #include "Util.h"
 
 #include <algorithm>
+#include <array>
+#include <cmath>
 #include <memory>
 #include <ostream>
 #include <string>
@@ -634,6 +636,111 @@ protected:
     }
 };
 
+/**
+ * @class RamAdaptiveQuery
+ * @brief Alternative join orders of a rule, one of which is executed
+ *
+ * Every variant is a query evaluating the same rule with a different nesting
+ * of its scans. Before each execution, the variant of the least estimated
+ * cost for the current sizes of the scanned relations is chosen. If the
+ * message is not empty, the choice is logged to the profile.
+ *
+ * For example:
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * ADAPTIVE
+ *   QUERY
+ *     ...
+ *   QUERY
+ *     ...
+ * END ADAPTIVE
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+class RamAdaptiveQuery : public RamListStatement {
+public:
+    RamAdaptiveQuery(std::string message = "") : RamListStatement(), message(std::move(message)) {}
+
+    /** @brief Get profile message */
+    const std::string& getMessage() const {
+        return message;
+    }
+
+    /**
+     * @brief Get the relations scanned by a variant, in nesting order, together with
+     * the number of their arguments bound by the enclosing scans
+     */
+    std::vector<std::pair<const RamRelation*, size_t>> getScans(size_t variant) const {
+        std::vector<std::pair<const RamRelation*, size_t>> res;
+        const auto* query = dynamic_cast<const RamQuery*>(statements[variant].get());
+        if (query == nullptr) {
+            return res;
+        }
+        const RamOperation* op = &query->getOperation();
+        while (const auto* nested = dynamic_cast<const RamNestedOperation*>(op)) {
+            if (const auto* indexOp = dynamic_cast<const RamIndexOperation*>(op)) {
+                size_t bound = 0;
+                for (const RamExpression* value : indexOp->getRangePattern()) {
+                    bound += isRamUndefValue(value) ? 0 : 1;
+                }
+                res.emplace_back(&indexOp->getRelation(), bound);
+            } else if (const auto* relOp = dynamic_cast<const RamRelationOperation*>(op)) {
+                res.emplace_back(&relOp->getRelation(), 0);
+            }
+            op = &nested->getOperation();
+        }
+        return res;
+    }
+
+    /**
+     * @brief Estimate the cost of a variant by the number of tuples enumerated by its scans
+     *
+     * Each scan of a relation R with #bound out of #args bound arguments enumerates
+     * |R|^(#free/#args) tuples per tuple of its enclosing scans, assuming all arguments
+     * to be equally selective.
+     *
+     * @param scans sizes, arities and numbers of bound arguments of the scanned relations
+     */
+    static double estimateCost(const std::vector<std::array<size_t, 3>>& scans) {
+        double tuples = 1;
+        double cost = 0;
+        for (const auto& scan : scans) {
+            const size_t size = scan[0];
+            const size_t arity = scan[1];
+            const size_t bound = scan[2];
+            if (arity > 0) {
+                tuples *= std::pow(std::max<double>(size, 1), double(arity - bound) / arity);
+            }
+            cost += tuples;
+        }
+        return cost;
+    }
+
+    void print(std::ostream& os, int tabpos) const override {
+        os << times(" ", tabpos) << "ADAPTIVE" << std::endl;
+        for (auto const& stmt : statements) {
+            stmt->print(os, tabpos + 1);
+        }
+        os << times(" ", tabpos) << "END ADAPTIVE" << std::endl;
+    }
+
+    RamAdaptiveQuery* clone() const override {
+        auto* res = new RamAdaptiveQuery(message);
+        for (auto& cur : statements) {
+            res->add(std::unique_ptr<RamStatement>(cur->clone()));
+        }
+        return res;
+    }
+
+protected:
+    /** Profile message logging the chosen variant */
+    const std::string message;
+
+    bool equal(const RamNode& node) const override {
+        assert(nullptr != dynamic_cast<const RamAdaptiveQuery*>(&node));
+        const auto& other = static_cast<const RamAdaptiveQuery&>(node);
+        return RamListStatement::equal(node) && message == other.message;
+    }
+};
+
 /**
  * @class RamLoop
  * @brief Execute statement until statement terminates loop via an exit statement
@@ -1034,6 +1141,42 @@ protected:
     }
 };
 
+/**
+ * @class RamLogStatistics
+ * @brief Log the column statistics of a relation, sampled from its tuples
+ */
+class RamLogStatistics : public RamRelationStatement {
+public:
+    RamLogStatistics(std::unique_ptr<RamRelationReference> relRef, std::string message)
+            : RamRelationStatement(std::move(relRef)), message(std::move(message)) {}
+
+    /** @brief Get logging message */
+    const std::string& getMessage() const {
+        return message;
+    }
+
+    void print(std::ostream& os, int tabpos) const override {
+        os << times(" ", tabpos) << "LOGSTATISTICS " << getRelation().getName();
+        os << " TEXT "
+           << "\"" << stringify(message) << "\"";
+        os << std::endl;
+    }
+
+    RamLogStatistics* clone() const override {
+        return new RamLogStatistics(std::unique_ptr<RamRelationReference>(relationRef->clone()), message);
+    }
+
+protected:
+    /** logging message */
+    std::string message;
+
+    bool equal(const RamNode& node) const override {
+        assert(nullptr != dynamic_cast<const RamLogStatistics*>(&node));
+        const auto& other = static_cast<const RamLogStatistics&>(node);
+        return RamRelationStatement::equal(other) && getMessage() == other.getMessage();
+    }
+};
+
 #ifdef USE_MPI
 
 class RamRecv : public RamRelationStatement {
@@ -1167,6 +1310,89 @@ protected:
     }
 };
 
+/**
+ * @class RamExchange
+ * @brief Exchange the tuples of a relation between all processes
+ *
+ * Each process contributes the tuples of the relation it computed itself,
+ * and obtains the union of the relation over all processes. This is used
+ * for the replicated evaluation of recursive relations, where every process
+ * holds all relations and evaluates the rules on its share of their deltas.
+ *
+ * For example:
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * EXCHANGE A
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+class RamExchange : public RamRelationStatement {
+public:
+    RamExchange(std::unique_ptr<RamRelationReference> relRef) : RamRelationStatement(std::move(relRef)) {}
+
+    void print(std::ostream& os, int tabpos) const override {
+        os << times(" ", tabpos);
+        os << "EXCHANGE " << getRelation().getName();
+        os << std::endl;
+    }
+
+    RamExchange* clone() const override {
+        return new RamExchange(std::unique_ptr<RamRelationReference>(relationRef->clone()));
+    }
+};
+
+/**
+ * @class RamPartition
+ * @brief Retain only the tuples of a relation owned by the current process
+ *
+ * Tuples are assigned to processes by their hash value, such that the
+ * processes evaluating a rule on a partitioned delta relation share the work.
+ *
+ * For example:
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * PARTITION A
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+class RamPartition : public RamRelationStatement {
+public:
+    RamPartition(std::unique_ptr<RamRelationReference> relRef) : RamRelationStatement(std::move(relRef)) {}
+
+    void print(std::ostream& os, int tabpos) const override {
+        os << times(" ", tabpos);
+        os << "PARTITION " << getRelation().getName();
+        os << std::endl;
+    }
+
+    RamPartition* clone() const override {
+        return new RamPartition(std::unique_ptr<RamRelationReference>(relationRef->clone()));
+    }
+};
+
+/**
+ * @class RamBroadcast
+ * @brief Broadcast a relation from the master process to all other processes
+ *
+ * The symbols created by the master process while loading the relation are
+ * broadcast as well, such that the symbol tables of all processes agree.
+ *
+ * For example:
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * BROADCAST A
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+class RamBroadcast : public RamRelationStatement {
+public:
+    RamBroadcast(std::unique_ptr<RamRelationReference> relRef) : RamRelationStatement(std::move(relRef)) {}
+
+    void print(std::ostream& os, int tabpos) const override {
+        os << times(" ", tabpos);
+        os << "BROADCAST " << getRelation().getName();
+        os << std::endl;
+    }
+
+    RamBroadcast* clone() const override {
+        return new RamBroadcast(std::unique_ptr<RamRelationReference>(relationRef->clone()));
+    }
+};
+
 #endif
 
 }  // end of namespace souffle
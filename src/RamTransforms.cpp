@@ -25,6 +25,8 @@
 #include "RamStatement.h"
 #include "RamTypes.h"
 #include "RamVisitor.h"
+#include "Util.h"
+#include <set>
 #include <utility>
 #include <vector>
 
@@ -521,6 +523,194 @@ bool ChoiceConversionTransformer::convertScans(RamProgram& program) {
     return changed;
 }
 
+std::map<const RamRelation*, std::map<SearchSignature, SearchSignature>>
+ReduceIndexesTransformer::reduceSearches(const RamProgram& program) {
+    std::map<const RamRelation*, std::map<SearchSignature, SearchSignature>> res;
+
+    // searches that cannot be answered by a range scan and a filter
+    std::map<const RamRelation*, std::set<SearchSignature>> pinned;
+    visitDepthFirst(program, [&](const RamNode& node) {
+        if (dynamic_cast<const RamIndexScan*>(&node) != nullptr ||
+                dynamic_cast<const RamIndexAggregate*>(&node) != nullptr) {
+            return;
+        }
+        if (const auto* indexOp = dynamic_cast<const RamIndexOperation*>(&node)) {
+            pinned[&indexOp->getRelation()].insert(idxAnalysis->getSearchSignature(indexOp));
+        } else if (const auto* exists = dynamic_cast<const RamExistenceCheck*>(&node)) {
+            pinned[&exists->getRelation()].insert(idxAnalysis->getSearchSignature(exists));
+        } else if (const auto* provExists = dynamic_cast<const RamProvenanceExistenceCheck*>(&node)) {
+            pinned[&provExists->getRelation()].insert(idxAnalysis->getSearchSignature(provExists));
+        } else if (const auto* rel = dynamic_cast<const RamRelation*>(&node)) {
+            pinned[rel].insert(idxAnalysis->getSearchSignature(rel));
+        }
+    });
+
+    // swapped relations share their indexes, and hence their reductions
+    visitDepthFirst(program, [&](const RamSwap& swap) {
+        auto& first = pinned[&swap.getFirstRelation()];
+        auto& second = pinned[&swap.getSecondRelation()];
+        first.insert(second.begin(), second.end());
+        second.insert(first.begin(), first.end());
+    });
+
+    auto card = [](SearchSignature cols) {
+        size_t res = 0;
+        for (; cols != 0; cols &= cols - 1) {
+            res++;
+        }
+        return res;
+    };
+
+    for (const auto& cur : pinned) {
+        const RamRelation* rel = cur.first;
+        if (rel->getRepresentation() == RelationRepresentation::EQREL) {
+            continue;
+        }
+        const MinIndexSelection& indexes = idxAnalysis->getIndexes(*rel);
+        const auto orders = indexes.getAllOrders();
+        const auto chains = indexes.getAllChains();
+        std::vector<bool> dropped(orders.size(), false);
+
+        // the longest prefix of a remaining index covered by a search
+        auto getPrefix = [&](SearchSignature search) {
+            SearchSignature best = 0;
+            for (size_t i = 0; i < orders.size(); ++i) {
+                SearchSignature prefix = 0;
+                for (size_t j = 0; !dropped[i] && j < orders[i].size(); ++j) {
+                    if ((search & (1 << orders[i][j])) == 0) {
+                        break;
+                    }
+                    prefix |= (1 << orders[i][j]);
+                }
+                if (card(prefix) > card(best)) {
+                    best = prefix;
+                }
+            }
+            return best;
+        };
+
+        // drop the index whose searches lose the fewest bound columns, until the limit is met
+        for (size_t remaining = orders.size(); remaining > limit; --remaining) {
+            int victim = -1;
+            size_t victimLoss = 0;
+            for (size_t i = 0; i < orders.size(); ++i) {
+                if (dropped[i] || chains[i].empty() || indexes.getRequiredOrders().count(orders[i]) > 0 ||
+                        any_of(chains[i], [&](SearchSignature search) { return cur.second.count(search); })) {
+                    continue;
+                }
+                dropped[i] = true;
+                size_t loss = 0;
+                for (SearchSignature search : chains[i]) {
+                    loss += card(search) - card(getPrefix(search));
+                }
+                dropped[i] = false;
+                if (victim == -1 || loss < victimLoss) {
+                    victim = i;
+                    victimLoss = loss;
+                }
+            }
+            if (victim == -1) {
+                break;
+            }
+            dropped[victim] = true;
+        }
+
+        for (size_t i = 0; i < orders.size(); ++i) {
+            if (dropped[i]) {
+                for (SearchSignature search : chains[i]) {
+                    res[rel][search] = getPrefix(search);
+                }
+            }
+        }
+    }
+    return res;
+}
+
+bool ReduceIndexesTransformer::reduceIndexes(RamProgram& program) {
+    const auto reductions = reduceSearches(program);
+    if (reductions.empty()) {
+        return false;
+    }
+
+    // split the pattern of an operation into the pattern of the reduced search and a filter
+    auto reduce = [&](const RamIndexOperation& op, std::vector<std::unique_ptr<RamExpression>>& pattern,
+                          std::unique_ptr<RamCondition>& filter) {
+        const auto relReductions = reductions.find(&op.getRelation());
+        if (relReductions == reductions.end()) {
+            return false;
+        }
+        const auto reduction = relReductions->second.find(idxAnalysis->getSearchSignature(&op));
+        if (reduction == relReductions->second.end()) {
+            return false;
+        }
+        std::vector<const RamCondition*> conditions;
+        std::vector<std::unique_ptr<RamCondition>> constraints;
+        const auto rangePattern = op.getRangePattern();
+        for (size_t i = 0; i < rangePattern.size(); ++i) {
+            pattern.push_back(std::unique_ptr<RamExpression>(rangePattern[i]->clone()));
+            if (!isRamUndefValue(rangePattern[i]) && (reduction->second & (1 << i)) == 0) {
+                constraints.push_back(std::make_unique<RamConstraint>(BinaryConstraintOp::EQ,
+                        std::make_unique<RamTupleElement>(op.getTupleId(), i), std::move(pattern.back())));
+                conditions.push_back(constraints.back().get());
+                pattern.back() = std::make_unique<RamUndefValue>();
+            }
+        }
+        filter = toCondition(conditions);
+        return filter != nullptr;
+    };
+
+    bool changed = false;
+    visitDepthFirst(program, [&](const RamQuery& query) {
+        std::function<std::unique_ptr<RamNode>(std::unique_ptr<RamNode>)> searchRewriter =
+                [&](std::unique_ptr<RamNode> node) -> std::unique_ptr<RamNode> {
+            std::vector<std::unique_ptr<RamExpression>> pattern;
+            std::unique_ptr<RamCondition> filter;
+            if (const RamIndexScan* iscan = dynamic_cast<RamIndexScan*>(node.get())) {
+                if (reduce(*iscan, pattern, filter)) {
+                    changed = true;
+                    auto rel = std::make_unique<RamRelationReference>(&iscan->getRelation());
+                    auto op = std::make_unique<RamFilter>(
+                            std::move(filter), std::unique_ptr<RamOperation>(iscan->getOperation().clone()));
+                    if (any_of(pattern, [](const std::unique_ptr<RamExpression>& cur) {
+                            return !isRamUndefValue(cur.get());
+                        })) {
+                        node = std::make_unique<RamIndexScan>(std::move(rel), iscan->getTupleId(),
+                                std::move(pattern), std::move(op), iscan->getProfileText());
+                    } else {
+                        node = std::make_unique<RamScan>(
+                                std::move(rel), iscan->getTupleId(), std::move(op), iscan->getProfileText());
+                    }
+                }
+            } else if (const RamIndexAggregate* agg = dynamic_cast<RamIndexAggregate*>(node.get())) {
+                if (reduce(*agg, pattern, filter)) {
+                    changed = true;
+                    auto rel = std::make_unique<RamRelationReference>(&agg->getRelation());
+                    auto nested = std::unique_ptr<RamOperation>(agg->getOperation().clone());
+                    auto expr = std::unique_ptr<RamExpression>(agg->getExpression().clone());
+                    if (!isRamTrue(&agg->getCondition())) {
+                        filter = std::make_unique<RamConjunction>(std::move(filter),
+                                std::unique_ptr<RamCondition>(agg->getCondition().clone()));
+                    }
+                    if (any_of(pattern, [](const std::unique_ptr<RamExpression>& cur) {
+                            return !isRamUndefValue(cur.get());
+                        })) {
+                        node = std::make_unique<RamIndexAggregate>(std::move(nested), agg->getFunction(),
+                                std::move(rel), std::move(expr), std::move(filter), std::move(pattern),
+                                agg->getTupleId());
+                    } else {
+                        node = std::make_unique<RamAggregate>(std::move(nested), agg->getFunction(),
+                                std::move(rel), std::move(expr), std::move(filter), agg->getTupleId());
+                    }
+                }
+            }
+            node->apply(makeLambdaRamMapper(searchRewriter));
+            return node;
+        };
+        const_cast<RamQuery*>(&query)->apply(makeLambdaRamMapper(searchRewriter));
+    });
+    return changed;
+}
+
 bool TupleIdTransformer::reorderOperations(RamProgram& program) {
     // flag to determine whether the RAM program has changed
     bool changed = false;
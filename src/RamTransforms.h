@@ -16,9 +16,11 @@
 
 #pragma once
 
+#include "RamIndexAnalysis.h"
 #include "RamLevelAnalysis.h"
 #include "RamTransformer.h"
 #include "RamTranslationUnit.h"
+#include <map>
 #include <memory>
 #include <string>
 
@@ -407,6 +409,71 @@ protected:
     }
 };
 
+/**
+ * @class ReduceIndexesTransformer
+ * @brief Limit the number of indexes of relations by scanning ranges of shared indexes
+ *
+ * Each index of a relation stores all of its tuples, directly or by reference. If the
+ * minimal index cover of a relation exceeds the limit, the chains of searches losing the
+ * fewest bound columns are dropped. Their searches are rewritten to use the longest prefix
+ * of a remaining index only, filtering the remaining columns.
+ *
+ * For example, if the index of the search on x and z is dropped in favour of an index
+ * leading with x,
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *  QUERY
+ *   ...
+ *    FOR t1 IN A ON INDEX t1.x = t0.0 AND t1.z = t0.1
+ *     ...
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * will be rewritten to
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *  QUERY
+ *   ...
+ *    FOR t1 IN A ON INDEX t1.x = t0.0
+ *     IF t1.z = t0.1
+ *      ...
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * Searches of existence checks are retained, as well as the orders required by leapfrog joins.
+ */
+class ReduceIndexesTransformer : public RamTransformer {
+public:
+    ReduceIndexesTransformer(size_t limit) : limit(limit) {}
+
+    std::string getName() const override {
+        return "ReduceIndexesTransformer";
+    }
+
+    /**
+     * @brief Choose the searches to be answered by a prefix of another index
+     * @param RAM program
+     * @result The replacing search of each rewritten search, for each relation
+     */
+    std::map<const RamRelation*, std::map<SearchSignature, SearchSignature>> reduceSearches(
+            const RamProgram& program);
+
+    /**
+     * @brief Rewrite the index operations of the chosen searches
+     * @param RAM program
+     * @result A flag indicating whether the RAM program has been changed.
+     */
+    bool reduceIndexes(RamProgram& program);
+
+protected:
+    /** The maximal number of indexes of a relation */
+    size_t limit;
+
+    RamIndexAnalysis* idxAnalysis{nullptr};
+    bool transform(RamTranslationUnit& translationUnit) override {
+        idxAnalysis = translationUnit.getAnalysis<RamIndexAnalysis>();
+        return reduceIndexes(*translationUnit.getProgram());
+    }
+};
+
 /**
  * @class TupleIdTransformer
  * @brief Ordering tupleIds in RamTupleOperation operations correctly
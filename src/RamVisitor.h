@@ -106,6 +106,7 @@ struct RamVisitor : public ram_visitor_tag {
         FORWARD(Project);
         FORWARD(SubroutineReturnValue);
         FORWARD(UnpackRecord);
+        FORWARD(Intersection);
         FORWARD(ParallelScan);
         FORWARD(Scan);
         FORWARD(ParallelIndexScan);
@@ -126,6 +127,7 @@ struct RamVisitor : public ram_visitor_tag {
         FORWARD(Clear);
         FORWARD(Drop);
         FORWARD(LogSize);
+        FORWARD(LogStatistics);
 
         FORWARD(Merge);
         FORWARD(Swap);
@@ -135,6 +137,7 @@ struct RamVisitor : public ram_visitor_tag {
         FORWARD(Sequence);
         FORWARD(Loop);
         FORWARD(Parallel);
+        FORWARD(AdaptiveQuery);
         FORWARD(Exit);
         FORWARD(LogTimer);
         FORWARD(LogRelationTimer);
@@ -147,6 +150,9 @@ struct RamVisitor : public ram_visitor_tag {
         FORWARD(Recv);
         FORWARD(Notify);
         FORWARD(Wait);
+        FORWARD(Exchange);
+        FORWARD(Partition);
+        FORWARD(Broadcast);
 #endif
 
 #undef FORWARD
@@ -178,6 +184,7 @@ protected:
     LINK(Clear, RelationStatement);
     LINK(Drop, RelationStatement);
     LINK(LogSize, RelationStatement);
+    LINK(LogStatistics, RelationStatement);
 
     LINK(RelationStatement, Statement);
 
@@ -188,6 +195,7 @@ protected:
     LINK(Sequence, ListStatement);
     LINK(Loop, Statement);
     LINK(Parallel, ListStatement);
+    LINK(AdaptiveQuery, ListStatement);
     LINK(ListStatement, Statement);
     LINK(Exit, Statement);
     LINK(LogTimer, Statement);
@@ -201,6 +209,7 @@ protected:
     LINK(Project, Operation);
     LINK(SubroutineReturnValue, Operation);
     LINK(UnpackRecord, TupleOperation);
+    LINK(Intersection, TupleOperation);
     LINK(Scan, RelationOperation);
     LINK(ParallelScan, Scan);
     LINK(IndexScan, IndexOperation);
@@ -259,6 +268,9 @@ protected:
     LINK(Recv, RelationStatement);
     LINK(Notify, Statement);
     LINK(Wait, Statement);
+    LINK(Exchange, RelationStatement);
+    LINK(Partition, RelationStatement);
+    LINK(Broadcast, RelationStatement);
 #endif
 
 #undef LINK
@@ -18,6 +18,7 @@
 #include "RamTypes.h"
 #include "SymbolTable.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -33,16 +34,57 @@ public:
     void readAll(T& relation) {
         auto lease = symbolTable.acquireLock();
         (void)lease;
-        while (const auto next = readNextTuple()) {
-            const RamDomain* ramDomain = next.get();
-            relation.insert(ramDomain);
+        const size_t width = symbolMask.size();
+        std::vector<RamDomain> tuples(BATCH_SIZE * std::max<size_t>(width, 1));
+        while (size_t numTuples = readNextTuples(tuples.data(), BATCH_SIZE)) {
+            insertTuples(relation, tuples.data(), numTuples, 0);
         }
     }
 
     virtual ~ReadStream() = default;
 
 protected:
+    /** The number of tuples read at once by readAll */
+    static constexpr size_t BATCH_SIZE = 4096;
+
     virtual std::unique_ptr<RamDomain[]> readNextTuple() = 0;
+
+    /**
+     * Read up to maxTuples tuples into the given buffer, which holds
+     * maxTuples * symbolMask.size() values.
+     *
+     * @return the number of tuples read; 0 if no tuple was readable
+     */
+    virtual size_t readNextTuples(RamDomain* tuples, size_t maxTuples) {
+        const size_t width = symbolMask.size();
+        size_t numTuples = 0;
+        while (numTuples < maxTuples) {
+            const auto next = readNextTuple();
+            if (!next) {
+                break;
+            }
+            std::copy(next.get(), next.get() + width, tuples + numTuples * width);
+            numTuples++;
+        }
+        return numTuples;
+    }
+
+    /** Insert a batch of tuples into a relation providing a batch insertion */
+    template <typename T>
+    auto insertTuples(T& relation, const RamDomain* tuples, size_t numTuples, int)
+            -> decltype(relation.insertBatch(tuples, numTuples), void()) {
+        relation.insertBatch(tuples, numTuples);
+    }
+
+    /** Insert a batch of tuples into a relation one by one */
+    template <typename T>
+    void insertTuples(T& relation, const RamDomain* tuples, size_t numTuples, long) {
+        const size_t width = symbolMask.size();
+        for (size_t i = 0; i < numTuples; ++i) {
+            relation.insert(tuples + i * width);
+        }
+    }
+
     const std::vector<bool>& symbolMask;
     SymbolTable& symbolTable;
     const bool isProvenance;
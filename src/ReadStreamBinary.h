@@ -0,0 +1,233 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2019, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ReadStreamBinary.h
+ *
+ * Reads relations in the binary columnar format of BinaryFormat.h
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "BinaryFormat.h"
+#include "IODirectives.h"
+#include "MappedFile.h"
+#include "RamTypes.h"
+#include "ReadStream.h"
+#include "SymbolTable.h"
+#include "Util.h"
+#ifdef USE_LIBZ
+#include "gzfstream.h"
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace souffle {
+
+/**
+ * Reads a binary relation file.
+ *
+ * Uncompressed files are mapped into memory and their columns are read in place;
+ * compressed files are decompressed into memory first.
+ */
+class ReadFileBinary : public ReadStream {
+public:
+    ReadFileBinary(const std::vector<bool>& symbolMask, SymbolTable& symbolTable,
+            const IODirectives& ioDirectives, const bool provenance = false)
+            : ReadStream(symbolMask, symbolTable, provenance),
+              baseName(souffle::baseName(getFileName(ioDirectives))) {
+        const std::string fileName = getFileName(ioDirectives);
+        if (!file.open(fileName)) {
+            if (ioDirectives.has("intermediate")) {
+                return;
+            }
+            throw std::invalid_argument("Cannot open fact file " + baseName + "\n");
+        }
+        begin = file.begin();
+        end = file.end();
+
+        // decompress gzip-compressed files
+        if (end - begin >= 2 && static_cast<unsigned char>(begin[0]) == 0x1f &&
+                static_cast<unsigned char>(begin[1]) == 0x8b) {
+#ifdef USE_LIBZ
+            gzfstream::igzfstream gzfile(fileName, std::ios::in | std::ios::binary);
+            buffer.assign(std::istreambuf_iterator<char>(gzfile), std::istreambuf_iterator<char>());
+            begin = buffer.data();
+            end = begin + buffer.size();
+#else
+            throw std::invalid_argument("Cannot read compressed fact file " + baseName + "\n");
+#endif
+        }
+
+        parseLayout();
+    }
+
+    ~ReadFileBinary() override = default;
+
+protected:
+    /**
+     * Read and return the next tuple.
+     *
+     * The symbols of the file are added to the symbol table when the first tuple is requested.
+     *
+     * Returns nullptr if no tuple was readable.
+     * @return
+     */
+    std::unique_ptr<RamDomain[]> readNextTuple() override {
+        std::unique_ptr<RamDomain[]> tuple = std::make_unique<RamDomain[]>(symbolMask.size());
+        if (readNextTuples(tuple.get(), 1) == 0) {
+            return nullptr;
+        }
+        return tuple;
+    }
+
+    /** Transposes the next tuples of the columns into the given buffer */
+    size_t readNextTuples(RamDomain* tuples, size_t maxTuples) override {
+        const size_t count = std::min(maxTuples, numTuples - nextTuple);
+        if (count == 0) {
+            return 0;
+        }
+        if (symbols.size() < numSymbols) {
+            internSymbols();
+        }
+        const size_t width = symbolMask.size();
+        for (size_t col = 0; col < arity; ++col) {
+            const RamDomain* column = columns + col * numTuples + nextTuple;
+            RamDomain* dest = tuples + col;
+            if (symbolMask[col]) {
+                for (size_t i = 0; i < count; ++i, dest += width) {
+                    const RamDomain value = column[i];
+                    if (value < 0 || size_t(value) >= numSymbols) {
+                        throw std::invalid_argument("Invalid symbol in fact file " + baseName + "\n");
+                    }
+                    *dest = symbols[value];
+                }
+            } else {
+                for (size_t i = 0; i < count; ++i, dest += width) {
+                    *dest = column[i];
+                }
+            }
+        }
+        for (size_t col = arity; col < width; ++col) {
+            for (size_t i = 0; i < count; ++i) {
+                tuples[i * width + col] = 0;
+            }
+        }
+        nextTuple += count;
+        return count;
+    }
+
+    /** Check the header of the file and locate its dictionary and columns */
+    void parseLayout() {
+        BinaryFileHeader header;
+        if (size_t(end - begin) < sizeof(header)) {
+            throw std::invalid_argument("Cannot parse binary fact file " + baseName + "\n");
+        }
+        std::memcpy(&header, begin, sizeof(header));
+        if (!header.isValid()) {
+            throw std::invalid_argument("Fact file " + baseName + " is not a compatible binary file\n");
+        }
+
+        const char* types = begin + sizeof(header);
+        const size_t typesSize = header.arity + binaryPadding(header.arity);
+        if (header.arity != arity || size_t(end - types) < typesSize) {
+            throw std::invalid_argument("Arity of binary fact file " + baseName + " does not match\n");
+        }
+        for (size_t col = 0; col < arity; ++col) {
+            if ((types[col] == 's') != symbolMask[col]) {
+                throw std::invalid_argument("Column types of binary fact file " + baseName +
+                                            " do not match\n");
+            }
+        }
+
+        dictionary = types + typesSize;
+        const size_t columnsSize = header.arity * header.numTuples * sizeof(RamDomain);
+        if (size_t(end - dictionary) != header.dictionarySize + columnsSize) {
+            throw std::invalid_argument("Cannot parse binary fact file " + baseName + "\n");
+        }
+        columns = reinterpret_cast<const RamDomain*>(dictionary + header.dictionarySize);
+        numTuples = header.numTuples;
+        numSymbols = header.numSymbols;
+    }
+
+    /** Add the symbols of the dictionary to the symbol table, in dictionary order */
+    void internSymbols() {
+        const char* cur = dictionary;
+        const char* dictionaryEnd = reinterpret_cast<const char*>(columns);
+        std::vector<std::string> strings;
+        strings.reserve(numSymbols);
+        for (size_t i = 0; i < numSymbols; ++i) {
+            uint32_t length;
+            if (size_t(dictionaryEnd - cur) < sizeof(length)) {
+                throw std::invalid_argument("Cannot parse binary fact file " + baseName + "\n");
+            }
+            std::memcpy(&length, cur, sizeof(length));
+            cur += sizeof(length);
+            if (size_t(dictionaryEnd - cur) < length) {
+                throw std::invalid_argument("Cannot parse binary fact file " + baseName + "\n");
+            }
+            strings.emplace_back(cur, length);
+            cur += length;
+        }
+        symbols = symbolTable.lookup(strings);
+    }
+
+    std::string getFileName(const IODirectives& ioDirectives) const {
+        if (ioDirectives.has("filename")) {
+            return ioDirectives.get("filename");
+        }
+        return ioDirectives.getRelationName() + ".bin";
+    }
+
+    std::string baseName;
+
+    /** The mapped file, and the decompressed file if it is compressed */
+    MappedFile file;
+    std::string buffer;
+
+    /** The contents of the file */
+    const char* begin = nullptr;
+    const char* end = nullptr;
+
+    /** Start of the dictionary and of the columns within the contents */
+    const char* dictionary = nullptr;
+    const RamDomain* columns = nullptr;
+
+    size_t numTuples = 0;
+    size_t numSymbols = 0;
+
+    /** Symbol table indices of the symbols of the dictionary */
+    std::vector<RamDomain> symbols;
+
+    /** Index of the next tuple to be returned */
+    size_t nextTuple = 0;
+};
+
+class ReadFileBinaryFactory : public ReadStreamFactory {
+public:
+    std::unique_ptr<ReadStream> getReader(const std::vector<bool>& symbolMask, SymbolTable& symbolTable,
+            const IODirectives& ioDirectives, const bool provenance) override {
+        return std::make_unique<ReadFileBinary>(symbolMask, symbolTable, ioDirectives, provenance);
+    }
+    const std::string& getName() const override {
+        static const std::string name = "binary";
+        return name;
+    }
+    ~ReadFileBinaryFactory() override = default;
+};
+
+} /* namespace souffle */
@@ -26,11 +26,13 @@
 #include <fstream>
 #endif
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 namespace souffle {
 
@@ -48,6 +50,39 @@ public:
 
     ~ReadStreamCSV() override = default;
 
+    static std::string getDelimiter(const IODirectives& ioDirectives) {
+        if (ioDirectives.has("delimiter")) {
+            return ioDirectives.get("delimiter");
+        }
+        return "\t";
+    }
+
+    static std::map<int, int> getInputColumnMap(const IODirectives& ioDirectives, const unsigned arity) {
+        std::string columnString = "";
+        if (ioDirectives.has("columns")) {
+            columnString = ioDirectives.get("columns");
+        }
+        std::map<int, int> inputMap;
+
+        if (!columnString.empty()) {
+            std::istringstream iss(columnString);
+            std::string mapping;
+            int index = 0;
+            while (std::getline(iss, mapping, ':')) {
+                inputMap[stoi(mapping)] = index++;
+            }
+            if (inputMap.size() < arity) {
+                throw std::invalid_argument("Invalid column set was given: <" + columnString + ">");
+            }
+        } else {
+            while (inputMap.size() < arity) {
+                int size = inputMap.size();
+                inputMap[size] = size;
+            }
+        }
+        return inputMap;
+    }
+
 protected:
     /**
      * Read and return the next tuple.
@@ -56,14 +91,52 @@ protected:
      * @return
      */
     std::unique_ptr<RamDomain[]> readNextTuple() override {
-        if (file.eof()) {
+        std::unique_ptr<RamDomain[]> tuple = std::make_unique<RamDomain[]>(symbolMask.size());
+        if (!readTuple(tuple.get())) {
             return nullptr;
         }
+        return tuple;
+    }
+
+    /** Reads a batch of tuples, whose symbols are added to the symbol table at once */
+    size_t readNextTuples(RamDomain* tuples, size_t maxTuples) override {
+        const size_t width = symbolMask.size();
+        size_t numTuples = 0;
+        std::vector<std::string> symbols;
+        while (numTuples < maxTuples && readTuple(tuples + numTuples * width, &symbols)) {
+            numTuples++;
+        }
+        if (symbols.empty()) {
+            return numTuples;
+        }
+        const std::vector<RamDomain> indices = symbolTable.lookup(symbols);
+        for (size_t i = 0; i < numTuples; ++i) {
+            for (size_t column = 0; column < arity; ++column) {
+                if (symbolMask[column]) {
+                    RamDomain& value = tuples[i * width + column];
+                    value = indices[value];
+                }
+            }
+        }
+        return numTuples;
+    }
+
+    /**
+     * Read the next tuple into the given buffer of symbolMask.size() values. If a vector of symbols is
+     * given, symbols are appended to it and their positions are stored in the tuple instead of their
+     * indices in the symbol table.
+     *
+     * Returns false if no tuple was readable.
+     */
+    bool readTuple(RamDomain* tuple, std::vector<std::string>* symbols = nullptr) {
+        if (file.eof()) {
+            return false;
+        }
         std::string line;
-        std::unique_ptr<RamDomain[]> tuple = std::make_unique<RamDomain[]>(symbolMask.size());
+        std::fill(tuple + arity, tuple + symbolMask.size(), 0);
 
         if (!getline(file, line)) {
-            return nullptr;
+            return false;
         }
         // Handle Windows line endings on non-Windows systems
         if (!line.empty() && line.back() == '\r') {
@@ -91,7 +164,12 @@ protected:
             }
             ++columnsFilled;
             if (symbolMask.at(inputMap[column])) {
-                tuple[inputMap[column]] = symbolTable.unsafeLookup(element);
+                if (symbols != nullptr) {
+                    tuple[inputMap[column]] = static_cast<RamDomain>(symbols->size());
+                    symbols->push_back(element);
+                } else {
+                    tuple[inputMap[column]] = symbolTable.unsafeLookup(element);
+                }
             } else {
                 try {
 #if RAM_DOMAIN_SIZE == 64
@@ -108,40 +186,7 @@ protected:
             }
         }
 
-        return tuple;
-    }
-
-    std::string getDelimiter(const IODirectives& ioDirectives) const {
-        if (ioDirectives.has("delimiter")) {
-            return ioDirectives.get("delimiter");
-        }
-        return "\t";
-    }
-
-    std::map<int, int> getInputColumnMap(const IODirectives& ioDirectives, const unsigned arity) const {
-        std::string columnString = "";
-        if (ioDirectives.has("columns")) {
-            columnString = ioDirectives.get("columns");
-        }
-        std::map<int, int> inputMap;
-
-        if (!columnString.empty()) {
-            std::istringstream iss(columnString);
-            std::string mapping;
-            int index = 0;
-            while (std::getline(iss, mapping, ':')) {
-                inputMap[stoi(mapping)] = index++;
-            }
-            if (inputMap.size() < arity) {
-                throw std::invalid_argument("Invalid column set was given: <" + columnString + ">");
-            }
-        } else {
-            while (inputMap.size() < arity) {
-                int size = inputMap.size();
-                inputMap[size] = size;
-            }
-        }
-        return inputMap;
+        return true;
     }
 
     const std::string delimiter;
@@ -185,6 +230,17 @@ public:
         }
     }
 
+    size_t readNextTuples(RamDomain* tuples, size_t maxTuples) override {
+        try {
+            return ReadStreamCSV::readNextTuples(tuples, maxTuples);
+        } catch (std::exception& e) {
+            std::stringstream errorMessage;
+            errorMessage << e.what();
+            errorMessage << "cannot parse fact file " << baseName << "!\n";
+            throw std::invalid_argument(errorMessage.str());
+        }
+    }
+
     ~ReadFileCSV() override = default;
 
 protected:
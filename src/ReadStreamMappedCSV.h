@@ -0,0 +1,377 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2019, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ReadStreamMappedCSV.h
+ *
+ * A CSV reader mapping fact files into memory and parsing them in parallel
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "IODirectives.h"
+#include "MappedFile.h"
+#include "ParallelUtils.h"
+#include "RamTypes.h"
+#include "ReadStream.h"
+#include "ReadStreamCSV.h"
+#include "SymbolTable.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace souffle {
+
+/**
+ * A reader for CSV fact files accepting the same directives as ReadFileCSV.
+ *
+ * The file is mapped into memory and split into line-aligned chunks, which are
+ * parsed in parallel without copying fields. Symbols are collected per chunk and
+ * interned in file order afterwards, such that symbols are numbered exactly as
+ * by ReadFileCSV.
+ */
+class ReadMappedFileCSV : public ReadStream {
+public:
+    ReadMappedFileCSV(const std::vector<bool>& symbolMask, SymbolTable& symbolTable,
+            const IODirectives& ioDirectives, const bool provenance = false)
+            : ReadStream(symbolMask, symbolTable, provenance),
+              delimiter(ReadStreamCSV::getDelimiter(ioDirectives)),
+              baseName(souffle::baseName(getFileName(ioDirectives))),
+              columnMap(getColumnMap(ReadStreamCSV::getInputColumnMap(ioDirectives, arity))) {
+        mapFile(getFileName(ioDirectives), ioDirectives.has("intermediate"));
+
+        // Strip headers if we're using them
+        if (begin != end && ioDirectives.has("headers") && ioDirectives.get("headers") == "true") {
+            const char* newline = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+            begin = (newline == nullptr) ? end : newline + 1;
+        }
+    }
+
+    ~ReadMappedFileCSV() override = default;
+
+protected:
+    /**
+     * Read and return the next tuple.
+     *
+     * The whole file is parsed when the first tuple is requested.
+     *
+     * Returns nullptr if no tuple was readable.
+     * @return
+     */
+    std::unique_ptr<RamDomain[]> readNextTuple() override {
+        std::unique_ptr<RamDomain[]> tuple = std::make_unique<RamDomain[]>(symbolMask.size());
+        if (readNextTuples(tuple.get(), 1) == 0) {
+            return nullptr;
+        }
+        return tuple;
+    }
+
+    size_t readNextTuples(RamDomain* tuples, size_t maxTuples) override {
+        if (!loaded) {
+            load();
+            loaded = true;
+        }
+        const size_t width = symbolMask.size();
+        size_t numTuples = 0;
+        while (numTuples < maxTuples && curChunk < chunks.size()) {
+            Chunk& chunk = chunks[curChunk];
+            const size_t count = std::min(maxTuples - numTuples, chunk.numTuples - curTuple);
+            const RamDomain* src = chunk.tuples.data() + curTuple * width;
+            std::copy(src, src + count * width, tuples + numTuples * width);
+            numTuples += count;
+            curTuple += count;
+            if (curTuple == chunk.numTuples) {
+                // release the memory of exhausted chunks
+                chunk.tuples = std::vector<RamDomain>();
+                curChunk++;
+                curTuple = 0;
+            }
+        }
+        return numTuples;
+    }
+
+    /** The target size of a chunk in bytes */
+    static constexpr size_t CHUNK_SIZE = 1 << 22;
+
+    /** A field of a line, referring into the mapped file */
+    struct Field {
+        const char* begin;
+        const char* end;
+
+        bool operator==(const Field& other) const {
+            return end - begin == other.end - other.begin && std::equal(begin, end, other.begin);
+        }
+    };
+
+    /** FNV-1a hash of the characters of a field */
+    struct FieldHash {
+        size_t operator()(const Field& field) const {
+            uint64_t hash = 14695981039346656037ULL;
+            for (const char* cur = field.begin; cur != field.end; ++cur) {
+                hash = (hash ^ static_cast<unsigned char>(*cur)) * 1099511628211ULL;
+            }
+            return static_cast<size_t>(hash);
+        }
+    };
+
+    /** A line-aligned part of the file and the tuples parsed from it */
+    struct Chunk {
+        const char* begin;
+        const char* end;
+
+        /** Parsed tuples; symbol columns hold indices into symbols until the symbols are interned */
+        std::vector<RamDomain> tuples;
+        size_t numTuples = 0;
+
+        /** Distinct symbols of this chunk in order of their first occurrence */
+        std::vector<Field> symbols;
+
+        /** Number of lines parsed */
+        size_t lines = 0;
+
+        /** Description of the first malformed line, empty if there is none */
+        std::string error;
+
+        Chunk(const char* begin, const char* end) : begin(begin), end(end) {}
+    };
+
+    /** Parse the mapped file in parallel, intern its symbols and check for errors */
+    void load() {
+        // split the file into line-aligned chunks
+        const char* cur = begin;
+        while (cur < end) {
+            const char* next = (size_t(end - cur) < CHUNK_SIZE) ? end : cur + CHUNK_SIZE;
+            if (next < end) {
+                const char* newline = static_cast<const char*>(std::memchr(next, '\n', end - next));
+                next = (newline == nullptr) ? end : newline + 1;
+            }
+            chunks.emplace_back(cur, next);
+            cur = next;
+        }
+
+#pragma omp parallel for schedule(dynamic)
+        for (size_t i = 0; i < chunks.size(); ++i) {  // NOLINT (modernize-loop-convert)
+            parseChunk(chunks[i]);
+        }
+
+        // report the first malformed line of the file
+        size_t lineNumber = 0;
+        for (const auto& chunk : chunks) {
+            if (!chunk.error.empty()) {
+                std::stringstream errorMessage;
+                errorMessage << chunk.error << " in line " << lineNumber + chunk.lines << "; ";
+                errorMessage << "cannot parse fact file " << baseName << "!\n";
+                throw std::invalid_argument(errorMessage.str());
+            }
+            lineNumber += chunk.lines;
+        }
+
+        // intern symbols in file order and replace the chunk-local indices
+        std::vector<size_t> symbolColumns;
+        for (size_t column = 0; column < arity; ++column) {
+            if (symbolMask[column]) {
+                symbolColumns.push_back(column);
+            }
+        }
+        if (symbolColumns.empty()) {
+            return;
+        }
+        std::vector<std::vector<RamDomain>> symbols(chunks.size());
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            std::vector<std::string> strings;
+            strings.reserve(chunks[i].symbols.size());
+            for (const auto& field : chunks[i].symbols) {
+                strings.emplace_back(field.begin, field.end);
+            }
+            symbols[i] = symbolTable.lookup(strings);
+        }
+        const size_t width = symbolMask.size();
+#pragma omp parallel for schedule(dynamic)
+        for (size_t i = 0; i < chunks.size(); ++i) {  // NOLINT (modernize-loop-convert)
+            auto& tuples = chunks[i].tuples;
+            for (size_t t = 0; t < chunks[i].numTuples; ++t) {
+                for (size_t column : symbolColumns) {
+                    RamDomain& value = tuples[t * width + column];
+                    value = symbols[i][value];
+                }
+            }
+        }
+    }
+
+    /** Parse the lines of a chunk, stops at the first malformed line */
+    void parseChunk(Chunk& chunk) const {
+        const size_t width = symbolMask.size();
+        std::unordered_map<Field, RamDomain, FieldHash> localSymbols;
+        const char* cur = chunk.begin;
+        while (cur < chunk.end) {
+            const char* newline = static_cast<const char*>(std::memchr(cur, '\n', chunk.end - cur));
+            const char* lineEnd = (newline == nullptr) ? chunk.end : newline;
+            const char* next = (newline == nullptr) ? chunk.end : newline + 1;
+            // Handle Windows line endings on non-Windows systems
+            if (lineEnd > cur && *(lineEnd - 1) == '\r') {
+                --lineEnd;
+            }
+            ++chunk.lines;
+
+            chunk.tuples.resize(chunk.tuples.size() + width);
+            RamDomain* tuple = &chunk.tuples[chunk.numTuples * width];
+            const char* start = cur;
+            size_t columnsFilled = 0;
+            for (uint32_t column = 0; columnsFilled < arity; column++) {
+                if (start > lineEnd) {
+                    chunk.error = "Values missing";
+                    return;
+                }
+                Field field{start, findDelimiter(start, lineEnd)};
+                start = field.end + delimiter.size();
+
+                if (column >= columnMap.size() || columnMap[column] < 0) {
+                    continue;
+                }
+                const int pos = columnMap[column];
+                ++columnsFilled;
+
+                if (symbolMask[pos]) {
+                    auto it = localSymbols.find(field);
+                    if (it == localSymbols.end()) {
+                        it = localSymbols.emplace(field, chunk.symbols.size()).first;
+                        chunk.symbols.push_back(field);
+                    }
+                    tuple[pos] = it->second;
+                } else if (!parseNumber(field, tuple[pos])) {
+                    std::stringstream errorMessage;
+                    errorMessage << "Error converting number <" << std::string(field.begin, field.end)
+                                 << "> in column " << column + 1;
+                    chunk.error = errorMessage.str();
+                    return;
+                }
+            }
+            chunk.numTuples++;
+            cur = next;
+        }
+    }
+
+    /** Find the next delimiter in the given range, returns the end of the range if there is none */
+    const char* findDelimiter(const char* from, const char* to) const {
+        if (delimiter.size() == 1) {
+            const char* pos = static_cast<const char*>(std::memchr(from, delimiter[0], to - from));
+            return (pos == nullptr) ? to : pos;
+        }
+        return std::search(from, to, delimiter.begin(), delimiter.end());
+    }
+
+    /**
+     * Parse a decimal number with the semantics of std::stoi / std::stoll:
+     * leading whitespace is skipped, and trailing characters are ignored.
+     *
+     * @return false if the field does not start with a number in the range of RamDomain
+     */
+    static bool parseNumber(const Field& field, RamDomain& result) {
+        const char* cur = field.begin;
+        while (cur != field.end && std::isspace(static_cast<unsigned char>(*cur))) {
+            ++cur;
+        }
+        bool negative = false;
+        if (cur != field.end && (*cur == '-' || *cur == '+')) {
+            negative = (*cur == '-');
+            ++cur;
+        }
+        if (cur == field.end || !std::isdigit(static_cast<unsigned char>(*cur))) {
+            return false;
+        }
+        using limit = std::numeric_limits<RamDomain>;
+        const uint64_t bound = negative ? uint64_t(limit::max()) + 1 : uint64_t(limit::max());
+        uint64_t value = 0;
+        for (; cur != field.end && std::isdigit(static_cast<unsigned char>(*cur)); ++cur) {
+            const unsigned digit = *cur - '0';
+            if (value > (bound - digit) / 10) {
+                return false;
+            }
+            value = value * 10 + digit;
+        }
+        result = negative ? static_cast<RamDomain>(0 - value) : static_cast<RamDomain>(value);
+        return true;
+    }
+
+    /** Map the given file into memory */
+    void mapFile(const std::string& fileName, bool intermediate) {
+        if (!file.open(fileName)) {
+            if (intermediate) {
+                return;
+            }
+            throw std::invalid_argument("Cannot open fact file " + baseName + "\n");
+        }
+        begin = file.begin();
+        end = file.end();
+    }
+
+    /** Turn a map from input columns to tuple positions into a vector, unused columns map to -1 */
+    static std::vector<int> getColumnMap(const std::map<int, int>& inputMap) {
+        std::vector<int> columnMap;
+        for (const auto& cur : inputMap) {
+            if (cur.first >= int(columnMap.size())) {
+                columnMap.resize(cur.first + 1, -1);
+            }
+            columnMap[cur.first] = cur.second;
+        }
+        return columnMap;
+    }
+
+    std::string getFileName(const IODirectives& ioDirectives) const {
+        if (ioDirectives.has("filename")) {
+            return ioDirectives.get("filename");
+        }
+        return ioDirectives.getRelationName() + ".facts";
+    }
+
+    const std::string delimiter;
+    std::string baseName;
+    std::vector<int> columnMap;
+
+    /** The mapped file */
+    MappedFile file;
+
+    /** The part of the mapped file holding tuples */
+    const char* begin = nullptr;
+    const char* end = nullptr;
+
+    /** Parsed chunks of the file */
+    std::vector<Chunk> chunks;
+    bool loaded = false;
+
+    /** Position of the next tuple to be returned */
+    size_t curChunk = 0;
+    size_t curTuple = 0;
+};
+
+class ReadMappedFileCSVFactory : public ReadStreamFactory {
+public:
+    std::unique_ptr<ReadStream> getReader(const std::vector<bool>& symbolMask, SymbolTable& symbolTable,
+            const IODirectives& ioDirectives, const bool provenance) override {
+        return std::make_unique<ReadMappedFileCSV>(symbolMask, symbolTable, ioDirectives, provenance);
+    }
+    const std::string& getName() const override {
+        static const std::string name = "mmap";
+        return name;
+    }
+    ~ReadMappedFileCSVFactory() override = default;
+};
+
+} /* namespace souffle */
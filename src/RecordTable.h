@@ -0,0 +1,299 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2019, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file RecordTable.h
+ *
+ * Concurrent record maps, storing the records of the interpreters and of
+ * synthesized programs.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "ParallelUtils.h"
+#include "RamTypes.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace souffle {
+
+namespace detail {
+
+/**
+ * A concurrent bidirectional mapping between tuples of a fixed arity and reference indices.
+ *
+ * Tuples are stored contiguously in blocks of doubling size which are never moved, such
+ * that unpacking is a lock-free lookup. Packing looks up tuples in an open-addressing hash
+ * table split into shards selected by the hash of the tuple, each guarded by its own lock.
+ * Table entries only hold the hash and the index of a tuple, such that packing a known
+ * tuple does not allocate.
+ */
+class ConcurrentRecordMap {
+    /** The first block holds 2^FIRST_BLOCK_BITS tuples, each following block doubles the capacity */
+    static const std::size_t FIRST_BLOCK_BITS = 10;
+
+    /** The number of blocks required to cover all positive references */
+    static const std::size_t NUM_BLOCKS = sizeof(RamDomain) * 8 - FIRST_BLOCK_BITS;
+
+    /** The shards are selected by the upper SHARD_BITS bits of the hash of a tuple */
+    static const std::size_t SHARD_BITS = 6;
+
+    /** The initial number of entries of each shard */
+    static const std::size_t INITIAL_SHARD_SIZE = 16;
+
+    /** An entry of a hash table shard, an index of 0 marks an empty entry */
+    struct Entry {
+        uint32_t hash;
+        RamDomain index;
+    };
+
+    /** A shard of the mapping from tuples to references */
+    struct Shard {
+        SpinLock lock;
+        std::vector<Entry> entries;
+        std::size_t size = 0;
+        std::size_t packs = 0;
+    };
+
+    /** The arity of the stored tuples */
+    const std::size_t arity;
+
+    /** The mapping from tuples to references/indices */
+    std::array<Shard, (1 << SHARD_BITS)> shards;
+
+    /** The mapping from indices to tuples, allocated on demand */
+    std::array<std::atomic<RamDomain*>, NUM_BLOCKS> blocks;
+
+    /** The next index to be assigned; index 0 is left free for the null reference */
+    std::atomic<std::size_t> next;
+
+public:
+    ConcurrentRecordMap(std::size_t arity) : arity(arity), next(1) {
+        for (auto& shard : shards) {
+            shard.entries.resize(INITIAL_SHARD_SIZE, Entry{0, 0});
+        }
+        for (auto& block : blocks) {
+            block.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ConcurrentRecordMap(const ConcurrentRecordMap&) = delete;
+    ConcurrentRecordMap& operator=(const ConcurrentRecordMap&) = delete;
+
+    ~ConcurrentRecordMap() {
+        for (auto& block : blocks) {
+            delete[] block.load(std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Packs the given tuple -- and may create a new reference if necessary.
+     */
+    RamDomain pack(const RamDomain* tuple) {
+        const uint64_t h = hash(tuple);
+        const uint32_t tag = uint32_t(h);
+        Shard& shard = shards[h >> (64 - SHARD_BITS)];
+
+        std::lock_guard<SpinLock> guard(shard.lock);
+        ++shard.packs;
+
+        // try lookup, probing linearly from the position of the hash
+        std::size_t mask = shard.entries.size() - 1;
+        std::size_t pos = tag & mask;
+        while (shard.entries[pos].index != 0) {
+            const Entry& entry = shard.entries[pos];
+            if (entry.hash == tag && std::equal(tuple, tuple + arity, unpack(entry.index))) {
+                return entry.index;
+            }
+            pos = (pos + 1) & mask;
+        }
+
+        // assign a new index and store a copy of the tuple
+        const std::size_t index = next.fetch_add(1, std::memory_order_relaxed);
+
+        // assert that new index is smaller than the range
+        assert(index < std::size_t(std::numeric_limits<RamDomain>::max()));
+
+        std::copy(tuple, tuple + arity, getSlot(index));
+        shard.entries[pos] = Entry{tag, RamDomain(index)};
+
+        // keep the load factor of the shard below one half
+        if (2 * ++shard.size > shard.entries.size()) {
+            grow(shard);
+        }
+        return RamDomain(index);
+    }
+
+    /**
+     * Obtains a pointer to the tuple addressed by the given index.
+     */
+    const RamDomain* unpack(RamDomain index) const {
+        std::size_t block;
+        std::size_t offset;
+        locate(index, block, offset);
+        return blocks[block].load(std::memory_order_acquire) + offset * arity;
+    }
+
+    /**
+     * Obtains the number of stored tuples.
+     */
+    std::size_t size() const {
+        return next.load(std::memory_order_relaxed) - 1;
+    }
+
+    /**
+     * Obtains the number of pack operations conducted so far; those not creating
+     * a new tuple were hits.
+     */
+    std::size_t getPackCount() {
+        std::size_t res = 0;
+        for (auto& shard : shards) {
+            std::lock_guard<SpinLock> guard(shard.lock);
+            res += shard.packs;
+        }
+        return res;
+    }
+
+private:
+    /** Hashes a tuple of the arity of this map */
+    uint64_t hash(const RamDomain* tuple) const {
+        return hashTuple(tuple, arity);
+    }
+
+    /** Doubles the number of entries of the given shard */
+    static void grow(Shard& shard) {
+        std::vector<Entry> entries(2 * shard.entries.size(), Entry{0, 0});
+        const std::size_t mask = entries.size() - 1;
+        for (const Entry& entry : shard.entries) {
+            if (entry.index == 0) {
+                continue;
+            }
+            std::size_t pos = entry.hash & mask;
+            while (entries[pos].index != 0) {
+                pos = (pos + 1) & mask;
+            }
+            entries[pos] = entry;
+        }
+        shard.entries.swap(entries);
+    }
+
+    /** Determines the block and the offset within the block of the given index */
+    static void locate(std::size_t index, std::size_t& block, std::size_t& offset) {
+        const uint64_t pos = uint64_t(index) + (uint64_t(1) << FIRST_BLOCK_BITS);
+        const std::size_t bits = 63 - __builtin_clzll(pos);
+        block = bits - FIRST_BLOCK_BITS;
+        offset = pos - (uint64_t(1) << bits);
+    }
+
+    /** Obtains the storage of the tuple of the given index, allocating its block if necessary */
+    RamDomain* getSlot(std::size_t index) {
+        std::size_t block;
+        std::size_t offset;
+        locate(index, block, offset);
+        RamDomain* cur = blocks[block].load(std::memory_order_acquire);
+        if (cur == nullptr) {
+            // the first thread to reach a block allocates it, others discard their copy
+            auto* fresh = new RamDomain[(std::size_t(1) << (FIRST_BLOCK_BITS + block)) * arity];
+            if (blocks[block].compare_exchange_strong(cur, fresh, std::memory_order_acq_rel)) {
+                cur = fresh;
+            } else {
+                delete[] fresh;
+            }
+        }
+        return cur + offset * arity;
+    }
+};
+
+}  // namespace detail
+
+/**
+ * A concurrent table of records of any arity, mapping tuples to references and back.
+ */
+class RecordTable {
+    /** The number of arities for which the record maps are located without locking */
+    static const std::size_t NUM_SMALL_ARITIES = 64;
+
+    /** The record maps of small arities, created on demand */
+    std::array<std::atomic<detail::ConcurrentRecordMap*>, NUM_SMALL_ARITIES> small;
+
+    /** The record maps of larger arities */
+    std::map<std::size_t, std::unique_ptr<detail::ConcurrentRecordMap>> large;
+
+    /** a lock for the record maps of larger arities */
+    Lock large_lock;
+
+public:
+    RecordTable() {
+        for (auto& map : small) {
+            map.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    RecordTable(const RecordTable&) = delete;
+    RecordTable& operator=(const RecordTable&) = delete;
+
+    ~RecordTable() {
+        for (auto& map : small) {
+            delete map.load(std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Packs the given tuple of the given arity -- and may create a new reference if necessary.
+     */
+    RamDomain pack(const RamDomain* tuple, std::size_t arity) {
+        return getForArity(arity).pack(tuple);
+    }
+
+    /**
+     * Obtains a pointer to the tuple of the given arity addressed by the given reference.
+     */
+    const RamDomain* unpack(RamDomain ref, std::size_t arity) {
+        return getForArity(arity).unpack(ref);
+    }
+
+private:
+    /** Obtains the record map of the given arity, creating it if necessary */
+    detail::ConcurrentRecordMap& getForArity(std::size_t arity) {
+        if (arity < NUM_SMALL_ARITIES) {
+            detail::ConcurrentRecordMap* cur = small[arity].load(std::memory_order_acquire);
+            if (cur == nullptr) {
+                auto* fresh = new detail::ConcurrentRecordMap(arity);
+                if (small[arity].compare_exchange_strong(cur, fresh, std::memory_order_acq_rel)) {
+                    cur = fresh;
+                } else {
+                    delete fresh;
+                }
+            }
+            return *cur;
+        }
+
+        auto lease = large_lock.acquire();
+        (void)lease;
+        auto& map = large[arity];
+        if (!map) {
+            map = std::make_unique<detail::ConcurrentRecordMap>(arity);
+        }
+        return *map;
+    }
+};
+
+}  // end of namespace souffle
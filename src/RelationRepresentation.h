@@ -28,6 +28,8 @@ enum class RelationRepresentation {
     BTREE,
     // btree data-structure
     BRIE,
+    // btree indexes referencing a single copy of each tuple
+    INDIRECT,
     // equivalence relation
     EQREL
 };
@@ -40,6 +42,9 @@ inline std::ostream& operator<<(std::ostream& os, RelationRepresentation structu
         case RelationRepresentation::BRIE:
             os << "brie";
             break;
+        case RelationRepresentation::INDIRECT:
+            os << "indirect";
+            break;
         case RelationRepresentation::EQREL:
             os << "eqrel";
             break;
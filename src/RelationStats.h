@@ -0,0 +1,180 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2019, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file RelationStats.h
+ *
+ * Sampling-based cardinality statistics of relations
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "ProfileEvent.h"
+#include "RamTypes.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace souffle {
+
+/**
+ * Statistics of the columns of a relation, i.e., the number of distinct values
+ * and the frequency of the most common value of each column, estimated from a
+ * uniform random sample of its tuples.
+ */
+class RelationStats {
+    /** The number of tuples of the relation */
+    std::size_t size = 0;
+
+    /** The number of sampled tuples */
+    std::size_t sampleSize = 0;
+
+    /** The estimated number of distinct values of each column */
+    std::vector<std::size_t> distinct;
+
+    /** The estimated number of occurrences of the most common value of each column */
+    std::vector<std::size_t> maxFrequency;
+
+public:
+    /** The default number of sampled tuples, sufficient for an estimation error of a few percent */
+    static const std::size_t DEFAULT_SAMPLE_SIZE = 1000;
+
+    RelationStats(std::size_t arity = 0) : distinct(arity, 0), maxFrequency(arity, 0) {}
+
+    /**
+     * Extracts the statistics of the given relation of the given arity from a sample of
+     * at most the given number of tuples. Relations are required to be iterable, yielding
+     * tuples supporting the subscript operator, and to provide their size.
+     */
+    template <typename Relation>
+    static RelationStats extractFrom(
+            const Relation& rel, std::size_t arity, std::size_t maxSampleSize = DEFAULT_SAMPLE_SIZE) {
+        RelationStats res(arity);
+        res.size = rel.size();
+
+        // reservoir sampling, seeded deterministically for reproducible statistics
+        std::vector<RamDomain> sample;
+        sample.reserve(std::min(res.size, maxSampleSize) * arity);
+        std::mt19937 random(0);
+        std::size_t seen = 0;
+        for (const auto& tuple : rel) {
+            std::size_t slot = seen++;
+            if (slot >= maxSampleSize) {
+                slot = std::uniform_int_distribution<std::size_t>(0, slot)(random);
+                if (slot >= maxSampleSize) {
+                    continue;
+                }
+            } else {
+                sample.resize(sample.size() + arity);
+            }
+            for (std::size_t i = 0; i < arity; ++i) {
+                sample[slot * arity + i] = tuple[i];
+            }
+        }
+        res.size = std::max(res.size, seen);
+        res.sampleSize = std::min(seen, maxSampleSize);
+
+        for (std::size_t i = 0; i < arity; ++i) {
+            res.estimateColumn(sample, arity, i);
+        }
+        return res;
+    }
+
+    /** Obtains the number of tuples of the relation */
+    std::size_t getCardinality() const {
+        return size;
+    }
+
+    /** Obtains the number of sampled tuples */
+    std::size_t getSampleSize() const {
+        return sampleSize;
+    }
+
+    /** Obtains the arity of the relation */
+    std::size_t getArity() const {
+        return distinct.size();
+    }
+
+    /** Obtains the estimated number of distinct values of the given column */
+    std::size_t getEstimatedCardinality(std::size_t column) const {
+        return distinct[column];
+    }
+
+    /** Obtains the estimated number of occurrences of the most common value of the given column */
+    std::size_t getEstimatedMaxFrequency(std::size_t column) const {
+        return maxFrequency[column];
+    }
+
+    /**
+     * Obtains the skew of the given column, i.e., the ratio between the frequency of its
+     * most common value and the average frequency of its values; 1 for uniform columns.
+     */
+    double getSkew(std::size_t column) const {
+        if (distinct[column] == 0) {
+            return 1;
+        }
+        return maxFrequency[column] * double(distinct[column]) / size;
+    }
+
+    /**
+     * Logs the statistics to the profile, as quantity events of the given message,
+     * extended by the column and the kind of the statistic.
+     */
+    void logTo(const std::string& message) const {
+        auto& profile = ProfileEventSingleton::instance();
+        profile.makeQuantityEvent(message + "sample-size", sampleSize, 0);
+        for (std::size_t i = 0; i < distinct.size(); ++i) {
+            const std::string column = message + std::to_string(i) + ";";
+            profile.makeQuantityEvent(column + "distinct", distinct[i], 0);
+            profile.makeQuantityEvent(column + "max-frequency", maxFrequency[i], 0);
+        }
+    }
+
+private:
+    /**
+     * Estimates the statistics of a column from the sample, using the Duj1 estimator of
+     * Haas et al. for the number of distinct values: d / (1 - (1 - q) * f1 / r), where
+     * d values are distinct and f1 values are unique among r sampled tuples, and q = r / n
+     * is the sampled fraction of the n tuples.
+     */
+    void estimateColumn(const std::vector<RamDomain>& sample, std::size_t arity, std::size_t column) {
+        if (sampleSize == 0) {
+            return;
+        }
+
+        std::unordered_map<RamDomain, std::size_t> counts;
+        for (std::size_t j = 0; j < sampleSize; ++j) {
+            counts[sample[j * arity + column]]++;
+        }
+
+        std::size_t unique = 0;
+        std::size_t maxCount = 0;
+        for (const auto& cur : counts) {
+            unique += (cur.second == 1) ? 1 : 0;
+            maxCount = std::max(maxCount, cur.second);
+        }
+
+        const double r = sampleSize;
+        const double q = r / size;
+        const double estimate = counts.size() / (1 - (1 - q) * unique / r);
+        distinct[column] = std::max<std::size_t>(counts.size(), std::min<double>(estimate, size) + 0.5);
+
+        // values not repeated within the sample are assumed to occur with the average frequency
+        const std::size_t average = (size + distinct[column] - 1) / distinct[column];
+        const std::size_t scaled = (maxCount > 1) ? maxCount * size / sampleSize : 0;
+        maxFrequency[column] = std::max(average, scaled);
+    }
+};
+
+}  // end of namespace souffle
@@ -23,9 +23,14 @@
 #include "AstRelation.h"
 #include "AstTransforms.h"
 #include "AstTranslationUnit.h"
+#include "AstUtils.h"
 #include "AstVisitor.h"
 #include "Global.h"
+#include "PrecedenceGraph.h"
+#include <algorithm>
 #include <cmath>
+#include <functional>
+#include <memory>
 #include <set>
 #include <string>
 #include <utility>
@@ -45,21 +50,25 @@ inline bool isProposition(const AstAtom* atom) {
 /**
  * Counts the number of bound arguments in a given atom.
  */
+bool isBoundArgument(const AstArgument* arg, const std::set<std::string>& boundVariables) {
+    // argument is bound iff all contained variables are bound
+    bool isBound = true;
+
+    visitDepthFirst(*arg, [&](const AstVariable& var) {
+        if (boundVariables.find(var.getName()) == boundVariables.end()) {
+            // found an unbound variable, so argument is unbound
+            isBound = false;
+        }
+    });
+
+    return isBound;
+}
+
 unsigned int numBoundArguments(const AstAtom* atom, const std::set<std::string>& boundVariables) {
     int count = 0;
 
     for (const AstArgument* arg : atom->getArguments()) {
-        // argument is bound iff all contained variables are bound
-        bool isBound = true;
-
-        visitDepthFirst(*arg, [&](const AstVariable& var) {
-            if (boundVariables.find(var.getName()) == boundVariables.end()) {
-                // found an unbound variable, so argument is unbound
-                isBound = false;
-            }
-        });
-
-        if (isBound) {
+        if (isBoundArgument(arg, boundVariables)) {
             count++;
         }
     }
@@ -379,48 +388,115 @@ bool ReorderLiteralsTransformer::transform(AstTranslationUnit& translationUnit)
         // parse supplied profile information
         auto* profileUse = translationUnit.getAnalysis<AstProfileUse>();
 
-        auto profilerSips = [&](std::vector<AstAtom*> atoms, const std::set<std::string>& boundVariables) {
-            // Goal: reorder based on the given profiling information
-            // Metric: cost(atom_R) = log(|atom_R|) * #free/#args
-            //         - exception: propositions are prioritised
+        // obtains a SIPS function costing atoms by the relation sizes given by the size function
+        auto getProfilerSips = [&](const std::function<double(const AstAtom*)>& getSize) -> sips_t {
+            return [=](std::vector<AstAtom*> atoms, const std::set<std::string>& boundVariables) {
+                // Goal: reorder based on the given profiling information
+                // Metric: cost(atom_R) = log(|atom_R|) * #free/#args
+                //         - with column statistics: the expected number of tuples matching the
+                //           bound arguments, log(|atom_R|) - sum of log(#distinct) of bound columns
+                //         - exception: propositions are prioritised
+
+                double currOptimalVal = -1;
+                unsigned int currOptimalIdx = 0U;
+                bool set = false;
+
+                for (unsigned int i = 0; i < atoms.size(); i++) {
+                    const AstAtom* currAtom = atoms[i];
+
+                    if (currAtom == nullptr) {
+                        // already processed - move on
+                        continue;
+                    }
 
-            double currOptimalVal = -1;
-            unsigned int currOptimalIdx = 0U;
-            bool set = false;
+                    if (isProposition(currAtom)) {
+                        // prioritise propositions
+                        return i;
+                    }
 
-            for (unsigned int i = 0; i < atoms.size(); i++) {
-                const AstAtom* currAtom = atoms[i];
+                    double value = log(getSize(currAtom));
+                    double selectivity = 0;
+                    bool hasStatistics = true;
+                    const auto& args = currAtom->getArguments();
+                    for (size_t j = 0; j < args.size() && hasStatistics; j++) {
+                        if (isBoundArgument(args[j], boundVariables)) {
+                            const size_t distinct = profileUse->getDistinctValues(currAtom->getName(), j);
+                            hasStatistics = distinct > 0;
+                            selectivity += log(std::max<size_t>(distinct, 1));
+                        }
+                    }
 
-                if (currAtom == nullptr) {
-                    // already processed - move on
-                    continue;
-                }
+                    if (hasStatistics) {
+                        // calculate log(|R|) - sum(log(#distinct)) over the bound columns
+                        value = std::max(0.0, value - selectivity);
+                    } else {
+                        // calculate log(|R|) * #free/#args
+                        int numBound = numBoundArguments(currAtom, boundVariables);
+                        int numArgs = currAtom->getArity();
+                        int numFree = numArgs - numBound;
+                        value *= (numFree * 1.0) / numArgs;
+                    }
 
-                if (isProposition(currAtom)) {
-                    // prioritise propositions
-                    return i;
+                    if (!set || value < currOptimalVal) {
+                        set = true;
+                        currOptimalVal = value;
+                        currOptimalIdx = i;
+                    }
                 }
 
-                // calculate log(|R|) * #free/#args
-                int numBound = numBoundArguments(currAtom, boundVariables);
-                int numArgs = currAtom->getArity();
-                int numFree = numArgs - numBound;
-                double value = log(profileUse->getRelationSize(currAtom->getName()));
-                value *= (numFree * 1.0) / numArgs;
-
-                if (!set || value < currOptimalVal) {
-                    set = true;
-                    currOptimalVal = value;
-                    currOptimalIdx = i;
-                }
-            }
+                return currOptimalIdx;
+            };
+        };
 
-            return currOptimalIdx;
+        auto getRelationSize = [&](const AstAtom* atom) -> double {
+            return profileUse->getRelationSize(atom->getName());
         };
+        sips_t profilerSips = getProfilerSips(getRelationSize);
+
+        const auto* sccGraph = translationUnit.getAnalysis<SCCGraph>();
+        const auto* recursiveClauses = translationUnit.getAnalysis<RecursiveClauses>();
 
         for (const AstRelation* rel : program.getRelations()) {
             for (AstClause* clause : rel->getClauses()) {
+                // ignore clauses with fixed execution plans
+                if (clause->getExecutionPlan() != nullptr) {
+                    continue;
+                }
+
                 changed |= reorderClauseWithSips(profilerSips, clause);
+
+                // the magic-set transformation rewrites clauses after the reordering
+                if (!recursiveClauses->recursive(clause) || Global::config().has("magic-transform")) {
+                    continue;
+                }
+
+                // each recursive clause is evaluated in one version per atom of its SCC, reading the
+                // delta of that atom -- order every version for the size of its delta relation
+                const size_t scc = sccGraph->getSCC(rel);
+                auto plan = std::make_unique<AstExecutionPlan>();
+                int version = 0;
+                for (const AstAtom* deltaAtom : clause->getAtoms()) {
+                    const AstRelation* atomRelation = getAtomRelation(deltaAtom, &program);
+                    if (atomRelation == nullptr || sccGraph->getSCC(atomRelation) != scc) {
+                        continue;
+                    }
+
+                    const double deltaSize = profileUse->getDeltaSize(deltaAtom->getName());
+                    sips_t deltaSips = getProfilerSips([&, deltaAtom, deltaSize](const AstAtom* atom) {
+                        return atom == deltaAtom ? deltaSize : getRelationSize(atom);
+                    });
+
+                    auto order = std::make_unique<AstExecutionOrder>();
+                    for (unsigned int i : applySips(deltaSips, clause->getAtoms())) {
+                        order->appendAtomIndex(i + 1);
+                    }
+                    plan->setOrderFor(version++, std::move(order));
+                }
+
+                if (version > 0) {
+                    clause->setExecutionPlan(std::move(plan));
+                    changed = true;
+                }
             }
         }
     }
@@ -0,0 +1,336 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2019, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file SimdSearch.h
+ *
+ * A b-tree search strategy comparing several tuples of a node at once
+ * using SSE4.1 or AVX2 instructions
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "BTree.h"
+#include "CompiledTuple.h"
+#include "RamTypes.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+// vector instructions are used for 32 bit domains on x86 processors, if the compiler supports
+// enabling them for individual functions
+#if RAM_DOMAIN_SIZE == 32 && (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define SOUFFLE_SIMD_SEARCH
+#include <immintrin.h>
+#define SOUFFLE_TARGET_SSE4 __attribute__((target("sse4.1")))
+#define SOUFFLE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace souffle {
+
+namespace ram {
+namespace index_utils {
+template <unsigned... Columns>
+struct comparator;
+}  // namespace index_utils
+}  // namespace ram
+
+namespace simd_utils {
+
+/** The vector instruction sets utilized for searching */
+enum class InstructionSet { NONE, SSE4, AVX2 };
+
+/** Obtains the best instruction set supported by the processor running this program */
+inline InstructionSet getInstructionSet() {
+#ifdef SOUFFLE_SIMD_SEARCH
+    static const InstructionSet supported = __builtin_cpu_supports("avx2")
+                                                    ? InstructionSet::AVX2
+                                                    : (__builtin_cpu_supports("sse4.1") ? InstructionSet::SSE4
+                                                                                        : InstructionSet::NONE);
+    return supported;
+#else
+    return InstructionSet::NONE;
+#endif
+}
+
+#ifdef SOUFFLE_SIMD_SEARCH
+
+/**
+ * Obtains the index of the first of the n tuples of the given arity stored at keys
+ * that is not less than k (or, if Inclusive, greater than k) with respect to the
+ * lexicographical order of the given columns. The tuples have to be sorted.
+ *
+ * Eight tuples are compared at once: their values are loaded into Arity vectors,
+ * each column of the tuples is permuted into a vector of its own, and the per-column
+ * comparisons are combined into a lexicographical one.
+ */
+template <std::size_t Arity, bool Inclusive, unsigned... Columns>
+SOUFFLE_TARGET_AVX2 std::size_t scanAVX2(const RamDomain* keys, std::size_t n, const RamDomain* k) {
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    constexpr std::size_t numColumns = sizeof...(Columns);
+    const unsigned columns[numColumns] = {Columns...};
+
+    // lane j of the vector of column c holds value j * Arity + c, located in vector (j * Arity + c) / 8
+    __m256i index[numColumns];
+    __m256i source[numColumns];
+    __m256i key[numColumns];
+    for (std::size_t c = 0; c < numColumns; ++c) {
+        const __m256i pos = _mm256_add_epi32(
+                _mm256_mullo_epi32(lanes, _mm256_set1_epi32(Arity)), _mm256_set1_epi32(columns[c]));
+        index[c] = _mm256_and_si256(pos, _mm256_set1_epi32(7));
+        source[c] = _mm256_srli_epi32(pos, 3);
+        key[c] = _mm256_set1_epi32(k[columns[c]]);
+    }
+
+    for (std::size_t i = 0; i < n; i += 8, keys += 8 * Arity) {
+        // values beyond the last tuple are not loaded, and those lanes do not compare less
+        const int count = int(n - i < 8 ? n - i : 8);
+        const __m256i valid = _mm256_cmpgt_epi32(_mm256_set1_epi32(count), lanes);
+        __m256i values[Arity];
+        for (std::size_t r = 0; r < Arity; ++r) {
+            if (count == 8) {
+                values[r] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + 8 * r));
+            } else {
+                const __m256i loaded =
+                        _mm256_cmpgt_epi32(_mm256_set1_epi32(count * int(Arity) - 8 * int(r)), lanes);
+                values[r] = _mm256_maskload_epi32(keys + 8 * r, loaded);
+            }
+        }
+
+        __m256i less = _mm256_setzero_si256();
+        __m256i equal = valid;
+        for (std::size_t c = 0; c < numColumns; ++c) {
+            __m256i column = _mm256_permutevar8x32_epi32(values[0], index[c]);
+            for (std::size_t r = 1; r < Arity; ++r) {
+                column = _mm256_blendv_epi8(column, _mm256_permutevar8x32_epi32(values[r], index[c]),
+                        _mm256_cmpeq_epi32(source[c], _mm256_set1_epi32(r)));
+            }
+            less = _mm256_or_si256(less, _mm256_and_si256(equal, _mm256_cmpgt_epi32(key[c], column)));
+            equal = _mm256_and_si256(equal, _mm256_cmpeq_epi32(key[c], column));
+            // the remaining columns only matter for tuples with an equal prefix
+            if (_mm256_testz_si256(equal, equal)) {
+                break;
+            }
+        }
+        if (Inclusive) {
+            less = _mm256_or_si256(less, equal);
+        }
+        const unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(less));
+        if (mask != 0xff) {
+            return i + __builtin_ctz(~mask);
+        }
+    }
+    return n;
+}
+
+/**
+ * The version of scanAVX2 for tuples of two columns compared by both columns, which
+ * compares four tuples at once as 64 bit integers. The leading column forms the upper
+ * half of the integer, and the sign bit of the other column is flipped, such that the
+ * signed order of the integers is the lexicographical order of the tuples.
+ *
+ * @tparam Swap whether the leading column is the first column of the tuples
+ */
+template <bool Inclusive, bool Swap>
+SOUFFLE_TARGET_AVX2 std::size_t scanPairsAVX2(const RamDomain* keys, std::size_t n, const RamDomain* k) {
+    const __m256i lanes = _mm256_setr_epi64x(0, 1, 2, 3);
+    const __m256i bias = _mm256_set1_epi64x(0x80000000ll);
+    const uint64_t leading = uint32_t(Swap ? k[0] : k[1]);
+    const uint32_t trailing = uint32_t(Swap ? k[1] : k[0]);
+    const __m256i key = _mm256_set1_epi64x((leading << 32) | (trailing ^ 0x80000000u));
+    for (std::size_t i = 0; i < n; i += 4, keys += 8) {
+        // tuples beyond the last tuple are not loaded and do not compare less
+        const long long count = (long long)(n - i < 4 ? n - i : 4);
+        const __m256i valid = _mm256_cmpgt_epi64(_mm256_set1_epi64x(count), lanes);
+        __m256i values = (count == 4) ? _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys))
+                                      : _mm256_maskload_epi64(reinterpret_cast<const long long*>(keys), valid);
+        if (Swap) {
+            values = _mm256_shuffle_epi32(values, _MM_SHUFFLE(2, 3, 0, 1));
+        }
+        values = _mm256_xor_si256(values, bias);
+        const __m256i less = Inclusive ? _mm256_andnot_si256(_mm256_cmpgt_epi64(values, key), valid)
+                                       : _mm256_and_si256(_mm256_cmpgt_epi64(key, values), valid);
+        const unsigned mask = _mm256_movemask_pd(_mm256_castsi256_pd(less));
+        if (mask != 0xf) {
+            return i + __builtin_ctz(~mask);
+        }
+    }
+    return n;
+}
+
+/**
+ * Selects the AVX2 version of scan for the given tuples and columns.
+ */
+template <std::size_t Arity, bool Inclusive, unsigned... Columns>
+struct scanner_avx2 {
+    static std::size_t scan(const RamDomain* keys, std::size_t n, const RamDomain* k) {
+        return scanAVX2<Arity, Inclusive, Columns...>(keys, n, k);
+    }
+};
+
+template <bool Inclusive>
+struct scanner_avx2<2, Inclusive, 0, 1> {
+    static std::size_t scan(const RamDomain* keys, std::size_t n, const RamDomain* k) {
+        return scanPairsAVX2<Inclusive, true>(keys, n, k);
+    }
+};
+
+template <bool Inclusive>
+struct scanner_avx2<2, Inclusive, 1, 0> {
+    static std::size_t scan(const RamDomain* keys, std::size_t n, const RamDomain* k) {
+        return scanPairsAVX2<Inclusive, false>(keys, n, k);
+    }
+};
+
+/**
+ * The SSE4.1 version of scanAVX2, comparing four tuples at once.
+ */
+template <std::size_t Arity, bool Inclusive, unsigned... Columns>
+SOUFFLE_TARGET_SSE4 std::size_t scanSSE4(const RamDomain* keys, std::size_t n, const RamDomain* k) {
+    const __m128i lanes = _mm_setr_epi32(0, 1, 2, 3);
+    for (std::size_t i = 0; i < n; i += 4) {
+        // lanes beyond the last tuple repeat the last tuple and do not compare less
+        const std::size_t last = n - i - 1;
+        const RamDomain* t0 = keys + i * Arity;
+        const RamDomain* t1 = keys + (i + (last < 1 ? last : 1)) * Arity;
+        const RamDomain* t2 = keys + (i + (last < 2 ? last : 2)) * Arity;
+        const RamDomain* t3 = keys + (i + (last < 3 ? last : 3)) * Arity;
+        const __m128i valid = _mm_cmpgt_epi32(_mm_set1_epi32(int(last + 1 < 4 ? last + 1 : 4)), lanes);
+        __m128i less = _mm_setzero_si128();
+        __m128i equal = valid;
+        for (unsigned col : std::initializer_list<unsigned>{Columns...}) {
+            __m128i values = _mm_cvtsi32_si128(t0[col]);
+            values = _mm_insert_epi32(values, t1[col], 1);
+            values = _mm_insert_epi32(values, t2[col], 2);
+            values = _mm_insert_epi32(values, t3[col], 3);
+            const __m128i key = _mm_set1_epi32(k[col]);
+            less = _mm_or_si128(less, _mm_and_si128(equal, _mm_cmpgt_epi32(key, values)));
+            equal = _mm_and_si128(equal, _mm_cmpeq_epi32(key, values));
+            // the remaining columns only matter for tuples with an equal prefix
+            if (_mm_testz_si128(equal, equal)) {
+                break;
+            }
+        }
+        if (Inclusive) {
+            less = _mm_or_si128(less, equal);
+        }
+        const unsigned mask = _mm_movemask_ps(_mm_castsi128_ps(less));
+        if (mask != 0xf) {
+            return i + __builtin_ctz(~mask);
+        }
+    }
+    return n;
+}
+
+#endif
+
+/**
+ * Obtains the index of the first of the n sorted tuples at keys not less than
+ * (or, if Inclusive, greater than) k, using the best available instruction set.
+ * Returns n + 1 if no vector instructions are available.
+ */
+template <std::size_t Arity, bool Inclusive, unsigned... Columns>
+inline std::size_t scan(const RamDomain* keys, std::size_t n, const RamDomain* k) {
+#if defined(SOUFFLE_SIMD_SEARCH) && defined(__AVX2__)
+    // selected at compile time
+    return scanner_avx2<Arity, Inclusive, Columns...>::scan(keys, n, k);
+#elif defined(SOUFFLE_SIMD_SEARCH)
+    // selected at runtime
+    switch (getInstructionSet()) {
+        case InstructionSet::AVX2:
+            return scanner_avx2<Arity, Inclusive, Columns...>::scan(keys, n, k);
+        case InstructionSet::SSE4:
+            return scanSSE4<Arity, Inclusive, Columns...>(keys, n, k);
+        default:
+            return n + 1;
+    }
+#else
+    return n + 1;
+#endif
+}
+
+}  // end of namespace simd_utils
+
+namespace detail {
+
+/**
+ * A search strategy for b-tree nodes comparing several tuples at once using
+ * vector instructions. It covers tuples of the RAM domain compared by an index
+ * comparator, and falls back to binary search for other keys and on processors
+ * without SSE4.1 support.
+ */
+struct simd_search : public search_strategy {
+    /**
+     * Required user-defined default constructor.
+     */
+    simd_search() = default;
+
+    /**
+     * Obtains an iterator referencing an element equivalent to the
+     * given key in the given range. If no such element is present,
+     * a reference to the first element not less than the given key
+     * is returned.
+     */
+    template <typename Key, typename Iter, typename Comp>
+    inline Iter operator()(const Key& k, Iter a, Iter b, Comp& comp) const {
+        return lower_bound(k, a, b, comp);
+    }
+
+    /**
+     * Obtains a reference to the first element in the given range that
+     * is not less than the given key.
+     */
+    template <typename Key, typename Iter, typename Comp>
+    inline Iter lower_bound(const Key& k, Iter a, Iter b, Comp& comp) const {
+        return binary_search().lower_bound(k, a, b, comp);
+    }
+
+    template <typename Iter, std::size_t Arity, unsigned... Columns>
+    inline Iter lower_bound(const ram::Tuple<RamDomain, Arity>& k, Iter a, Iter b,
+            ram::index_utils::comparator<Columns...>& comp) const {
+        const std::size_t n = b - a;
+        const std::size_t pos = simd_utils::scan<Arity, false, Columns...>(a->data, n, k.data);
+        return (pos <= n) ? a + pos : binary_search().lower_bound(k, a, b, comp);
+    }
+
+    /**
+     * Obtains a reference to the first element in the given range that
+     * such that the given key is less than the referenced element.
+     */
+    template <typename Key, typename Iter, typename Comp>
+    inline Iter upper_bound(const Key& k, Iter a, Iter b, Comp& comp) const {
+        return binary_search().upper_bound(k, a, b, comp);
+    }
+
+    template <typename Iter, std::size_t Arity, unsigned... Columns>
+    inline Iter upper_bound(const ram::Tuple<RamDomain, Arity>& k, Iter a, Iter b,
+            ram::index_utils::comparator<Columns...>& comp) const {
+        const std::size_t n = b - a;
+        const std::size_t pos = simd_utils::scan<Arity, true, Columns...>(a->data, n, k.data);
+        return (pos <= n) ? a + pos : binary_search().upper_bound(k, a, b, comp);
+    }
+};
+
+struct simd : public strategy_selection<simd_search> {};
+
+#ifdef SOUFFLE_SIMD_SEARCH
+// unary and binary tuples are searched using vector instructions, selected at compile time if the
+// target supports AVX2 (as for synthesized programs) and at runtime otherwise (as in the interpreters)
+template <>
+struct default_strategy<ram::Tuple<RamDomain, 1>> : public simd {};
+
+template <>
+struct default_strategy<ram::Tuple<RamDomain, 2>> : public simd {};
+#endif
+
+}  // end of namespace detail
+
+}  // end of namespace souffle
@@ -17,6 +17,7 @@
 #pragma once
 
 #include "ParallelUtils.h"
+#include "PiggyList.h"
 #include "RamTypes.h"
 #include "Util.h"
 
@@ -25,10 +26,12 @@
 #include <thread>
 #endif
 
+#include <array>
+#include <atomic>
 #include <cassert>
-#include <deque>
 #include <initializer_list>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <unordered_map>
 
@@ -40,52 +43,108 @@ namespace souffle {
  * Global pool of re-usable strings
  *
  * SymbolTable stores Datalog symbols and converts them to numbers and vice versa.
+ * The string-to-index map is sharded by the hash of the string, such that parallel
+ * lookups only contend on the same shard, and resolving an index is wait-free.
  */
 class SymbolTable {
 #ifdef USE_MPI
 
 private:
-    enum {
-        EXIT = 0,
-        INSERT_STRING = 1,
-        INSERT_VECTOR_STRING = 2,
-        LOOKUP = 3,
-        LOOKUP_EXISTING = 4,
-        PRINT = 5,
-        RESOLVE = 6,
-        SIZE = 7,
-        UNSAFE_LOOKUP = 8,
-        UNSAFE_RESOLVE = 9
-    };
+    enum { EXIT = 0, INSERT_STRING = 1, INSERT_VECTOR_STRING = 2, LOOKUP = 3, PRINT = 4, SYNC = 5 };
+
+    /*
+     * Under MPI, the master process owns the symbol table. Every other process holds a
+     * replica of a prefix of it, such that symbols and indices known to the replica are
+     * looked up and resolved locally. A miss fetches all symbols the master created
+     * since the last exchange in a single message, such that the first miss obtains the
+     * symbols of the input relations in bulk.
+     */
 
-    mutable std::unordered_map<std::string, size_t> strToNumCache;
-    mutable std::unordered_map<size_t, std::string> numToStrCache;
+    /** Serializes the exchanges of the replica with the master */
+    mutable Lock replicaAccess;
 
-    RamDomain cacheLookup(const std::string& symbol, const int tag) const {
-        auto lease = access.acquire();
-        (void)lease;  // avoid warning;
-        auto it = strToNumCache.find(symbol);
-        if (it != strToNumCache.end()) {
-            return it->second;
+    /**
+     * Append the given symbols, which follow the symbols of this replica on the master, to the replica.
+     * Each symbol is published only once its string has been stored, such that concurrent resolves of
+     * the replica never read a slot that is still being written.
+     */
+    void appendToReplica(const std::vector<std::string>& symbols) const {
+        auto& table = const_cast<SymbolTable&>(*this);
+        for (const auto& symbol : symbols) {
+            const size_t expected = publishedSize();
+            if (table.newSymbolOfIndex(symbol) != expected) {
+                throw std::runtime_error("Replica diverged from the master in SymbolTable::appendToReplica.");
+            }
         }
-        mpi::send(symbol, 0, tag);
-        RamDomain index;
-        mpi::recv(index, 0, tag);
-        strToNumCache.insert(std::pair<std::string, size_t>(symbol, index));
-        return numToStrCache.insert(std::pair<size_t, std::string>(index, symbol)).first->first;
-    }
-    const std::string& cacheResolve(const RamDomain index, const int tag) const {
-        auto lease = access.acquire();
+    }
+
+    /** Bring the replica up to date with the master, and return its size. */
+    size_t syncReplica() const {
+        auto lease = replicaAccess.acquire();
         (void)lease;  // avoid warning;
-        auto it = numToStrCache.find(index);
-        if (it != numToStrCache.end()) {
-            return it->second;
+        mpi::send(publishedSize(), 0, SYNC);
+        std::vector<std::string> symbols;
+        auto status = mpi::probe(0, SYNC);
+        mpi::recv(symbols, status);
+        appendToReplica(symbols);
+        return publishedSize();
+    }
+
+    /**
+     * Look up symbols on the master, creating them if necessary, and update the replica. All symbols
+     * missing from the replica are sent in a single request.
+     */
+    std::vector<RamDomain> remoteLookup(const std::vector<std::string>& symbols) const {
+        auto lease = replicaAccess.acquire();
+        (void)lease;  // avoid warning;
+        // the request holds the symbols unknown to the replica, followed by the size of the replica
+        std::vector<RamDomain> indices(symbols.size());
+        std::vector<std::string> request;
+        for (size_t i = 0; i < symbols.size(); ++i) {
+            size_t index;
+            if (findSymbol(symbols[i], index)) {
+                indices[i] = static_cast<RamDomain>(index);
+            } else {
+                request.push_back(symbols[i]);
+            }
+        }
+        if (request.empty()) {
+            return indices;
         }
-        mpi::send(index, 0, tag);
-        std::string symbol;
-        mpi::recv(symbol, 0, tag);
-        numToStrCache.insert(std::pair<size_t, std::string>(index, symbol));
-        return strToNumCache.insert(std::pair<std::string, size_t>(symbol, index)).first->first;
+        request.push_back(std::to_string(publishedSize()));
+        mpi::send(request, 0, LOOKUP);
+        std::vector<std::string> reply;
+        auto status = mpi::probe(0, LOOKUP);
+        mpi::recv(reply, status);
+        appendToReplica(reply);
+        for (size_t i = 0; i < symbols.size(); ++i) {
+            size_t index;
+            if (!findSymbol(symbols[i], index)) {
+                throw std::runtime_error("Symbol missing from the reply of SymbolTable::remoteLookup.");
+            }
+            indices[i] = static_cast<RamDomain>(index);
+        }
+        return indices;
+    }
+
+    /** Look up a symbol on the master, creating it if necessary, and update the replica. */
+    RamDomain remoteLookup(const std::string& symbol) const {
+        // another thread may have obtained the symbol in the meantime
+        size_t index;
+        if (findSymbol(symbol, index)) {
+            return static_cast<RamDomain>(index);
+        }
+        return remoteLookup(std::vector<std::string>({symbol})).front();
+    }
+
+    /** Obtain the symbols of the master following the given number of symbols of a replica. */
+    std::vector<std::string> getSymbolsFrom(const size_t known) const {
+        std::vector<std::string> symbols;
+        const size_t n = publishedSize();
+        for (size_t i = known; i < n; ++i) {
+            symbols.push_back(*numToStr->get(i));
+        }
+        return symbols;
     }
 
 public:
@@ -101,38 +160,18 @@ public:
                     break;
                 }
                 case LOOKUP: {
-                    std::string symbol;
-                    mpi::recv(symbol, status);
-                    mpi::send(lookup(symbol), status);
-                    break;
-                }
-                case LOOKUP_EXISTING: {
-                    std::string symbol;
-                    mpi::recv(symbol, status);
-                    mpi::send(lookupExisting(symbol), status);
-                    break;
-                }
-                case UNSAFE_LOOKUP: {
-                    std::string symbol;
-                    mpi::recv(symbol, status);
-                    mpi::send(unsafeLookup(symbol), status);
-                    break;
-                }
-                case RESOLVE: {
-                    RamDomain index;
-                    mpi::recv(index, status);
-                    mpi::send(resolve(index), status);
+                    std::vector<std::string> request;
+                    mpi::recv(request, status);
+                    for (size_t i = 0; i + 1 < request.size(); ++i) {
+                        newSymbol(request[i]);
+                    }
+                    mpi::send(getSymbolsFrom(std::stoul(request.back())), status);
                     break;
                 }
-                case UNSAFE_RESOLVE: {
-                    RamDomain index;
-                    mpi::recv(index, status);
-                    mpi::send(unsafeResolve(index), status);
-                    break;
-                }
-                case SIZE: {
-                    mpi::recv(status);
-                    mpi::send(size(), status);
+                case SYNC: {
+                    size_t known;
+                    mpi::recv(known, status);
+                    mpi::send(getSymbolsFrom(known), status);
                     break;
                 }
                 case PRINT: {
@@ -165,7 +204,7 @@ public:
 
     static int numberOfTags() {
         // ok, so this looks stupid, but it just gives the size of the enum at the top
-        return 10;
+        return 6;
     }
 
     static int exitTag() {
@@ -175,35 +214,121 @@ public:
 #endif
 
 private:
-    /** A lock to synchronize parallel accesses */
+    /** Number of shards of the string-to-index map; must be a power of two */
+    static constexpr size_t NUM_SHARDS = 64;
+
+    /** Log2 of the size of the first block of the index-to-string list */
+    static constexpr size_t INDEX_BLOCK_BITS = 10;
+
+    /**
+     * A shard of the string-to-index map. Strings are stored as the keys of the
+     * map; since the map is node-based, their addresses remain stable and are
+     * shared with the index-to-string list.
+     */
+    struct Shard {
+        /** A lock to synchronize parallel accesses to this shard */
+        mutable ReadWriteLock access;
+
+        /** Map strings to indices. */
+        std::unordered_map<std::string, size_t> strToNum;
+    };
+
+    /** A lock to synchronize bulk accesses, see acquireLock() */
     mutable Lock access;
 
-    /** Map indices to strings. */
-    std::deque<std::string> numToStr;
+    /** Map strings to indices, partitioned by the hash of the string. */
+    std::array<Shard, NUM_SHARDS> shards;
+
+    /** Map indices to strings; reads are wait-free, appends are serialized by appendAccess. */
+    std::unique_ptr<PiggyList<const std::string*>> numToStr{
+            new PiggyList<const std::string*>(INDEX_BLOCK_BITS)};
+
+    /** A lock serializing appends to the index-to-string list, which do not support concurrent growth */
+    SpinLock appendAccess;
+
+    /**
+     * The number of symbols whose strings are stored in the index-to-string list. The list counts an
+     * appended element before storing it, hence readers are bounded by this count instead, which is
+     * published once the string has been stored.
+     */
+    std::atomic<size_t> numSymbols{0};
+
+    /** Obtain the number of symbols that may be resolved. */
+    inline size_t publishedSize() const {
+        return numSymbols.load(std::memory_order_acquire);
+    }
+
+    /** Obtain the shard responsible for the given symbol. */
+    inline Shard& getShard(const std::string& symbol) {
+        return shards[std::hash<std::string>()(symbol) & (NUM_SHARDS - 1)];
+    }
 
-    /** Map strings to indices. */
-    std::unordered_map<std::string, size_t> strToNum;
+    inline const Shard& getShard(const std::string& symbol) const {
+        return shards[std::hash<std::string>()(symbol) & (NUM_SHARDS - 1)];
+    }
 
     /** Convenience method to place a new symbol in the table, if it does not exist, and return the index of
      * it. */
     inline size_t newSymbolOfIndex(const std::string& symbol) {
-        size_t index;
-        auto it = strToNum.find(symbol);
-        if (it == strToNum.end()) {
-            index = numToStr.size();
-            strToNum[symbol] = index;
-            numToStr.push_back(symbol);
-        } else {
-            index = it->second;
+        Shard& shard = getShard(symbol);
+
+        // fast path: the symbol is already present
+        shard.access.start_read();
+        auto it = shard.strToNum.find(symbol);
+        if (it != shard.strToNum.end()) {
+            size_t index = it->second;
+            shard.access.end_read();
+            return index;
         }
+        shard.access.end_read();
+
+        // slow path: re-check and insert under the write lock of the shard
+        shard.access.start_write();
+        auto res = shard.strToNum.insert(std::make_pair(symbol, size_t(0)));
+        if (res.second) {
+            appendAccess.lock();
+            size_t index = numToStr->append(&res.first->first);
+            numSymbols.store(index + 1, std::memory_order_release);
+            appendAccess.unlock();
+            res.first->second = index;
+        }
+        size_t index = res.first->second;
+        shard.access.end_write();
         return index;
     }
 
+    /** Find the index of an existing symbol, returning false if it does not exist. */
+    inline bool findSymbol(const std::string& symbol, size_t& index) const {
+        const Shard& shard = getShard(symbol);
+        shard.access.start_read();
+        auto it = shard.strToNum.find(symbol);
+        bool found = (it != shard.strToNum.end());
+        if (found) {
+            index = it->second;
+        }
+        shard.access.end_read();
+        return found;
+    }
+
     /** Convenience method to place a new symbol in the table, if it does not exist. */
     inline void newSymbol(const std::string& symbol) {
-        if (strToNum.find(symbol) == strToNum.end()) {
-            strToNum[symbol] = numToStr.size();
-            numToStr.push_back(symbol);
+        newSymbolOfIndex(symbol);
+    }
+
+    /** Remove all symbols from the table. */
+    void clear() {
+        for (auto& shard : shards) {
+            shard.strToNum.clear();
+        }
+        numToStr->clear();
+        numSymbols.store(0);
+    }
+
+    /** Insert all symbols of the given table in index order, preserving their indices. */
+    void copyFrom(const SymbolTable& other) {
+        const size_t n = other.publishedSize();
+        for (size_t i = 0; i < n; ++i) {
+            newSymbol(*other.numToStr->get(i));
         }
     }
 
@@ -212,16 +337,20 @@ public:
     SymbolTable() = default;
 
     /** Copy constructor, performs a deep copy. */
-    SymbolTable(const SymbolTable& other) : numToStr(other.numToStr), strToNum(other.strToNum) {}
+    SymbolTable(const SymbolTable& other) {
+        copyFrom(other);
+    }
 
     /** Copy constructor for r-value reference. */
     SymbolTable(SymbolTable&& other) noexcept {
+        for (size_t i = 0; i < NUM_SHARDS; ++i) {
+            shards[i].strToNum.swap(other.shards[i].strToNum);
+        }
         numToStr.swap(other.numToStr);
-        strToNum.swap(other.strToNum);
+        numSymbols.store(other.numSymbols.exchange(numSymbols.load()));
     }
 
     SymbolTable(std::initializer_list<std::string> symbols) {
-        strToNum.reserve(symbols.size());
         for (const auto& symbol : symbols) {
             newSymbol(symbol);
         }
@@ -235,15 +364,18 @@ public:
         if (this == &other) {
             return *this;
         }
-        numToStr = other.numToStr;
-        strToNum = other.strToNum;
+        clear();
+        copyFrom(other);
         return *this;
     }
 
     /** Assignment operator for r-value references. */
     SymbolTable& operator=(SymbolTable&& other) noexcept {
+        for (size_t i = 0; i < NUM_SHARDS; ++i) {
+            shards[i].strToNum.swap(other.shards[i].strToNum);
+        }
         numToStr.swap(other.numToStr);
-        strToNum.swap(other.strToNum);
+        numSymbols.store(other.numSymbols.exchange(numSymbols.load()));
         return *this;
     }
 
@@ -252,33 +384,43 @@ public:
     RamDomain lookup(const std::string& symbol) {
 #ifdef USE_MPI
         if (mpi::commRank() != 0) {
-            return cacheLookup(symbol, LOOKUP);
+            return remoteLookup(symbol);
         } else
 #endif
-        {
-            auto lease = access.acquire();
-            (void)lease;  // avoid warning;
             return static_cast<RamDomain>(newSymbolOfIndex(symbol));
-        }
     }
 
-    /** Finds the index of a symbol in the table, giving an error if it's not found */
-    RamDomain lookupExisting(const std::string& symbol) const {
+    /** Find the indices of the given symbols in the table, inserting the symbols that do not exist there
+     * already; under MPI, the symbols unknown to a process are looked up with a single request. */
+    std::vector<RamDomain> lookup(const std::vector<std::string>& symbols) {
 #ifdef USE_MPI
         if (mpi::commRank() != 0) {
-            return cacheLookup(symbol, LOOKUP_EXISTING);
+            return remoteLookup(symbols);
         } else
 #endif
         {
-            auto lease = access.acquire();
-            (void)lease;  // avoid warning;
-            auto result = strToNum.find(symbol);
-            if (result == strToNum.end()) {
-                std::cerr << "Error string not found in call to SymbolTable::lookupExisting.\n";
-                exit(1);
+            std::vector<RamDomain> indices;
+            indices.reserve(symbols.size());
+            for (const auto& symbol : symbols) {
+                indices.push_back(static_cast<RamDomain>(newSymbolOfIndex(symbol)));
             }
-            return static_cast<RamDomain>(result->second);
+            return indices;
+        }
+    }
+
+    /** Finds the index of a symbol in the table, giving an error if it's not found */
+    RamDomain lookupExisting(const std::string& symbol) const {
+        size_t index;
+#ifdef USE_MPI
+        if (mpi::commRank() != 0 && !findSymbol(symbol, index)) {
+            syncReplica();
         }
+#endif
+        if (!findSymbol(symbol, index)) {
+            std::cerr << "Error string not found in call to SymbolTable::lookupExisting.\n";
+            exit(1);
+        }
+        return static_cast<RamDomain>(index);
     }
 
     /** Find the index of a symbol in the table, inserting a new symbol if it does not exist there
@@ -286,7 +428,7 @@ public:
     RamDomain unsafeLookup(const std::string& symbol) {
 #ifdef USE_MPI
         if (mpi::commRank() != 0) {
-            return cacheLookup(symbol, UNSAFE_LOOKUP);
+            return remoteLookup(symbol);
         } else
 #endif
             return newSymbolOfIndex(symbol);
@@ -296,44 +438,33 @@ public:
      * bounds.
      */
     const std::string& resolve(const RamDomain index) const {
+        auto pos = static_cast<size_t>(index);
 #ifdef USE_MPI
-        if (mpi::commRank() != 0) {
-            return cacheResolve(index, RESOLVE);
-        } else
+        if (mpi::commRank() != 0 && pos >= publishedSize()) {
+            syncReplica();
+        }
 #endif
-        {
-            auto lease = access.acquire();
-            (void)lease;  // avoid warning;
-            auto pos = static_cast<size_t>(index);
-            if (pos >= size()) {
-                // TODO: use different error reporting here!!
-                std::cerr << "Error index out of bounds in call to SymbolTable::resolve.\n";
-                exit(1);
-            }
-            return numToStr[pos];
+        if (pos >= publishedSize()) {
+            // TODO: use different error reporting here!!
+            std::cerr << "Error index out of bounds in call to SymbolTable::resolve.\n";
+            exit(1);
         }
+        return *numToStr->get(pos);
     }
 
     const std::string& unsafeResolve(const RamDomain index) const {
 #ifdef USE_MPI
-        if (mpi::commRank() != 0) {
-            return cacheResolve(index, UNSAFE_RESOLVE);
-        } else
+        if (mpi::commRank() != 0 && static_cast<size_t>(index) >= publishedSize()) {
+            syncReplica();
+        }
 #endif
-            return numToStr[static_cast<size_t>(index)];
+        return *numToStr->get(static_cast<size_t>(index));
     }
 
-    /* Return the size of the symbol table, being the number of symbols it currently holds. */
+    /* Return the size of the symbol table, being the number of symbols it currently holds. Under MPI,
+     * processes other than the master return the size of their replica without contacting the master. */
     size_t size() const {
-#ifdef USE_MPI
-        if (mpi::commRank() != 0) {
-            mpi::send(0, SIZE);
-            size_t size;
-            mpi::recv(size, 0, SIZE);
-            return size;
-        } else
-#endif
-            return numToStr.size();
+        return publishedSize();
     }
 
     /** Bulk insert symbols into the table, note that this operation is more efficient than repeated
@@ -346,9 +477,12 @@ public:
         } else
 #endif
         {
-            auto lease = access.acquire();
-            (void)lease;  // avoid warning;
-            strToNum.reserve(size() + symbols.size());
+            const size_t perShard = (size() + symbols.size()) / NUM_SHARDS + 1;
+            for (auto& shard : shards) {
+                shard.access.start_write();
+                shard.strToNum.reserve(perShard);
+                shard.access.end_write();
+            }
             for (auto& symbol : symbols) {
                 newSymbol(symbol);
             }
@@ -364,11 +498,7 @@ public:
             mpi::send(symbol, 0, INSERT_STRING);
         } else
 #endif
-        {
-            auto lease = access.acquire();
-            (void)lease;  // avoid warning;
             newSymbol(symbol);
-        }
     }
 
     /** Print the symbol table to the given stream. */
@@ -380,32 +510,37 @@ public:
 #endif
         {
             out << "SymbolTable: {\n\t";
-            out << join(strToNum, "\n\t",
-                           [](std::ostream& out, const std::pair<std::string, std::size_t>& entry) {
-                               out << entry.first << "\t => " << entry.second;
-                           })
-                << "\n";
+            const size_t n = publishedSize();
+            for (size_t i = 0; i < n; ++i) {
+                if (i > 0) {
+                    out << "\n\t";
+                }
+                out << *numToStr->get(i) << "\t => " << i;
+            }
+            out << "\n";
             out << "}\n";
         }
     }
 
     /** Check if the symbol table contains a string */
     bool contains(const std::string& symbol) const {
-        auto lease = access.acquire();
-        (void)lease;  // avoid warning;
-        auto result = strToNum.find(symbol);
-        if (result == strToNum.end()) {
-            return false;
-        } else {
-            return true;
+        size_t index;
+#ifdef USE_MPI
+        if (mpi::commRank() != 0 && !findSymbol(symbol, index)) {
+            syncReplica();
         }
+#endif
+        return findSymbol(symbol, index);
     }
 
     /** Check if the symbol table contains an index */
     bool contains(const RamDomain index) const {
-        auto lease = access.acquire();
-        (void)lease;  // avoid warning;
         auto pos = static_cast<size_t>(index);
+#ifdef USE_MPI
+        if (mpi::commRank() != 0 && pos >= publishedSize()) {
+            syncReplica();
+        }
+#endif
         if (pos >= size()) {
             return false;
         } else {
@@ -413,6 +548,8 @@ public:
         }
     }
 
+    /** Acquire a lease for a sequence of unsafe operations; the table itself is synchronized per shard,
+     * hence the lease only serializes callers among each other. */
     Lock::Lease acquireLock() const {
         return access.acquire();
     }
@@ -38,6 +38,7 @@
 #include <cstdlib>
 #include <functional>
 #include <iostream>
+#include <set>
 #include <sstream>
 #include <typeinfo>
 #include <utility>
@@ -179,6 +180,10 @@ std::set<const RamRelation*> Synthesiser::getReferencedRelations(const RamOperat
             res.insert(&provExists->getRelation());
         } else if (auto project = dynamic_cast<const RamProject*>(&node)) {
             res.insert(&project->getRelation());
+        } else if (auto intersection = dynamic_cast<const RamIntersection*>(&node)) {
+            for (size_t i = 0; i < intersection->getNumRelations(); i++) {
+                res.insert(&intersection->getRelation(i));
+            }
         }
     });
     return res;
@@ -229,7 +234,11 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
 
         void visitLoad(const RamLoad& load, std::ostream& out) override {
             PRINT_BEGIN_COMMENT(out);
-            out << "if (performIO) {\n";
+            // in replicated execution the master process performs all I/O
+            out << "if (performIO"
+                << (Global::config().get("engine") == "mpi-replicated" ? " && souffle::mpi::commRank() == 0"
+                                                                        : "")
+                << ") {\n";
             std::vector<bool> symbolMask;
             for (auto& cur : load.getRelation().getAttributeTypeQualifiers()) {
                 symbolMask.push_back(cur[0] == 's');
@@ -239,11 +248,11 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
                 out << "try {";
                 out << "std::map<std::string, std::string> directiveMap(";
                 out << ioDirectives << ");\n";
-                out << R"_(if (!inputDirectory.empty() && directiveMap["IO"] == "file" && )_";
-                out << "directiveMap[\"filename\"].front() != '/') {";
-                out << R"_(directiveMap["filename"] = inputDirectory + "/" + directiveMap["filename"];)_";
-                out << "}\n";
                 out << "IODirectives ioDirectives(directiveMap);\n";
+                out << "if (!inputDirectory.empty() && ioDirectives.hasFileIOType() && ";
+                out << "ioDirectives.getFileName().front() != '/') {";
+                out << R"_(ioDirectives.setFileName(inputDirectory + "/" + ioDirectives.getFileName());)_";
+                out << "}\n";
                 out << "IOSystem::getInstance().getReader(";
                 out << "std::vector<bool>({" << join(symbolMask) << "})";
                 out << ", symTable, ioDirectives";
@@ -259,7 +268,11 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
 
         void visitStore(const RamStore& store, std::ostream& out) override {
             PRINT_BEGIN_COMMENT(out);
-            out << "if (performIO) {\n";
+            // in replicated execution the master process performs all I/O
+            out << "if (performIO"
+                << (Global::config().get("engine") == "mpi-replicated" ? " && souffle::mpi::commRank() == 0"
+                                                                        : "")
+                << ") {\n";
             std::vector<bool> symbolMask;
             for (auto& cur : store.getRelation().getAttributeTypeQualifiers()) {
                 symbolMask.push_back(cur[0] == 's');
@@ -267,11 +280,11 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
             for (IODirectives ioDirectives : store.getIODirectives()) {
                 out << "try {";
                 out << "std::map<std::string, std::string> directiveMap(" << ioDirectives << ");\n";
-                out << R"_(if (!outputDirectory.empty() && directiveMap["IO"] == "file" && )_";
-                out << "directiveMap[\"filename\"].front() != '/') {";
-                out << R"_(directiveMap["filename"] = outputDirectory + "/" + directiveMap["filename"];)_";
-                out << "}\n";
                 out << "IODirectives ioDirectives(directiveMap);\n";
+                out << "if (!outputDirectory.empty() && ioDirectives.hasFileIOType() && ";
+                out << "ioDirectives.getFileName().front() != '/') {";
+                out << R"_(ioDirectives.setFileName(outputDirectory + "/" + ioDirectives.getFileName());)_";
+                out << "}\n";
                 out << "IOSystem::getInstance().getWriter(";
                 out << "std::vector<bool>({" << join(symbolMask) << "})";
                 out << ", symTable, ioDirectives";
@@ -423,6 +436,13 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
             PRINT_END_COMMENT(out);
         }
 
+        void visitLogStatistics(const RamLogStatistics& stats, std::ostream& out) override {
+            PRINT_BEGIN_COMMENT(out);
+            out << "RelationStats::extractFrom(*" << synthesiser.getRelationName(stats.getRelation()) << ","
+                << stats.getRelation().getArity() << ").logTo(R\"(" << stats.getMessage() << ")\");";
+            PRINT_END_COMMENT(out);
+        }
+
         // -- control flow statements --
 
         void visitSequence(const RamSequence& seq, std::ostream& out) override {
@@ -433,6 +453,13 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
             PRINT_END_COMMENT(out);
         }
 
+        void visitAdaptiveQuery(const RamAdaptiveQuery& adaptive, std::ostream& out) override {
+            // the join order is only adapted by the interpreters, keep the first variant
+            PRINT_BEGIN_COMMENT(out);
+            visit(adaptive.getStatements()[0], out);
+            PRINT_END_COMMENT(out);
+        }
+
         void visitParallel(const RamParallel& parallel, std::ostream& out) override {
             PRINT_BEGIN_COMMENT(out);
             auto stmts = parallel.getStatements();
@@ -710,6 +737,62 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
             PRINT_END_COMMENT(out);
         }
 
+        void visitIntersection(const RamIntersection& intersection, std::ostream& out) override {
+            auto identifier = intersection.getTupleId();
+
+            PRINT_BEGIN_COMMENT(out);
+
+            out << "{\n";
+
+            // a cursor over the values of the column within the range of each input
+            std::string cursors;
+            for (size_t i = 0; i < intersection.getNumRelations(); i++) {
+                const auto& rel = intersection.getRelation(i);
+                auto relName = synthesiser.getRelationName(rel);
+                auto arity = rel.getArity();
+                const auto& order = intersection.getLexOrder(i);
+                const auto prefix = intersection.getPrefix(i);
+                auto indexNum = isa->getIndexes(rel).getOrderNum(order);
+                auto ctxName = "READ_OP_CONTEXT(" + synthesiser.getOpContextName(rel) + ")";
+                auto tupleType = "Tuple<RamDomain," + std::to_string(arity) + ">";
+                auto cursor = "cursor" + std::to_string(identifier) + "_" + std::to_string(i);
+
+                // the bounds of the range, fixing the columns of the prefix
+                for (const std::string bound : {"low", "high"}) {
+                    out << "const " << tupleType << " " << cursor << "_" << bound << "({{";
+                    for (size_t col = 0; col < arity; col++) {
+                        auto pos = std::find(order.begin(), order.begin() + prefix.size(), (int)col);
+                        if (pos != order.begin() + prefix.size()) {
+                            visit(prefix[pos - order.begin()], out);
+                        } else {
+                            out << (bound == "low" ? "MIN_RAM_DOMAIN" : "MAX_RAM_DOMAIN");
+                        }
+                        if (col + 1 < arity) {
+                            out << ",";
+                        }
+                    }
+                    out << "}});\n";
+                }
+
+                out << "auto " << cursor << " = makeLeapfrogCursor(" << relName << "->lowerBound_" << indexNum
+                    << "(" << cursor << "_low," << ctxName << "), " << relName << "->upperBound_" << indexNum
+                    << "(" << cursor << "_high," << ctxName << "), " << cursor << "_low, "
+                    << intersection.getColumn(i) << ", [&](const " << tupleType << "& key) { return "
+                    << relName << "->lowerBound_" << indexNum << "(key," << ctxName << "); });\n";
+                cursors += (i == 0 ? "&" : ",&") + cursor;
+            }
+
+            out << "for(LeapfrogJoin join({" << cursors << "}); !join.atEnd(); join.next()) {\n";
+            out << "const Tuple<RamDomain,1> env" << identifier << "({{join.getValue()}});\n";
+
+            visitTupleOperation(intersection, out);
+
+            out << "}\n";
+            out << "}\n";
+
+            PRINT_END_COMMENT(out);
+        }
+
         void visitParallelIndexScan(const RamParallelIndexScan& piscan, std::ostream& out) override {
             const auto& rel = piscan.getRelation();
             auto relName = synthesiser.getRelationName(rel);
@@ -1694,6 +1777,48 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
             os << "\n#endif\n";
         }
 
+        // -- statements of replicated execution --
+
+        void visitExchange(const RamExchange& exchange, std::ostream& out) override {
+            PRINT_BEGIN_COMMENT(out);
+            out << "souffle::mpi::allGather<RamDomain>(*"
+                << synthesiser.getRelationName(exchange.getRelation()) << ", "
+                << exchange.getRelation().getArity() << ");\n";
+            PRINT_END_COMMENT(out);
+        }
+
+        void visitPartition(const RamPartition& partition, std::ostream& out) override {
+            PRINT_BEGIN_COMMENT(out);
+            out << "souffle::mpi::partition<RamDomain>(*"
+                << synthesiser.getRelationName(partition.getRelation()) << ", "
+                << partition.getRelation().getArity() << ");\n";
+            PRINT_END_COMMENT(out);
+        }
+
+        void visitBroadcast(const RamBroadcast& broadcast, std::ostream& out) override {
+            PRINT_BEGIN_COMMENT(out);
+            out << "{\n";
+            // all processes hold a prefix of the symbol table of the master process
+            out << "std::vector<std::string> symbols;\n";
+            out << "const size_t known = souffle::mpi::allMin(symTable.size());\n";
+            out << "if (souffle::mpi::commRank() == 0) {\n";
+            out << "for (size_t i = known; i < symTable.size(); ++i) {\n";
+            out << "symbols.push_back(symTable.unsafeResolve(i));\n";
+            out << "}\n";
+            out << "}\n";
+            out << "souffle::mpi::broadcast(symbols, 0);\n";
+            out << "if (souffle::mpi::commRank() != 0) {\n";
+            out << "for (const auto& symbol : symbols) {\n";
+            out << "symTable.unsafeLookup(symbol);\n";
+            out << "}\n";
+            out << "}\n";
+            out << "souffle::mpi::broadcast<RamDomain>(*"
+                << synthesiser.getRelationName(broadcast.getRelation()) << ", "
+                << broadcast.getRelation().getArity() << ", 0);\n";
+            out << "}\n";
+            PRINT_END_COMMENT(out);
+        }
+
 #endif
         // -- safety net --
 
@@ -1712,6 +1837,20 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
 }
 
 void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& withSharedLibrary) {
+    std::stringstream header;
+    std::stringstream mainUnit;
+    std::map<std::string, std::string> units;
+    generateCode(header, mainUnit, units, "", id, withSharedLibrary);
+    os << header.str();
+    for (const auto& unit : units) {
+        os << unit.second;
+    }
+    os << mainUnit.str();
+}
+
+void Synthesiser::generateCode(std::ostream& hdr, std::ostream& os,
+        std::map<std::string, std::string>& units, const std::string& headerName, const std::string& id,
+        bool& withSharedLibrary) {
     // ---------------------------------------------------------------
     //                      Auto-Index Generation
     // ---------------------------------------------------------------
@@ -1727,25 +1866,40 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
 
     std::string classname = "Sf_" + id;
 
+    // the header is included by all translation units if the program is split
+    if (!headerName.empty()) {
+        hdr << "#pragma once\n";
+    }
+
 #ifdef USE_MPI
-    // turn off mpi support if not enabled as the execution engine
+    // turn off mpi support if not enabled as the execution engine, replicated execution
+    // keeps the symbol table local to each process
     if (Global::config().get("engine") != "mpi") {
-        os << "#undef USE_MPI\n";
+        hdr << "#undef USE_MPI\n";
     }
 #endif
 
     // generate C++ program
-    os << "\n#include \"souffle/CompiledSouffle.h\"\n";
+    hdr << "\n#include \"souffle/CompiledSouffle.h\"\n";
+    if (Global::config().get("engine") == "mpi-replicated") {
+        hdr << "#include \"souffle/Mpi.h\"\n";
+    }
+    if (Global::config().has("profile")) {
+        hdr << "#include \"souffle/RelationStats.h\"\n";
+    }
+    if (Global::config().has("leapfrog-joins")) {
+        hdr << "#include \"souffle/LeapfrogJoin.h\"\n";
+    }
     if (Global::config().has("provenance")) {
-        os << "#include <mutex>\n";
-        os << "#include \"souffle/Explain.h\"\n";
+        hdr << "#include <mutex>\n";
+        hdr << "#include \"souffle/Explain.h\"\n";
     }
 
     if (Global::config().has("live-profile")) {
-        os << "#include <thread>\n";
-        os << "#include \"souffle/profile/Tui.h\"\n";
+        hdr << "#include <thread>\n";
+        hdr << "#include \"souffle/profile/Tui.h\"\n";
     }
-    os << "\n";
+    hdr << "\n";
     // produce external definitions for user-defined functors
     std::map<std::string, std::string> functors;
     visitDepthFirst(prog, [&](const RamUserDefinedOperator& op) {
@@ -1753,17 +1907,17 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
             functors.insert(std::make_pair(op.getName(), op.getType()));
         withSharedLibrary = true;
     });
-    os << "extern \"C\" {\n";
+    hdr << "extern \"C\" {\n";
     for (const auto& f : functors) {
         size_t arity = f.second.length() - 1;
         const std::string& type = f.second;
         const std::string& name = f.first;
         if (type[arity] == 'N') {
-            os << "souffle::RamDomain ";
+            hdr << "souffle::RamDomain ";
         } else if (type[arity] == 'S') {
-            os << "const char * ";
+            hdr << "const char * ";
         }
-        os << name << "(";
+        hdr << name << "(";
         std::vector<std::string> args;
         for (size_t i = 0; i < arity; i++) {
             if (type[i] == 'N') {
@@ -1772,13 +1926,13 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
                 args.push_back("const char *");
             }
         }
-        os << join(args, ",");
-        os << ");\n";
+        hdr << join(args, ",");
+        hdr << ");\n";
     }
-    os << "}\n";
-    os << "\n";
-    os << "namespace souffle {\n";
-    os << "using namespace ram;\n";
+    hdr << "}\n";
+    hdr << "\n";
+    hdr << "namespace souffle {\n";
+    hdr << "using namespace ram;\n";
 
     visitDepthFirst(*(prog.getMain()), [&](const RamCreate& create) {
         // get some table details
@@ -1789,99 +1943,89 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
         auto relationType = SynthesiserRelation::getSynthesiserRelation(
                 rel, idxAnalysis->getIndexes(rel), Global::config().has("provenance") && !isProvInfo);
 
-        generateRelationTypeStruct(os, std::move(relationType));
+        generateRelationTypeStruct(hdr, std::move(relationType));
     });
-    os << '\n';
+    hdr << '\n';
 
-    os << "class " << classname << " : public SouffleProgram {\n";
+    hdr << "class " << classname << " : public SouffleProgram {\n";
 
     // regex wrapper
-    os << "private:\n";
-    os << "static inline bool regex_wrapper(const std::string& pattern, const std::string& text) {\n";
-    os << "   bool result = false; \n";
-    os << "   try { result = std::regex_match(text, std::regex(pattern)); } catch(...) { \n";
-    os << "     std::cerr << \"warning: wrong pattern provided for match(\\\"\" << pattern << \"\\\",\\\"\" "
+    hdr << "private:\n";
+    hdr << "static inline bool regex_wrapper(const std::string& pattern, const std::string& text) {\n";
+    hdr << "   bool result = false; \n";
+    hdr << "   try { result = std::regex_match(text, std::regex(pattern)); } catch(...) { \n";
+    hdr << "     std::cerr << \"warning: wrong pattern provided for match(\\\"\" << pattern << \"\\\",\\\"\" "
           "<< text << \"\\\").\\n\";\n}\n";
-    os << "   return result;\n";
-    os << "}\n";
+    hdr << "   return result;\n";
+    hdr << "}\n";
 
     // substring wrapper
-    os << "private:\n";
-    os << "static inline std::string substr_wrapper(const std::string& str, size_t idx, size_t len) {\n";
-    os << "   std::string result; \n";
-    os << "   try { result = str.substr(idx,len); } catch(...) { \n";
-    os << "     std::cerr << \"warning: wrong index position provided by substr(\\\"\";\n";
-    os << "     std::cerr << str << \"\\\",\" << (int32_t)idx << \",\" << (int32_t)len << \") "
+    hdr << "private:\n";
+    hdr << "static inline std::string substr_wrapper(const std::string& str, size_t idx, size_t len) {\n";
+    hdr << "   std::string result; \n";
+    hdr << "   try { result = str.substr(idx,len); } catch(...) { \n";
+    hdr << "     std::cerr << \"warning: wrong index position provided by substr(\\\"\";\n";
+    hdr << "     std::cerr << str << \"\\\",\" << (int32_t)idx << \",\" << (int32_t)len << \") "
           "functor.\\n\";\n";
-    os << "   } return result;\n";
-    os << "}\n";
+    hdr << "   } return result;\n";
+    hdr << "}\n";
 
     // to number wrapper
-    os << "private:\n";
-    os << "static inline RamDomain wrapper_tonumber(const std::string& str) {\n";
-    os << "   RamDomain result=0; \n";
-    os << "   try { result = stord(str); } catch(...) { \n";
-    os << "     std::cerr << \"error: wrong string provided by to_number(\\\"\";\n";
-    os << R"(     std::cerr << str << "\") )";
-    os << "functor.\\n\";\n";
-    os << "     raise(SIGFPE);\n";
-    os << "   } return result;\n";
-    os << "}\n";
+    hdr << "private:\n";
+    hdr << "static inline RamDomain wrapper_tonumber(const std::string& str) {\n";
+    hdr << "   RamDomain result=0; \n";
+    hdr << "   try { result = stord(str); } catch(...) { \n";
+    hdr << "     std::cerr << \"error: wrong string provided by to_number(\\\"\";\n";
+    hdr << R"(     std::cerr << str << "\") )";
+    hdr << "functor.\\n\";\n";
+    hdr << "     raise(SIGFPE);\n";
+    hdr << "   } return result;\n";
+    hdr << "}\n";
 
 // if using mpi...
 #ifdef USE_MPI
     if (Global::config().get("engine") == "mpi") {
-        os << "\n#ifdef USE_MPI\n";
+        hdr << "\n#ifdef USE_MPI\n";
 
         // create an enum of message tags, one for each relation
         {
-            os << "private:\n";
-            os << "enum {";
+            hdr << "private:\n";
+            hdr << "enum {";
             {
                 int tag = SymbolTable::numberOfTags();
                 visitDepthFirst(*(prog.getMain()), [&](const RamCreate& create) {
                     if (tag != SymbolTable::numberOfTags()) {
-                        os << ", ";
+                        hdr << ", ";
                     }
-                    os << "tag_" << getRelationName(create.getRelation()) << " = " << tag;
+                    hdr << "tag_" << getRelationName(create.getRelation()) << " = " << tag;
                     ++tag;
                 });
             }
-            os << "};";
+            hdr << "};";
         }
-        os << "\n#endif\n";
+        hdr << "\n#endif\n";
     }
 #endif
 
     if (Global::config().has("profile")) {
-        os << "std::string profiling_fname;\n";
+        hdr << "std::string profiling_fname;\n";
     }
 
-    os << "public:\n";
+    hdr << "public:\n";
 
     // declare symbol table
-    os << "// -- initialize symbol table --\n";
-    {
-        os << "SymbolTable symTable\n";
-        if (symTable.size() > 0) {
-            os << "{\n";
-            for (size_t i = 0; i < symTable.size(); i++) {
-                os << "\tR\"_(" << symTable.resolve(i) << ")_\",\n";
-            }
-            os << "}";
-        }
-        os << ";";
-    }
+    // the symbol table is initialized by the constructor, such that new symbols do not change the header
+    hdr << "SymbolTable symTable;\n";
     if (Global::config().has("profile")) {
-        os << "private:\n";
+        hdr << "private:\n";
         size_t numFreq = 0;
         visitDepthFirst(*(prog.getMain()), [&](const RamStatement& node) { numFreq++; });
-        os << "  size_t freqs[" << numFreq << "]{};\n";
+        hdr << "  size_t freqs[" << numFreq << "]{};\n";
         size_t numRead = 0;
         visitDepthFirst(*(prog.getMain()), [&](const RamCreate& node) {
             if (!node.getRelation().isTemp()) numRead++;
         });
-        os << "  size_t reads[" << numRead << "]{};\n";
+        hdr << "  size_t reads[" << numRead << "]{};\n";
     }
 
     // print relation definitions
@@ -1912,16 +2056,16 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
         const std::string& type = (rel.isTemp()) ? tempType : relationType->getTypeName();
 
         // defining table
-        os << "// -- Table: " << raw_name << "\n";
+        hdr << "// -- Table: " << raw_name << "\n";
 
-        os << "std::unique_ptr<" << type << "> " << name << " = std::make_unique<" << type << ">();\n";
+        hdr << "std::unique_ptr<" << type << "> " << name << " = std::make_unique<" << type << ">();\n";
         if (!rel.isTemp()) {
-            os << "souffle::RelationWrapper<";
-            os << relCtr++ << ",";
-            os << type << ",";
-            os << "Tuple<RamDomain," << arity << ">,";
-            os << arity;
-            os << "> wrapper_" << name << ";\n";
+            hdr << "souffle::RelationWrapper<";
+            hdr << relCtr++ << ",";
+            hdr << type << ",";
+            hdr << "Tuple<RamDomain," << arity << ">,";
+            hdr << arity;
+            hdr << "> wrapper_" << name << ";\n";
 
             // construct types
             std::string tupleType = "std::array<const char *," + std::to_string(arity) + ">{{";
@@ -1954,21 +2098,40 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
         }
     });
 
-    os << "public:\n";
+    hdr << "public:\n";
 
     // -- constructor --
 
-    os << classname;
     if (Global::config().has("profile")) {
-        os << "(std::string pf=\"profile.log\") : profiling_fname(pf)";
-        if (!initCons.empty()) {
-            os << ",\n" << initCons;
-        }
+        hdr << classname << "(std::string pf=\"profile.log\");\n";
+    } else {
+        hdr << classname << "();\n";
+    }
+
+    // the methods of the class are defined outside of the header
+    if (!headerName.empty()) {
+        os << "#include \"" << headerName << "\"\n";
+    }
+    os << "namespace souffle {\n";
+    os << "using namespace ram;\n";
+
+    os << classname << "::" << classname;
+    bool hasInit = Global::config().has("profile");
+    if (hasInit) {
+        os << "(std::string pf) : profiling_fname(pf)";
     } else {
         os << "()";
-        if (!initCons.empty()) {
-            os << " : " << initCons;
+    }
+    if (symTable.size() > 0) {
+        os << (hasInit ? ",\n" : " : ") << "symTable{\n";
+        for (size_t i = 0; i < symTable.size(); i++) {
+            os << "\tR\"_(" << symTable.resolve(i) << ")_\",\n";
         }
+        os << "}";
+        hasInit = true;
+    }
+    if (!initCons.empty()) {
+        os << (hasInit ? ",\n" : " : ") << initCons;
     }
     os << "{\n";
     if (Global::config().has("profile")) {
@@ -1976,28 +2139,28 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
     }
     os << registerRel;
     os << "}\n";
+
     // -- destructor --
 
-    os << "~" << classname << "() {\n";
-    os << "}\n";
+    hdr << "~" << classname << "() {\n";
+    hdr << "}\n";
 
     // -- run function --
-    os << "private:\nvoid runFunction(std::string inputDirectory = \".\", "
-          "std::string outputDirectory = \".\", size_t stratumIndex = (size_t) -1, bool performIO = false) "
-          "{\n";
+    hdr << "private:\nvoid runFunction(std::string inputDirectory = \".\", "
+           "std::string outputDirectory = \".\", size_t stratumIndex = (size_t) -1, "
+           "bool performIO = false);\n";
+
+    os << "void " << classname << "::runFunction(std::string inputDirectory, std::string outputDirectory, "
+          "size_t stratumIndex, bool performIO) {\n";
 
     os << "SignalHandler::instance()->set();\n";
     if (Global::config().has("verbose")) {
         os << "SignalHandler::instance()->enableLogging();\n";
     }
 
-    bool hasIncrement = false;
-    visitDepthFirst(*(prog.getMain()), [&](const RamAutoIncrement& inc) { hasIncrement = true; });
-    // initialize counter
-    if (hasIncrement) {
-        os << "// -- initialize counter --\n";
-        os << "std::atomic<RamDomain> ctr(0);\n\n";
-    }
+    // initialize counter, shared by all strata
+    os << "// -- initialize counter --\n";
+    os << "std::atomic<RamDomain> ctr(0);\n\n";
     os << "std::atomic<size_t> iter(0);\n\n";
 
     // set default threads (in embedded mode)
@@ -2045,7 +2208,9 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
         os << "}();\n";
     }
 
-    if (Global::config().has("engine")) {
+    // strata are evaluated individually by engines and by the interpreter's just-in-time compilation
+    const bool dispatchStrata = Global::config().has("engine") || Global::config().has("jit");
+    if (dispatchStrata) {
         std::stringstream ss;
         bool hasAtLeastOneStrata = false;
         visitDepthFirst(*(prog.getMain()), [&](const RamStratum& stratum) {
@@ -2065,24 +2230,41 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
         }
     }
 
-    // Set up stratum
+    // Set up stratum, each evaluated by a method of its own translation unit if the program is split
+    const std::string stratumParams =
+            "std::atomic<RamDomain>& ctr, std::atomic<size_t>& iter, const std::string& inputDirectory, "
+            "const std::string& outputDirectory, bool performIO";
     visitDepthFirst(*(prog.getMain()), [&](const RamStratum& stratum) {
         os << "/* BEGIN STRATUM " << stratum.getIndex() << " */\n";
-        if (Global::config().has("engine")) {
+        if (dispatchStrata) {
             // go to the stratum with the max value for int as a suffix if calling the master stratum
             auto i = stratum.getIndex();
             os << "STRATUM_" << i << ":\n";
         }
-        os << "[&]() {\n";
-        emitCode(os, stratum.getBody());
-        os << "}();\n";
-        if (Global::config().has("engine")) {
+        os << "stratum_" << stratum.getIndex()
+           << "(ctr, iter, inputDirectory, outputDirectory, performIO);\n";
+        hdr << "void stratum_" << stratum.getIndex() << "(" << stratumParams << ");\n";
+
+        std::stringstream unit;
+        unit << "/* BEGIN STRATUM " << stratum.getIndex() << " */\n";
+        if (!headerName.empty()) {
+            unit << "#include \"" << headerName << "\"\n";
+        }
+        unit << "namespace souffle {\n";
+        unit << "using namespace ram;\n";
+        unit << "void " << classname << "::stratum_" << stratum.getIndex() << "(" << stratumParams << ") {\n";
+        emitCode(unit, stratum.getBody());
+        unit << "}\n";
+        unit << "}  // namespace souffle\n";
+        unit << "/* END STRATUM " << stratum.getIndex() << " */\n";
+        units["stratum_" + std::to_string(stratum.getIndex())] = unit.str();
+        if (dispatchStrata) {
             os << "if (stratumIndex != (size_t) -1) goto EXIT;\n";
         }
         os << "/* END STRATUM " << stratum.getIndex() << " */\n";
     });
 
-    if (Global::config().has("engine")) {
+    if (dispatchStrata) {
         os << "EXIT:{}";
     }
 
@@ -2109,23 +2291,24 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
     os << "}\n";  // end of runFunction() method
 
     // add methods to run with and without performing IO (mainly for the interface)
-    os << "public:\nvoid run(size_t stratumIndex = (size_t) -1) override { runFunction(\".\", \".\", "
-          "stratumIndex, false); }\n";
-    os << "public:\nvoid runAll(std::string inputDirectory = \".\", std::string outputDirectory = \".\", "
-          "size_t stratumIndex = (size_t) -1) "
-          "override { ";
+    hdr << "public:\nvoid run(size_t stratumIndex = (size_t) -1) override { runFunction(\".\", \".\", "
+           "stratumIndex, false); }\n";
+    hdr << "public:\nvoid runAll(std::string inputDirectory = \".\", std::string outputDirectory = \".\", "
+           "size_t stratumIndex = (size_t) -1) "
+           "override { ";
     if (Global::config().has("live-profile")) {
-        os << "std::thread profiler([]() { profile::Tui().runProf(); });\n";
+        hdr << "std::thread profiler([]() { profile::Tui().runProf(); });\n";
     }
-    os << "runFunction(inputDirectory, outputDirectory, stratumIndex, true);\n";
+    hdr << "runFunction(inputDirectory, outputDirectory, stratumIndex, true);\n";
     if (Global::config().has("live-profile")) {
-        os << "if (profiler.joinable()) { profiler.join(); }\n";
+        hdr << "if (profiler.joinable()) { profiler.join(); }\n";
     }
-    os << "}\n";
+    hdr << "}\n";
 
     // issue printAll method
-    os << "public:\n";
-    os << "void printAll(std::string outputDirectory = \".\") override {\n";
+    hdr << "public:\n";
+    hdr << "void printAll(std::string outputDirectory = \".\") override;\n";
+    os << "void " << classname << "::printAll(std::string outputDirectory) {\n";
     visitDepthFirst(*(prog.getMain()), [&](const RamStatement& node) {
         if (auto store = dynamic_cast<const RamStore*>(&node)) {
             std::vector<bool> symbolMask;
@@ -2135,11 +2318,11 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
             for (IODirectives ioDirectives : store->getIODirectives()) {
                 os << "try {";
                 os << "std::map<std::string, std::string> directiveMap(" << ioDirectives << ");\n";
-                os << R"_(if (!outputDirectory.empty() && directiveMap["IO"] == "file" && )_";
-                os << "directiveMap[\"filename\"].front() != '/') {";
-                os << R"_(directiveMap["filename"] = outputDirectory + "/" + directiveMap["filename"];)_";
-                os << "}\n";
                 os << "IODirectives ioDirectives(directiveMap);\n";
+                os << "if (!outputDirectory.empty() && ioDirectives.hasFileIOType() && ";
+                os << "ioDirectives.getFileName().front() != '/') {";
+                os << R"_(ioDirectives.setFileName(outputDirectory + "/" + ioDirectives.getFileName());)_";
+                os << "}\n";
                 os << "IOSystem::getInstance().getWriter(";
                 os << "std::vector<bool>({" << join(symbolMask) << "})";
                 os << ", symTable, ioDirectives, " << (Global::config().has("provenance") ? "true" : "false");
@@ -2153,8 +2336,9 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
 
     // dumpFreqs method
     if (Global::config().has("profile")) {
-        os << "private:\n";
-        os << "void dumpFreqs() {\n";
+        hdr << "private:\n";
+        hdr << "void dumpFreqs();\n";
+        os << "void " << classname << "::dumpFreqs() {\n";
         for (auto const& cur : idxMap) {
             os << "\tProfileEventSingleton::instance().makeQuantityEvent(R\"_(" << cur.first << ")_\", freqs["
                << cur.second << "],0);\n";
@@ -2163,12 +2347,29 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
             os << "\tProfileEventSingleton::instance().makeQuantityEvent(R\"_(@relation-reads;" << cur.first
                << ")_\", reads[" << cur.second << "],0);\n";
         }
+        // size and number of packing operations of the record maps
+        std::set<size_t> recordArities;
+        visitDepthFirst(prog, [&](const RamPackRecord& pack) {
+            recordArities.insert(pack.getArguments().size());
+        });
+        visitDepthFirst(prog, [&](const RamUnpackRecord& unpack) {
+            recordArities.insert(unpack.getArity());
+        });
+        for (size_t arity : recordArities) {
+            const std::string records =
+                    "detail::getRecordMap<ram::Tuple<RamDomain," + toString(arity) + ">>()";
+            os << "\tProfileEventSingleton::instance().makeQuantityEvent(R\"_(@records;" << arity
+               << ";size)_\", " << records << ".size(),0);\n";
+            os << "\tProfileEventSingleton::instance().makeQuantityEvent(R\"_(@records;" << arity
+               << ";packs)_\", " << records << ".getPackCount(),0);\n";
+        }
         os << "}\n";  // end of dumpFreqs() method
     }
 
     // issue loadAll method
-    os << "public:\n";
-    os << "void loadAll(std::string inputDirectory = \".\") override {\n";
+    hdr << "public:\n";
+    hdr << "void loadAll(std::string inputDirectory = \".\") override;\n";
+    os << "void " << classname << "::loadAll(std::string inputDirectory) {\n";
     visitDepthFirst(*(prog.getMain()), [&](const RamLoad& load) {
         // get some table details
         std::vector<bool> symbolMask;
@@ -2179,11 +2380,11 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
             os << "try {";
             os << "std::map<std::string, std::string> directiveMap(";
             os << ioDirectives << ");\n";
-            os << R"_(if (!inputDirectory.empty() && directiveMap["IO"] == "file" && )_";
-            os << "directiveMap[\"filename\"].front() != '/') {";
-            os << R"_(directiveMap["filename"] = inputDirectory + "/" + directiveMap["filename"];)_";
-            os << "}\n";
             os << "IODirectives ioDirectives(directiveMap);\n";
+            os << "if (!inputDirectory.empty() && ioDirectives.hasFileIOType() && ";
+            os << "ioDirectives.getFileName().front() != '/') {";
+            os << R"_(ioDirectives.setFileName(inputDirectory + "/" + ioDirectives.getFileName());)_";
+            os << "}\n";
             os << "IOSystem::getInstance().getReader(";
             os << "std::vector<bool>({" << join(symbolMask) << "})";
             os << ", symTable, ioDirectives";
@@ -2216,8 +2417,9 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
     };
 
     // dump inputs
-    os << "public:\n";
-    os << "void dumpInputs(std::ostream& out = std::cout) override {\n";
+    hdr << "public:\n";
+    hdr << "void dumpInputs(std::ostream& out = std::cout) override;\n";
+    os << "void " << classname << "::dumpInputs(std::ostream& out) {\n";
     visitDepthFirst(*(prog.getMain()), [&](const RamLoad& load) {
         auto& name = getRelationName(load.getRelation());
         auto& mask = load.getRelation().getAttributeTypeQualifiers();
@@ -2227,8 +2429,9 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
     os << "}\n";  // end of dumpInputs() method
 
     // dump outputs
-    os << "public:\n";
-    os << "void dumpOutputs(std::ostream& out = std::cout) override {\n";
+    hdr << "public:\n";
+    hdr << "void dumpOutputs(std::ostream& out = std::cout) override;\n";
+    os << "void " << classname << "::dumpOutputs(std::ostream& out) {\n";
     visitDepthFirst(*(prog.getMain()), [&](const RamStore& store) {
         auto& name = getRelationName(store.getRelation());
         auto& mask = store.getRelation().getAttributeTypeQualifiers();
@@ -2237,16 +2440,18 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
     });
     os << "}\n";  // end of dumpOutputs() method
 
-    os << "public:\n";
-    os << "SymbolTable& getSymbolTable() override {\n";
-    os << "return symTable;\n";
-    os << "}\n";  // end of getSymbolTable() method
+    hdr << "public:\n";
+    hdr << "SymbolTable& getSymbolTable() override {\n";
+    hdr << "return symTable;\n";
+    hdr << "}\n";  // end of getSymbolTable() method
 
     // TODO: generate code for subroutines
     if (Global::config().has("provenance")) {
         // generate subroutine adapter
-        os << "void executeSubroutine(std::string name, const std::vector<RamDomain>& args, "
-              "std::vector<RamDomain>& ret, std::vector<bool>& err) override {\n";
+        hdr << "void executeSubroutine(std::string name, const std::vector<RamDomain>& args, "
+               "std::vector<RamDomain>& ret, std::vector<bool>& err) override;\n";
+        os << "void " << classname << "::executeSubroutine(std::string name, "
+              "const std::vector<RamDomain>& args, std::vector<RamDomain>& ret, std::vector<bool>& err) {\n";
 
         // subroutine number
         size_t subroutineNum = 0;
@@ -2263,24 +2468,38 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
         subroutineNum = 0;
         for (auto& sub : prog.getSubroutines()) {
             // method header
-            os << "void "
-               << "subproof_" << subroutineNum
-               << "(const std::vector<RamDomain>& args, "
-                  "std::vector<RamDomain>& ret, std::vector<bool>& err) {\n";
+            hdr << "void "
+                << "subproof_" << subroutineNum
+                << "(const std::vector<RamDomain>& args, "
+                   "std::vector<RamDomain>& ret, std::vector<bool>& err);\n";
+
+            // the method is defined by a translation unit of its own
+            std::stringstream unit;
+            if (!headerName.empty()) {
+                unit << "#include \"" << headerName << "\"\n";
+            }
+            unit << "namespace souffle {\n";
+            unit << "using namespace ram;\n";
+            unit << "void " << classname << "::subproof_" << subroutineNum
+                 << "(const std::vector<RamDomain>& args, "
+                    "std::vector<RamDomain>& ret, std::vector<bool>& err) {\n";
 
             // a lock is needed when filling the subroutine return vectors
-            os << "std::mutex lock;\n";
+            unit << "std::mutex lock;\n";
 
             // generate code for body
-            emitCode(os, *sub.second);
+            emitCode(unit, *sub.second);
 
-            os << "return;\n";
-            os << "}\n";  // end of subroutine
+            unit << "return;\n";
+            unit << "}\n";  // end of subroutine
+            unit << "}  // namespace souffle\n";
+            units["subroutine_" + std::to_string(subroutineNum)] = unit.str();
             subroutineNum++;
         }
     }
 
-    os << "};\n";  // end of class declaration
+    hdr << "};\n";  // end of class declaration
+    hdr << "}  // namespace souffle\n";
 
     // hidden hooks
     os << "SouffleProgram *newInstance_" << id << "(){return new " << classname << ";}\n";
@@ -2297,6 +2516,10 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
     os << "};\n";
     os << "static factory_" << classname << " __factory_" << classname << "_instance;\n";
     os << "}\n";
+    // entry point of programs loaded as shared libraries
+    os << "extern \"C\" souffle::SouffleProgram* souffle_newInstance_" << id << "() {\n";
+    os << "return new souffle::" << classname << "();\n";
+    os << "}\n";
     os << "#else\n";
     os << "}\n";
     os << "int main(int argc, char** argv)\n{\n";
@@ -2352,6 +2575,11 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
         os << "obj.runAll(opt.getInputFileDir(), opt.getOutputFileDir(), stratum);\n";
         os << "souffle::mpi::finalize();";
         os << "\n#endif\n";
+    } else if (Global::config().get("engine") == "mpi-replicated") {
+        // all processes run the whole program, each on its own share of the data
+        os << "souffle::mpi::init(argc, argv);\n";
+        os << "obj.runAll(opt.getInputFileDir(), opt.getOutputFileDir(), opt.getStratumIndex());\n";
+        os << "souffle::mpi::finalize();\n";
     } else
 #endif
     {
@@ -96,5 +96,17 @@ public:
 
     /** Generate code */
     void generateCode(std::ostream& os, const std::string& id, bool& withSharedLibrary);
+
+    /**
+     * Generate code split into translation units to be compiled in parallel: the header of the
+     * given name declaring the relation types and the program class, the main translation unit
+     * defining the constructor and the remaining methods of the class, and the translation
+     * units of the strata and subroutines by their names.
+     *
+     * The symbol table is initialized by the main translation unit, such that the header and
+     * the translation units of unchanged strata remain identical when only constants change.
+     */
+    void generateCode(std::ostream& hdr, std::ostream& os, std::map<std::string, std::string>& units,
+            const std::string& headerName, const std::string& id, bool& withSharedLibrary);
 };
 }  // end of namespace souffle
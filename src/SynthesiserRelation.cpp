@@ -7,6 +7,7 @@
  */
 
 #include "SynthesiserRelation.h"
+#include "RamTypes.h"
 #include "RelationRepresentation.h"
 #include "Util.h"
 #include <algorithm>
@@ -28,13 +29,16 @@ std::unique_ptr<SynthesiserRelation> SynthesiserRelation::getSynthesiserRelation
         rel = new SynthesiserNullaryRelation(ramRel, indexSet, isProvenance);
     } else if (ramRel.getRepresentation() == RelationRepresentation::BTREE) {
         rel = new SynthesiserDirectRelation(ramRel, indexSet, isProvenance);
+    } else if (ramRel.getRepresentation() == RelationRepresentation::INDIRECT) {
+        rel = new SynthesiserIndirectRelation(ramRel, indexSet, isProvenance);
     } else if (ramRel.getRepresentation() == RelationRepresentation::BRIE) {
         rel = new SynthesiserBrieRelation(ramRel, indexSet, isProvenance);
     } else if (ramRel.getRepresentation() == RelationRepresentation::EQREL) {
         rel = new SynthesiserEqrelRelation(ramRel, indexSet, isProvenance);
     } else {
-        // Handle the data structure command line flag
-        if (ramRel.getArity() > 6) {
+        // Choose the layout of the tuples by their costs
+        size_t numIndexes = std::max<size_t>(indexSet.getAllOrders().size(), 1);
+        if (isIndirectLayout(ramRel.getArity(), numIndexes, indexSet.getExpectedSize())) {
             rel = new SynthesiserIndirectRelation(ramRel, indexSet, isProvenance);
         } else {
             rel = new SynthesiserDirectRelation(ramRel, indexSet, isProvenance);
@@ -49,6 +53,24 @@ std::unique_ptr<SynthesiserRelation> SynthesiserRelation::getSynthesiserRelation
     return std::unique_ptr<SynthesiserRelation>(rel);
 }
 
+bool SynthesiserRelation::isIndirectLayout(size_t arity, size_t numIndexes, size_t expectedSize) {
+    // relations below this size fit into the caches in either layout
+    const size_t smallRelationBytes = 1 << 20;
+
+    // bytes per tuple if each index stores a copy of the tuple
+    const size_t directBytes = numIndexes * arity * sizeof(RamDomain);
+
+    // bytes per tuple if each index stores a pointer to a single copy of the tuple, where
+    // pointers count twice for the dereferencing by each comparison
+    const size_t indirectBytes = arity * sizeof(RamDomain) + numIndexes * 2 * sizeof(void*);
+
+    // small relations prefer the cheaper comparisons of the direct layout
+    if (expectedSize != 0 && expectedSize * directBytes <= smallRelationBytes) {
+        return false;
+    }
+    return indirectBytes < directBytes;
+}
+
 // -------- Nullary Relation --------
 
 /** Generate index set for a nullary relation, which should be empty */
@@ -241,6 +263,42 @@ void SynthesiserDirectRelation::generateTypeStruct(std::ostream& out) {
     out << "return insert(data);\n";
     out << "}\n";  // end of insert(RamDomain x1, RamDomain x2, ...)
 
+    // batch insertion of tuples read from input, sorted for the master index to benefit from the hints
+    out << "void insertBatch(const RamDomain* ramDomain, size_t numTuples) {\n";
+    out << "std::vector<t_tuple> tuples(numTuples);\n";
+    out << "std::copy(ramDomain, ramDomain + numTuples * " << arity
+        << ", reinterpret_cast<RamDomain*>(tuples.data()));\n";
+    out << "index_utils::comparator<" << join(inds[masterIndex]) << "> comparator;\n";
+    out << "std::sort(tuples.begin(), tuples.end(), ";
+    out << "[&](const t_tuple& a, const t_tuple& b) { return comparator.less(a, b); });\n";
+    out << "context h;\n";
+    if (isProvenance) {
+        // provenance indexes update existing tuples, so tuples are inserted one by one
+        out << "for (const auto& tuple : tuples) {\n";
+        out << "insert(tuple, h);\n";
+        out << "}\n";
+    } else {
+        // drop duplicates and present tuples, then merge the new tuples into each index in its order
+        out << "tuples.erase(std::unique(tuples.begin(), tuples.end(), ";
+        out << "[&](const t_tuple& a, const t_tuple& b) { return comparator.equal(a, b); }), ";
+        out << "tuples.end());\n";
+        out << "tuples.erase(std::remove_if(tuples.begin(), tuples.end(), [&](const t_tuple& t) { ";
+        out << "return ind_" << masterIndex << ".contains(t, h.hints_" << masterIndex
+            << "); }), tuples.end());\n";
+        out << "ind_" << masterIndex << ".insertSorted(tuples.begin(), tuples.end());\n";
+        for (size_t i = 0; i < numIndexes; i++) {
+            if (i != masterIndex) {
+                out << "{\n";
+                out << "index_utils::comparator<" << join(inds[i]) << "> comparator;\n";
+                out << "std::sort(tuples.begin(), tuples.end(), ";
+                out << "[&](const t_tuple& a, const t_tuple& b) { return comparator.less(a, b); });\n";
+                out << "ind_" << i << ".insertSorted(tuples.begin(), tuples.end());\n";
+                out << "}\n";
+            }
+        }
+    }
+    out << "}\n";  // end of insertBatch(RamDomain*, size_t)
+
     // insertAll methods
     out << "template <typename T>\n";
     out << "void insertAll(T& other) {\n";
@@ -334,6 +392,16 @@ void SynthesiserDirectRelation::generateTypeStruct(std::ostream& out) {
         out << "}\n";
     }
 
+    // lower and upper bounds of each index, searched by leapfrog joins
+    for (size_t i = 0; i < numIndexes; i++) {
+        out << "t_ind_" << i << "::iterator lowerBound_" << i << "(const t_tuple& t, context& h) const {\n";
+        out << "return ind_" << i << ".lower_bound(t, h.hints_" << i << ");\n";
+        out << "}\n";
+        out << "t_ind_" << i << "::iterator upperBound_" << i << "(const t_tuple& t, context& h) const {\n";
+        out << "return ind_" << i << ".upper_bound(t, h.hints_" << i << ");\n";
+        out << "}\n";
+    }
+
     // empty method
     out << "bool empty() const {\n";
     out << "return ind_" << masterIndex << ".empty();\n";
@@ -461,9 +529,8 @@ void SynthesiserIndirectRelation::generateTypeStruct(std::ostream& out) {
     // stored tuple type
     out << "using t_tuple = Tuple<RamDomain, " << arity << ">;\n";
 
-    // table and lock required for storing actual data for indirect indices
-    out << "Table<t_tuple> dataTable;\n";
-    out << "Lock insert_lock;\n";
+    // arena storing the actual data for indirect indices, filled concurrently
+    out << "TupleArena<t_tuple> dataTable;\n";
 
     // btree types
     for (size_t i = 0; i < inds.size(); i++) {
@@ -508,13 +575,13 @@ void SynthesiserIndirectRelation::generateTypeStruct(std::ostream& out) {
     out << "return insert(t, h);\n";
     out << "}\n";
 
+    // the master index decides which of several concurrently inserted copies is retained
     out << "bool insert(const t_tuple& t, context& h) {\n";
-    out << "const t_tuple* masterCopy = nullptr;\n";
-    out << "{\n";
-    out << "auto lease = insert_lock.acquire();\n";
     out << "if (contains(t, h)) return false;\n";
-    out << "masterCopy = &dataTable.insert(t);\n";
-    out << "ind_" << masterIndex << ".insert(masterCopy, h.hints_" << masterIndex << ");\n";
+    out << "const t_tuple* masterCopy = &dataTable.insert(t);\n";
+    out << "if (!ind_" << masterIndex << ".insert(masterCopy, h.hints_" << masterIndex << ")) {\n";
+    out << "dataTable.release(*masterCopy);\n";
+    out << "return false;\n";
     out << "}\n";
     for (size_t i = 0; i < numIndexes; i++) {
         if (i != masterIndex) {
@@ -542,6 +609,20 @@ void SynthesiserIndirectRelation::generateTypeStruct(std::ostream& out) {
     out << "return insert(data);\n";
     out << "}\n";  // end of insert(RamDomain x1, RamDomain x2, ...)
 
+    // batch insertion of tuples read from input, sorted for the master index to benefit from the hints
+    out << "void insertBatch(const RamDomain* ramDomain, size_t numTuples) {\n";
+    out << "std::vector<t_tuple> tuples(numTuples);\n";
+    out << "std::copy(ramDomain, ramDomain + numTuples * " << arity
+        << ", reinterpret_cast<RamDomain*>(tuples.data()));\n";
+    out << "index_utils::comparator<" << join(inds[masterIndex]) << "> comparator;\n";
+    out << "std::sort(tuples.begin(), tuples.end(), ";
+    out << "[&](const t_tuple& a, const t_tuple& b) { return comparator.less(a, b); });\n";
+    out << "context h;\n";
+    out << "for (const auto& tuple : tuples) {\n";
+    out << "insert(tuple, h);\n";
+    out << "}\n";
+    out << "}\n";  // end of insertBatch(RamDomain*, size_t)
+
     // insertAll method
     // do not use the specialized insertAll as it will copy references rather than tuples
     out << "template <typename T>\n";
@@ -627,6 +708,16 @@ void SynthesiserIndirectRelation::generateTypeStruct(std::ostream& out) {
         out << "}\n";
     }
 
+    // lower and upper bounds of each index, searched by leapfrog joins
+    for (size_t i = 0; i < numIndexes; i++) {
+        out << "iterator_" << i << " lowerBound_" << i << "(const t_tuple& t, context& h) const {\n";
+        out << "return ind_" << i << ".lower_bound(&t, h.hints_" << i << ");\n";
+        out << "}\n";
+        out << "iterator_" << i << " upperBound_" << i << "(const t_tuple& t, context& h) const {\n";
+        out << "return ind_" << i << ".upper_bound(&t, h.hints_" << i << ");\n";
+        out << "}\n";
+    }
+
     // empty method
     out << "bool empty() const {\n";
     out << "return ind_" << masterIndex << ".empty();\n";
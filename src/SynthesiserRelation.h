@@ -61,6 +61,13 @@ public:
     /** Generate relation type struct */
     virtual void generateTypeStruct(std::ostream& out) = 0;
 
+    /**
+     * Decides whether the tuples of a relation are stored indirectly, i.e., once in an arena
+     * referenced by all indexes, rather than by each index, given the arity, the number of
+     * indexes and the expected number of tuples of the relation (0 if unknown)
+     */
+    static bool isIndirectLayout(size_t arity, size_t numIndexes, size_t expectedSize);
+
     /** Factory method to generate a SynthesiserRelation */
     static std::unique_ptr<SynthesiserRelation> getSynthesiserRelation(
             const RamRelation& ramRel, const MinIndexSelection& indexSet, bool isProvenance);
@@ -0,0 +1,148 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2019, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file TupleArena.h
+ *
+ * A concurrent arena storing a position-fixed collection of tuples,
+ * referenced by the indexes of indirect relations.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "ParallelUtils.h"
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace souffle {
+
+/**
+ * An arena of objects whose addresses remain stable until the arena is cleared.
+ *
+ * Each thread allocates from the block of its own slot by an atomic increment, such
+ * that parallel insertions do not contend; the lock of the arena is only acquired
+ * to install a fresh block, once every blockSize insertions. Threads sharing a slot,
+ * e.g. beyond the number of slots, remain correct but compete for the same block.
+ *
+ * Unlike Table, the arena is not iterable: its elements are accessed through the
+ * pointers held by the indexes of a relation.
+ */
+template <typename T, unsigned blockSize = 1024>
+class TupleArena {
+    struct Block {
+        /** The number of claimed elements, exceeding blockSize once the block is exhausted */
+        std::atomic<std::size_t> used;
+        T data[blockSize];
+
+        Block(std::size_t used) : used(used) {}
+    };
+
+    /** A slot holding the current block of a thread, padded to its own cache line */
+    struct Slot {
+        std::atomic<Block*> block{nullptr};
+        char padding[64 - sizeof(std::atomic<Block*>)];
+    };
+
+    /** The number of slots, bounding the number of threads allocating without contention */
+    static constexpr std::size_t NUM_SLOTS = 64;
+
+    Slot slots[NUM_SLOTS];
+
+    /** All blocks allocated so far, protected by the lock */
+    std::vector<Block*> blocks;
+    Lock lock;
+
+public:
+    TupleArena() = default;
+    TupleArena(const TupleArena&) = delete;
+    TupleArena& operator=(const TupleArena&) = delete;
+
+    ~TupleArena() {
+        clear();
+    }
+
+    /**
+     * Stores a copy of the given element, returning a reference that remains valid
+     * until the arena is cleared. May be called concurrently.
+     */
+    const T& insert(const T& element) {
+        Slot& slot = slots[getSlot()];
+        while (true) {
+            Block* block = slot.block.load(std::memory_order_acquire);
+            if (block != nullptr) {
+                std::size_t pos = block->used.fetch_add(1, std::memory_order_relaxed);
+                if (pos < blockSize) {
+                    block->data[pos] = element;
+                    return block->data[pos];
+                }
+            }
+
+            // the block is exhausted => install a fresh one, unless another thread did so
+            auto lease = lock.acquire();
+            if (slot.block.load(std::memory_order_relaxed) == block) {
+                Block* fresh = new Block(1);
+                fresh->data[0] = element;
+                blocks.push_back(fresh);
+                slot.block.store(fresh, std::memory_order_release);
+                return fresh->data[0];
+            }
+        }
+    }
+
+    /**
+     * Returns the element most recently inserted by the calling thread, e.g. a copy
+     * found to be a duplicate, to the arena. If other threads have allocated from the
+     * same block in the meantime, the element is retained but never reused.
+     */
+    void release(const T& element) {
+        Block* block = slots[getSlot()].block.load(std::memory_order_acquire);
+        if (block == nullptr || &element < block->data || &element >= block->data + blockSize) {
+            return;
+        }
+        const std::size_t pos = &element - block->data;
+        std::size_t expected = pos + 1;
+        block->used.compare_exchange_strong(expected, pos, std::memory_order_relaxed);
+    }
+
+    /** Removes all elements, invalidating all references; must not be called concurrently */
+    void clear() {
+        for (Block* block : blocks) {
+            delete block;
+        }
+        blocks.clear();
+        for (Slot& slot : slots) {
+            slot.block.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    /** Obtains the number of allocated blocks */
+    std::size_t getNumBlocks() const {
+        return blocks.size();
+    }
+
+    /** Obtains the number of bytes allocated for elements */
+    std::size_t getMemoryUsage() const {
+        return blocks.size() * sizeof(Block);
+    }
+
+private:
+    /** Obtains the slot of the calling thread */
+    static std::size_t getSlot() {
+#ifdef IS_PARALLEL
+        return static_cast<std::size_t>(omp_get_thread_num()) % NUM_SLOTS;
+#else
+        return 0;
+#endif
+    }
+};
+
+}  // end of namespace souffle
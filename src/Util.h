@@ -31,6 +31,7 @@
 #include <ostream>
 #include <set>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
@@ -40,6 +41,7 @@
 #include <cerrno>
 #include <climits>
 #include <cstdarg>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <libgen.h>
@@ -969,6 +971,24 @@ bool none_of(const Container& c, UnaryPredicate p) {
     return std::none_of(c.begin(), c.end(), p);
 }
 
+/**
+ * Hashes the first elements of a tuple by multiplicative hashing, mixing the upper
+ * bits into the lower ones after each element.
+ *
+ * @param tuple the tuple, indexable by position
+ * @param length the number of elements to hash
+ * @return a hash value whose upper and lower bits both depend on every element
+ */
+template <typename T>
+inline uint64_t hashTuple(const T& tuple, std::size_t length) {
+    uint64_t res = 0;
+    for (std::size_t i = 0; i < length; i++) {
+        res = (res ^ uint64_t(tuple[i])) * 0x9e3779b97f4a7c15ull;
+        res ^= res >> 32;
+    }
+    return res;
+}
+
 // -------------------------------------------------------------------------------
 //                               Timing Utils
 // -------------------------------------------------------------------------------
@@ -1175,6 +1195,17 @@ inline std::string tempFile() {
     return std::string(templ);
 }
 
+/**
+ * Generate temporary directory.
+ */
+inline std::string tempDir() {
+    char templ[40] = "./souffleXXXXXX";
+    if (mkdtemp(templ) == nullptr) {
+        throw std::runtime_error("cannot create temporary directory");
+    }
+    return std::string(templ);
+}
+
 /**
  * Stringify a string using escapes for newline, tab, double-quotes and semicolons
  */
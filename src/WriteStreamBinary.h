@@ -0,0 +1,169 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2019, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file WriteStreamBinary.h
+ *
+ * Writes relations in the binary columnar format of BinaryFormat.h
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "BinaryFormat.h"
+#include "IODirectives.h"
+#include "RamTypes.h"
+#include "SymbolTable.h"
+#include "WriteStream.h"
+#ifdef USE_LIBZ
+#include "gzfstream.h"
+#endif
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace souffle {
+
+/**
+ * Collects the tuples of a relation column-wise and writes them when destroyed.
+ *
+ * Only the symbols occurring in the relation are written to the dictionary,
+ * numbered in order of their first occurrence.
+ */
+class WriteStreamBinary : public WriteStream {
+public:
+    WriteStreamBinary(std::ostream& file, const std::vector<bool>& symbolMask, const SymbolTable& symbolTable,
+            const bool provenance)
+            : WriteStream(symbolMask, symbolTable, provenance), file(file), columns(arity) {}
+
+    ~WriteStreamBinary() override = default;
+
+protected:
+    void writeNullary() override {
+        numTuples = 1;
+    }
+
+    void writeNextTuple(const RamDomain* tuple) override {
+        for (size_t col = 0; col < arity; ++col) {
+            RamDomain value = tuple[col];
+            if (symbolMask[col]) {
+                auto it = dictionary.find(value);
+                if (it == dictionary.end()) {
+                    it = dictionary.emplace(value, symbols.size()).first;
+                    symbols.push_back(value);
+                }
+                value = it->second;
+            }
+            columns[col].push_back(value);
+        }
+        numTuples++;
+    }
+
+    /** Write the collected relation; to be called once by the destructor of the derived class */
+    void writeFile() {
+        BinaryFileHeader header = BinaryFileHeader::create(arity);
+        header.numTuples = numTuples;
+        header.numSymbols = symbols.size();
+
+        std::string types;
+        for (size_t col = 0; col < arity; ++col) {
+            types += symbolMask[col] ? 's' : 'i';
+        }
+        types.append(binaryPadding(types.size()), '\0');
+
+        std::string dict;
+        for (RamDomain symbol : symbols) {
+            const std::string& str = symbolTable.resolve(symbol);
+            uint32_t length = str.size();
+            dict.append(reinterpret_cast<const char*>(&length), sizeof(length));
+            dict += str;
+        }
+        dict.append(binaryPadding(dict.size()), '\0');
+        header.dictionarySize = dict.size();
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(types.data(), types.size());
+        file.write(dict.data(), dict.size());
+        for (const auto& column : columns) {
+            file.write(reinterpret_cast<const char*>(column.data()), column.size() * sizeof(RamDomain));
+        }
+        file.flush();
+    }
+
+    std::ostream& file;
+    std::vector<std::vector<RamDomain>> columns;
+    size_t numTuples = 0;
+
+    /** Symbol table indices of the written symbols, and their position in this list */
+    std::vector<RamDomain> symbols;
+    std::unordered_map<RamDomain, RamDomain> dictionary;
+};
+
+class WriteFileBinary : public WriteStreamBinary {
+public:
+    WriteFileBinary(const std::vector<bool>& symbolMask, const SymbolTable& symbolTable,
+            const IODirectives& ioDirectives, const bool provenance = false)
+            : WriteStreamBinary(fileHandle, symbolMask, symbolTable, provenance),
+              fileHandle(ioDirectives.getFileName(), std::ios::out | std::ios::binary) {
+        if (!fileHandle.is_open()) {
+            throw std::invalid_argument("Cannot open output file " + ioDirectives.getFileName() + "\n");
+        }
+    }
+
+    ~WriteFileBinary() override {
+        writeFile();
+    }
+
+protected:
+    std::ofstream fileHandle;
+};
+
+#ifdef USE_LIBZ
+class WriteGZipFileBinary : public WriteStreamBinary {
+public:
+    WriteGZipFileBinary(const std::vector<bool>& symbolMask, const SymbolTable& symbolTable,
+            const IODirectives& ioDirectives, const bool provenance = false)
+            : WriteStreamBinary(fileHandle, symbolMask, symbolTable, provenance),
+              fileHandle(ioDirectives.getFileName(), std::ios::out | std::ios::binary) {}
+
+    ~WriteGZipFileBinary() override {
+        writeFile();
+    }
+
+protected:
+    gzfstream::ogzfstream fileHandle;
+};
+#endif
+
+class WriteFileBinaryFactory : public WriteStreamFactory {
+public:
+    std::unique_ptr<WriteStream> getWriter(const std::vector<bool>& symbolMask,
+            const SymbolTable& symbolTable, const IODirectives& ioDirectives,
+            const bool provenance) override {
+#ifdef USE_LIBZ
+        if (ioDirectives.has("compress")) {
+            return std::make_unique<WriteGZipFileBinary>(symbolMask, symbolTable, ioDirectives, provenance);
+        }
+#endif
+        return std::make_unique<WriteFileBinary>(symbolMask, symbolTable, ioDirectives, provenance);
+    }
+    const std::string& getName() const override {
+        static const std::string name = "binary";
+        return name;
+    }
+    ~WriteFileBinaryFactory() override = default;
+};
+
+} /* namespace souffle */
@@ -25,6 +25,7 @@
 #include "ErrorReport.h"
 #include "Explain.h"
 #include "Global.h"
+#include "JitCompiler.h"
 #include "LVM.h"
 #include "LVMProgInterface.h"
 #include "ParserDriver.h"
@@ -51,6 +52,7 @@
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <set>
 #include <stdexcept>
@@ -61,9 +63,10 @@
 
 namespace souffle {
 /**
- * Executes a binary file.
+ * Executes a binary file, removing it and the given generated files afterwards unless the binary
+ * is the requested output.
  */
-void executeBinary(const std::string& binaryFilename
+void executeBinary(const std::string& binaryFilename, const std::vector<std::string>& generatedFilenames
 #ifdef USE_MPI
         ,
         const int numberOfProcesses
@@ -79,13 +82,18 @@ void executeBinary(const std::string& binaryFilename
     // run the executable
     int exitCode;
 #ifdef USE_MPI
-    if (Global::config().get("engine") == "mpi") {
+    if (Global::config().get("engine") == "mpi" || Global::config().get("engine") == "mpi-replicated") {
         std::stringstream ss;
         ss << "mpiexec";
         if (Global::config().has("hostfile")) {
             ss << " --hostfile " << Global::config().get("hostfile");
         }
-        ss << " -n " << std::to_string(numberOfProcesses);
+        if (Global::config().get("engine") == "mpi") {
+            ss << " -n " << std::to_string(numberOfProcesses);
+        } else if (Global::config().has("processes")) {
+            // otherwise, mpiexec uses all available slots for replicated execution
+            ss << " -n " << Global::config().get("processes");
+        }
         ss << " " << binaryFilename;
         exitCode = system(ss.str().c_str());
     } else
@@ -104,7 +112,9 @@ void executeBinary(const std::string& binaryFilename
 
     if (Global::config().get("dl-program").empty()) {
         remove(binaryFilename.c_str());
-        remove((binaryFilename + ".cpp").c_str());
+        for (const std::string& filename : generatedFilenames) {
+            remove(filename.c_str());
+        }
     }
 
     // exit with same code as executable
@@ -114,9 +124,9 @@ void executeBinary(const std::string& binaryFilename
 }
 
 /**
- * Compiles the given source file to a binary file.
+ * Compiles the given source files to a binary file named after the first one.
  */
-void compileToBinary(std::string compileCmd, const std::string& sourceFilename) {
+void compileToBinary(std::string compileCmd, const std::vector<std::string>& sourceFilenames) {
     // add source code
     compileCmd += ' ';
     for (const std::string& path : splitString(Global::config().get("library-dir"), ' ')) {
@@ -134,11 +144,11 @@ void compileToBinary(std::string compileCmd, const std::string& sourceFilename)
         compileCmd += "-l" + library + ' ';
     }
 
-    compileCmd += sourceFilename;
+    compileCmd += toString(join(sourceFilenames, " "));
 
     // run executable
     if (system(compileCmd.c_str()) != 0) {
-        throw std::invalid_argument("failed to compile C++ source <" + sourceFilename + ">");
+        throw std::invalid_argument("failed to compile C++ source <" + sourceFilenames.front() + ">");
     }
 }
 
@@ -209,12 +219,28 @@ int main(int argc, char** argv) {
                 {"pragma", 'P', "OPTIONS", "", false, "Set pragma options."},
                 {"provenance", 't', "[ none | explain | explore ]", "", false,
                         "Enable provenance instrumentation and interaction."},
-                {"engine", 'e', "[ file | mpi ]", "", false,
+                {"engine", 'e', "[ file | mpi | mpi-replicated ]", "", false,
                         "Specify communication engine for distributed execution."},
-                {"interpreter", '\1', "[ RAMI | LVM ]", "LVM", false, "Switch interpreter implementation."},
+                {"interpreter", '\1', "[ RAMI | LVM | LVM-REG ]", "LVM", false,
+                        "Switch interpreter implementation. LVM-REG evaluates expressions with registers."},
+                {"adaptive-joins", '\6', "", "", false,
+                        "Choose the join order of recursive rules in every iteration (interpreter only)."},
+                {"leapfrog-joins", '\7', "", "", false,
+                        "Evaluate rules with cyclic bodies by worst-case optimal leapfrog joins."},
+                {"index-limit", '\10', "N", "", false,
+                        "Limit the number of indexes per relation to N, trading lookup speed for memory."},
+                {"split-strata", '\11', "", "", false,
+                        "Generate a C++ translation unit per stratum and subroutine, compiled in "
+                        "parallel and cached."},
+                {"jit", '\12', "MS", "", false,
+                        "Compile the program in the background once the interpreter spent MS milliseconds "
+                        "on a stratum, and evaluate the hot stratum and the following ones by the compiled "
+                        "program (RAMI only)."},
                 {"hostfile", '\2', "FILE", "", false,
                         "Specify --hostfile option for call to mpiexec when using mpi as "
                         "execution engine."},
+                {"processes", '\5', "N", "", false,
+                        "Run N processes when using mpi-replicated as execution engine."},
                 {"verbose", 'v', "", "", false, "Verbose output."},
                 {"version", '\3', "", "", false, "Version."},
                 {"help", 'h', "", "", false, "Display this help message."}};
@@ -320,6 +346,57 @@ int main(int argc, char** argv) {
             Global::config().set("compile");
         }
 
+        /* join orders are only adapted at runtime by the interpreters */
+        if (Global::config().has("adaptive-joins") &&
+                (Global::config().has("compile") || Global::config().has("generate"))) {
+            throw std::invalid_argument(
+                    "Error: Use of adaptive joins not yet available for synthesized programs.");
+        }
+
+        /* leapfrog joins are evaluated by the RAM interpreter and synthesized programs */
+        if (Global::config().has("leapfrog-joins")) {
+            if (Global::config().has("provenance")) {
+                throw std::invalid_argument(
+                        "Error: Use of leapfrog joins not yet available with provenance.");
+            }
+            if (!(Global::config().has("compile") || Global::config().has("generate")) &&
+                    Global::config().get("interpreter") != "RAMI") {
+                throw std::invalid_argument("Error: Use of leapfrog joins requires the RAMI interpreter "
+                                            "or a synthesized program.");
+            }
+        }
+
+        /* ensure that the index limit is a positive number */
+        if (Global::config().has("index-limit")) {
+            if (!isNumber(Global::config().get("index-limit").c_str()) ||
+                    std::stoi(Global::config().get("index-limit")) < 1) {
+                throw std::invalid_argument("Wrong parameter " + Global::config().get("index-limit") +
+                                            " for option --index-limit!");
+            }
+            if (Global::config().has("provenance")) {
+                throw std::invalid_argument("Error: Use of index limit not yet available with provenance.");
+            }
+        }
+
+        /* strata are compiled just in time for the RAM interpreter only */
+        if (Global::config().has("jit")) {
+            if (Global::config().has("compile") || Global::config().has("generate")) {
+                throw std::invalid_argument("Error: Use of jit not available for synthesized programs.");
+            }
+            if (Global::config().get("interpreter") != "RAMI") {
+                throw std::invalid_argument("Error: Use of jit requires the RAMI interpreter.");
+            }
+            if (Global::config().has("profile") || Global::config().has("provenance")) {
+                throw std::invalid_argument(
+                        "Error: Use of jit not yet available with profiling or provenance.");
+            }
+            if (!isNumber(Global::config().get("jit").c_str()) ||
+                    std::stol(Global::config().get("jit")) < 0) {
+                throw std::invalid_argument(
+                        "Wrong parameter " + Global::config().get("jit") + " for option --jit!");
+            }
+        }
+
         /* disable provenance with engine option */
         if (Global::config().has("provenance")) {
             if (Global::config().has("engine")) {
@@ -334,26 +411,39 @@ int main(int argc, char** argv) {
                 throw std::invalid_argument("Error: Use of engine option not yet available for interpreter.");
             }
             const auto& engine = Global::config().get("engine");
-            if (engine != "file" && engine != "mpi") {
+            if (engine != "file" && engine != "mpi" && engine != "mpi-replicated") {
                 throw std::invalid_argument("Error: Use of engine '" + engine + "' is not supported.");
             }
 #ifndef USE_MPI
-            if (engine == "mpi") {
+            if (engine == "mpi" || engine == "mpi-replicated") {
                 throw std::invalid_argument("Error: Use of engine '" + engine +
-                                            "' requires configure option '--enable-" + engine + "'.");
+                                            "' requires configure option '--enable-mpi'.");
             }
             if (Global::config().has("hostfile")) {
                 throw std::invalid_argument(
-                        "Error: Use of hostfile option requires configure option '--enable-" + engine + "'.");
+                        "Error: Use of hostfile option requires configure option '--enable-mpi'.");
             }
 #else
-            if (engine != "mpi" && Global::config().has("hostfile")) {
+            if (engine == "file" && Global::config().has("hostfile")) {
                 throw std::invalid_argument(
-                        "Error: Use of hostfile option requires execution engine '" + engine + "'.");
+                        "Error: Use of hostfile option requires execution engine 'mpi' or 'mpi-replicated'.");
             }
 #endif
         }
 
+        /* ensure that the number of processes is only given for replicated execution */
+        if (Global::config().has("processes")) {
+            if (Global::config().get("engine") != "mpi-replicated") {
+                throw std::invalid_argument(
+                        "Error: Use of processes option requires execution engine 'mpi-replicated'.");
+            }
+            if (!isNumber(Global::config().get("processes").c_str()) ||
+                    std::stoi(Global::config().get("processes")) < 1) {
+                throw std::invalid_argument("Wrong parameter " + Global::config().get("processes") +
+                                            " for option --processes!");
+            }
+        }
+
         if (Global::config().has("live-profile") && !Global::config().has("profile")) {
             Global::config().set("profile");
         }
@@ -501,12 +591,20 @@ int main(int argc, char** argv) {
     std::unique_ptr<RamTranslationUnit> ramTranslationUnit =
             AstTranslator().translateUnit(*astTranslationUnit);
 
+    // the maximal number of indexes of a relation, if limited
+    const size_t indexLimit =
+            Global::config().has("index-limit") ? std::stoi(Global::config().get("index-limit")) : 0;
+
     std::unique_ptr<RamTransformer> ramTransform = std::make_unique<RamTransformerSequence>(
             std::make_unique<RamLoopTransformer>(
                     std::make_unique<RamTransformerSequence>(std::make_unique<ExpandFilterTransformer>(),
                             std::make_unique<HoistConditionsTransformer>(),
                             std::make_unique<MakeIndexTransformer>())),
-            std::make_unique<IfConversionTransformer>(), std::make_unique<ChoiceConversionTransformer>(),
+            std::make_unique<IfConversionTransformer>(),
+            std::make_unique<RamConditionalTransformer>(
+                    []() -> bool { return Global::config().has("index-limit"); },
+                    std::make_unique<ReduceIndexesTransformer>(indexLimit)),
+            std::make_unique<ChoiceConversionTransformer>(),
             std::make_unique<CollapseFiltersTransformer>(), std::make_unique<TupleIdTransformer>(),
             std::make_unique<RamLoopTransformer>(std::make_unique<RamTransformerSequence>(
                     std::make_unique<HoistAggregateTransformer>(), std::make_unique<TupleIdTransformer>())),
@@ -534,7 +632,8 @@ int main(int argc, char** argv) {
         }
 
         // configure and execute interpreter
-        if (Global::config().get("interpreter") == "LVM") {
+        const std::string& interpreter = Global::config().get("interpreter");
+        if (interpreter == "LVM" || interpreter == "LVM-REG") {
             std::unique_ptr<LVMInterface> lvm(std::make_unique<LVM>(*ramTranslationUnit));
             lvm->executeMain();
             // If the profiler was started, join back here once it exits.
@@ -551,7 +650,16 @@ int main(int argc, char** argv) {
                 }
             }
         } else {
-            std::unique_ptr<RAMIInterface> rami(std::make_unique<RAMI>(*ramTranslationUnit));
+            std::unique_ptr<JitCompiler> jit;
+            if (Global::config().has("jit")) {
+                std::string compileCmd = ::findTool("souffle-compile", souffleExecutable, ".");
+                if (!isExecutable(compileCmd)) {
+                    throw std::runtime_error("failed to locate souffle-compile");
+                }
+                jit = std::make_unique<JitCompiler>(
+                        *ramTranslationUnit, compileCmd, std::stol(Global::config().get("jit")));
+            }
+            std::unique_ptr<RAMIInterface> rami(std::make_unique<RAMI>(*ramTranslationUnit, std::move(jit)));
             rami->executeMain();
             // If the profiler was started, join back here once it exits.
             if (profiler.joinable()) {
@@ -582,6 +690,7 @@ int main(int argc, char** argv) {
         try {
             // Find the base filename for code generation and execution
             std::string baseFilename;
+            std::string tempDirname;
             if (Global::config().has("dl-program")) {
                 baseFilename = Global::config().get("dl-program");
             } else if (Global::config().has("generate")) {
@@ -590,6 +699,11 @@ int main(int argc, char** argv) {
                 if (baseFilename.size() >= 4 && baseFilename.substr(baseFilename.size() - 4) == ".cpp") {
                     baseFilename = baseFilename.substr(0, baseFilename.size() - 4);
                 }
+            } else if (Global::config().has("split-strata")) {
+                // files named after the program in a fresh directory, such that the translation units
+                // of subsequent runs are identical and found in the object cache of souffle-compile
+                tempDirname = tempDir();
+                baseFilename = tempDirname + "/" + identifier(simpleName(Global::config().get("")));
             } else {
                 baseFilename = tempFile();
             }
@@ -600,9 +714,30 @@ int main(int argc, char** argv) {
             std::string baseIdentifier = identifier(simpleName(baseFilename));
             std::string sourceFilename = baseFilename + ".cpp";
 
+            // the generated translation units, starting with the main one, and all generated files
+            std::vector<std::string> sourceFilenames{sourceFilename};
+            std::vector<std::string> generatedFilenames{sourceFilename};
+
             bool withSharedLibrary;
             std::ofstream os(sourceFilename);
-            synthesiser->generateCode(os, baseIdentifier, withSharedLibrary);
+            if (Global::config().has("split-strata")) {
+                std::string headerFilename = baseFilename + ".h";
+                std::ofstream hdr(headerFilename);
+                std::map<std::string, std::string> units;
+                synthesiser->generateCode(
+                        hdr, os, units, baseName(headerFilename), baseIdentifier, withSharedLibrary);
+                for (const auto& unit : units) {
+                    sourceFilenames.push_back(baseFilename + "_" + unit.first + ".cpp");
+                    std::ofstream(sourceFilenames.back()) << unit.second;
+                }
+                generatedFilenames = sourceFilenames;
+                generatedFilenames.push_back(headerFilename);
+                if (!tempDirname.empty()) {
+                    generatedFilenames.push_back(tempDirname);
+                }
+            } else {
+                synthesiser->generateCode(os, baseIdentifier, withSharedLibrary);
+            }
             os.close();
 
             if (withSharedLibrary) {
@@ -616,7 +751,7 @@ int main(int argc, char** argv) {
 
             if (Global::config().has("compile")) {
                 auto start = std::chrono::high_resolution_clock::now();
-                compileToBinary(compileCmd, sourceFilename);
+                compileToBinary(compileCmd, sourceFilenames);
                 /* Report overall run-time in verbose mode */
                 if (Global::config().has("verbose")) {
                     auto end = std::chrono::high_resolution_clock::now();
@@ -625,7 +760,7 @@ int main(int argc, char** argv) {
                 }
                 // run compiled C++ program if requested.
                 if (!Global::config().has("dl-program")) {
-                    executeBinary(baseFilename
+                    executeBinary(baseFilename, generatedFilenames
 #ifdef USE_MPI
                             ,
                             ((int)astTranslationUnit->getAnalysis<SCCGraph>()->getNumberOfSCCs()) + 1
@@ -92,6 +92,13 @@ private:
 class RecursiveRuleVisitor : public DSNVisitor<Rule> {
 public:
     RecursiveRuleVisitor(Rule& rule) : DSNVisitor(rule) {}
+    void visit(SizeEntry& size) override {
+        if (size.getKey() == "variant") {
+            base.setVariant(size.getSize());
+        } else {
+            DSNVisitor::visit(size);
+        }
+    }
     void visit(DirectoryEntry& directory) override {
         if (directory.getKey() == "atom-frequency") {
             AtomFrequenciesVisitor atomFrequenciesVisitor(base);
@@ -248,6 +255,18 @@ public:
             for (const auto& key : directory.getKeys()) {
                 directory.readEntry(key)->accept(rulesVisitor);
             }
+        } else if (directory.getKey() == "statistics") {
+            for (const auto& key : directory.getKeys()) {
+                auto* column = dynamic_cast<DirectoryEntry*>(directory.readEntry(key));
+                if (column == nullptr) {
+                    continue;
+                }
+                auto* distinct = dynamic_cast<SizeEntry*>(column->readEntry("distinct"));
+                auto* maxFrequency = dynamic_cast<SizeEntry*>(column->readEntry("max-frequency"));
+                if (distinct != nullptr && maxFrequency != nullptr) {
+                    base.setColumnStatistics(std::stoul(key), distinct->getSize(), maxFrequency->getSize());
+                }
+            }
         } else if (directory.getKey() == "maxRSS") {
             auto* preMaxRSS = dynamic_cast<SizeEntry*>(directory.readEntry("pre"));
             auto* postMaxRSS = dynamic_cast<SizeEntry*>(directory.readEntry("post"));
@@ -297,6 +316,7 @@ public:
      * Read the contents from file into the class
      */
     void processFile() {
+        ProfileEventSingleton::instance().update();
         rel_id = 0;
         relationMap.clear();
         auto programDuration = dynamic_cast<DurationEntry*>(db.lookupEntry({"program", "runtime"}));
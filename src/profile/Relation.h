@@ -10,6 +10,7 @@
 
 #include "Iteration.h"
 #include "Rule.h"
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <sstream>
@@ -40,6 +41,9 @@ private:
     int recursiveId = 0;
     size_t tuplesRead = 0;
 
+    /** The estimated number of distinct values and of occurrences of the most common value per column */
+    std::vector<std::pair<size_t, size_t>> columnStatistics;
+
     std::vector<std::shared_ptr<Iteration>> iterations;
 
     std::unordered_map<std::string, std::shared_ptr<Rule>> ruleMap;
@@ -246,6 +250,29 @@ public:
     void addReads(size_t tuplesRead) {
         this->tuplesRead += tuplesRead;
     }
+
+    size_t getNumStatisticsColumns() const {
+        return columnStatistics.size();
+    }
+
+    /** Obtain the estimated number of distinct values of the given column, 0 if unknown */
+    size_t getColumnDistinct(size_t column) const {
+        return (column < columnStatistics.size()) ? columnStatistics[column].first : 0;
+    }
+
+    /** Obtain the estimated frequency of the most common value of the given column, 0 if unknown */
+    size_t getColumnMaxFrequency(size_t column) const {
+        return (column < columnStatistics.size()) ? columnStatistics[column].second : 0;
+    }
+
+    void setColumnStatistics(size_t column, size_t distinct, size_t maxFrequency) {
+        if (columnStatistics.size() <= column) {
+            columnStatistics.resize(column + 1, std::make_pair(0, 0));
+        }
+        // keep the largest statistics of relations recomputed in multiple strata
+        columnStatistics[column].first = std::max(columnStatistics[column].first, distinct);
+        columnStatistics[column].second = std::max(columnStatistics[column].second, maxFrequency);
+    }
 };
 
 }  // namespace profile
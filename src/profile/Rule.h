@@ -57,6 +57,7 @@ protected:
 private:
     bool recursive = false;
     int version = 0;
+    long variant = -1;
 
 public:
     Rule(std::string name, std::string id) : name(std::move(name)), identifier(std::move(id)) {}
@@ -135,6 +136,15 @@ public:
         this->version = version;
     }
 
+    /** The query variant chosen for an adaptive rule version, or -1 if the join order is static */
+    long getVariant() const {
+        return variant;
+    }
+
+    void setVariant(long variant) {
+        this->variant = variant;
+    }
+
     std::string toString() const {
         std::ostringstream output;
         if (recursive) {
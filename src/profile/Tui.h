@@ -18,6 +18,7 @@
 #include <chrono>
 #include <cstdio>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <string>
 #include <thread>
@@ -77,6 +78,8 @@ public:
         this->alive = false;
         updateDB();
         this->loaded = reader->isLoaded();
+        // the log of a running program is updated by each command
+        this->alive = reader->isLive();
     }
 
     Tui() {
@@ -191,6 +194,8 @@ public:
             }
         } else if (c[0].compare("configuration") == 0) {
             configuration();
+        } else if (c[0].compare("records") == 0) {
+            records();
         } else {
             std::cout << "Unknown command. Use \"help\" for a list of commands.\n";
         }
@@ -685,6 +690,7 @@ public:
         std::printf("  %-30s%-5s %s\n", "usage [relation id|rule id]", "-",
                 "display CPU usage graphs for a relation or rule.");
         std::printf("  %-30s%-5s %s\n", "memory", "-", "display memory usage.");
+        std::printf("  %-30s%-5s %s\n", "records", "-", "display size and hit rate of the record tables.");
         std::printf("  %-30s%-5s %s\n", "help", "-", "print this.");
 
         std::cout << "\nInteractive mode only commands:" << std::endl;
@@ -978,6 +984,7 @@ public:
         linereader.appendTabCompletion("limit ");
         linereader.appendTabCompletion("memory");
         linereader.appendTabCompletion("configuration");
+        linereader.appendTabCompletion("records");
 
         // add rel tab completes after the rest so users can see all commands first
         for (auto& row : Tools::formatTable(relationTable, precision)) {
@@ -1003,6 +1010,34 @@ public:
         std::cout << std::endl;
     }
 
+    void records() {
+        const auto& db = ProfileEventSingleton::instance().getDB();
+        std::cout << "Records" << '\n';
+        printf("%10s%15s%15s%12s\n\n", "Arity", "Records", "Packs", "Hit rate");
+        auto* arities = dynamic_cast<DirectoryEntry*>(db.lookupEntry({"program", "records"}));
+        if (arities != nullptr) {
+            std::map<size_t, std::string> keys;
+            for (const auto& key : arities->getKeys()) {
+                keys[std::stoul(key)] = key;
+            }
+            for (const auto& key : keys) {
+                auto lookup = [&](const std::string& stat) {
+                    return dynamic_cast<SizeEntry*>(db.lookupEntry({"program", "records", key.second, stat}));
+                };
+                auto* size = lookup("size");
+                auto* packs = lookup("packs");
+                if (size == nullptr || packs == nullptr) {
+                    continue;
+                }
+                // packs not creating a new record were hits
+                size_t hits = packs->getSize() > size->getSize() ? packs->getSize() - size->getSize() : 0;
+                double hitRate = packs->getSize() == 0 ? 0.0 : 100.0 * hits / packs->getSize();
+                printf("%10zu%15zu%15zu%11.1f%%\n", key.first, size->getSize(), packs->getSize(), hitRate);
+            }
+        }
+        std::cout << std::endl;
+    }
+
     void top() {
         const std::shared_ptr<ProgramRun>& run = out.getProgramRun();
         auto* totalRelationsEntry =
@@ -1222,6 +1257,34 @@ public:
             verAtoms(atom_table);
         }
 
+        // Print out how often each query variant of adaptive rule versions was chosen.
+        std::map<int, std::map<long, size_t>> variants;
+        for (auto& row : formattedRuleTable) {
+            if (row[6].compare(str) != 0) {
+                continue;
+            }
+            const Relation* rel = out.getProgramRun()->getRelation(row[7]);
+            if (rel == nullptr) {
+                continue;
+            }
+            for (auto& iter : rel->getIterations()) {
+                for (auto& rule : iter->getRules()) {
+                    if (rule.second->getId() == str && rule.second->getVariant() >= 0) {
+                        ++variants[rule.second->getVersion()][rule.second->getVariant()];
+                    }
+                }
+            }
+        }
+        if (!variants.empty()) {
+            std::cout << "\n  ----- Join Orders -----\n";
+            std::printf("%8s%8s%12s\n\n", "VER", "VARIANT", "ITERATIONS");
+            for (auto& version : variants) {
+                for (auto& variant : version.second) {
+                    std::printf("%8d%8ld%12zu\n", version.first, variant.first, variant.second);
+                }
+            }
+        }
+
         if (!versionTable.rows.empty()) {
             return;
         }
@@ -0,0 +1,183 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2019, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file binary_io_test.cpp
+ *
+ * Tests the binary columnar IO format.
+ *
+ ***********************************************************************/
+
+#include "test.h"
+
+#include "IODirectives.h"
+#include "IOSystem.h"
+#include "RamTypes.h"
+#include "SymbolTable.h"
+#include "Util.h"
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace souffle;
+
+namespace test {
+
+/** A relation storing its tuples in a vector */
+class TestRelation {
+public:
+    /** A reference to a tuple, as iterated over by WriteStream::writeAll */
+    struct TupleRef {
+        const RamDomain* data;
+    };
+
+    TestRelation(size_t arity) : arity(arity) {}
+
+    void insert(const RamDomain* tuple) {
+        tuples.emplace_back(tuple, tuple + arity);
+    }
+
+    std::vector<TupleRef>::const_iterator begin() const {
+        refs.clear();
+        for (const auto& tuple : tuples) {
+            refs.push_back({tuple.data()});
+        }
+        return refs.begin();
+    }
+
+    std::vector<TupleRef>::const_iterator end() const {
+        return refs.end();
+    }
+
+    size_t size() const {
+        return tuples.size();
+    }
+
+    size_t arity;
+    std::vector<std::vector<RamDomain>> tuples;
+
+private:
+    mutable std::vector<TupleRef> refs;
+};
+
+IODirectives getDirectives(const std::string& fileName, bool compress = false) {
+    std::map<std::string, std::string> directives = {{"IO", "binary"}, {"name", "test"}, {"filename", fileName}};
+    if (compress) {
+        directives["compress"] = "true";
+    }
+    return IODirectives(directives);
+}
+
+void write(const TestRelation& relation, const std::vector<bool>& symbolMask, const SymbolTable& symbolTable,
+        const IODirectives& ioDirectives) {
+    IOSystem::getInstance().getWriter(symbolMask, symbolTable, ioDirectives, false)->writeAll(relation);
+}
+
+TestRelation read(const std::vector<bool>& symbolMask, SymbolTable& symbolTable, const IODirectives& ioDirectives) {
+    TestRelation relation(symbolMask.size());
+    IOSystem::getInstance().getReader(symbolMask, symbolTable, ioDirectives, false)->readAll(relation);
+    return relation;
+}
+
+TEST(BinaryIO, RoundTrip) {
+#ifdef USE_LIBZ
+    std::vector<bool> compressed = {false, true};
+#else
+    std::vector<bool> compressed = {false};
+#endif
+    for (bool compress : compressed) {
+        std::vector<bool> symbolMask = {false, true, true};
+        SymbolTable writeSymbols;
+        // symbols not occurring in the relation are not written
+        writeSymbols.insert("unused");
+
+        TestRelation relation(3);
+        for (RamDomain i = 0; i < 1000; ++i) {
+            RamDomain tuple[3] = {i - 500, writeSymbols.lookup("a" + std::to_string(i % 13)),
+                    writeSymbols.lookup(std::to_string(i % 7))};
+            relation.insert(tuple);
+        }
+
+        std::string fileName = tempFile();
+        write(relation, symbolMask, writeSymbols, getDirectives(fileName, compress));
+
+        // symbols are mapped to the indices of the reading symbol table
+        SymbolTable readSymbols;
+        readSymbols.insert("other");
+        auto result = read(symbolMask, readSymbols, getDirectives(fileName));
+        std::remove(fileName.c_str());
+
+        EXPECT_EQ(relation.size(), result.size());
+        EXPECT_EQ(1 + 13 + 7, readSymbols.size());
+        for (size_t i = 0; i < relation.size() && i < result.size(); ++i) {
+            EXPECT_EQ(relation.tuples[i][0], result.tuples[i][0]);
+            EXPECT_EQ(writeSymbols.resolve(relation.tuples[i][1]), readSymbols.resolve(result.tuples[i][1]));
+            EXPECT_EQ(writeSymbols.resolve(relation.tuples[i][2]), readSymbols.resolve(result.tuples[i][2]));
+        }
+    }
+}
+
+TEST(BinaryIO, Nullary) {
+    std::vector<bool> symbolMask = {};
+    SymbolTable symbolTable;
+    TestRelation relation(0);
+    relation.insert(nullptr);
+
+    std::string fileName = tempFile();
+    write(relation, symbolMask, symbolTable, getDirectives(fileName));
+    auto result = read(symbolMask, symbolTable, getDirectives(fileName));
+    std::remove(fileName.c_str());
+
+    EXPECT_EQ(1, result.size());
+}
+
+TEST(BinaryIO, Mismatch) {
+    SymbolTable symbolTable;
+    TestRelation relation(2);
+    RamDomain tuple[2] = {1, 2};
+    relation.insert(tuple);
+
+    std::string fileName = tempFile();
+    write(relation, {false, false}, symbolTable, getDirectives(fileName));
+
+    // wrong arity
+    try {
+        read({false, false, false}, symbolTable, getDirectives(fileName));
+        EXPECT_TRUE(false);
+    } catch (std::invalid_argument& e) {
+        EXPECT_TRUE(std::string(e.what()).find("Arity") != std::string::npos);
+    }
+
+    // wrong column types
+    try {
+        read({false, true}, symbolTable, getDirectives(fileName));
+        EXPECT_TRUE(false);
+    } catch (std::invalid_argument& e) {
+        EXPECT_TRUE(std::string(e.what()).find("Column types") != std::string::npos);
+    }
+
+    // not a binary file
+    {
+        std::ofstream out(fileName);
+        out << "1\t2\n";
+    }
+    try {
+        read({false, false}, symbolTable, getDirectives(fileName));
+        EXPECT_TRUE(false);
+    } catch (std::invalid_argument& e) {
+        EXPECT_TRUE(std::string(e.what()).find("Cannot parse") != std::string::npos);
+    }
+    std::remove(fileName.c_str());
+}
+
+}  // namespace test
@@ -476,6 +476,119 @@ TEST(BTreeSet, Load) {
     }
 }
 
+TEST(BTreeSet, LoadLarge) {
+    using test_set = btree_set<int, detail::comparator<int>, std::allocator<int>, 16>;
+
+    // cover trees of several levels with partially filled nodes
+    for (int N : {1000, 1023, 1024, 1025, 5000, 20000}) {
+        std::vector<int> data;
+        for (int i = 0; i < N; i++) {
+            data.push_back(i);
+        }
+
+        auto t = test_set::load(data.begin(), data.end());
+        EXPECT_EQ(data.size(), t.size());
+        EXPECT_TRUE(t.check());
+        EXPECT_TRUE(std::equal(data.begin(), data.end(), t.begin()));
+
+        // the loaded tree can be extended
+        for (int i = -10; i < N + 10; i++) {
+            t.insert(i);
+        }
+        EXPECT_EQ(N + 20, t.size());
+        EXPECT_TRUE(t.check());
+    }
+}
+
+TEST(BTreeSet, InsertSorted) {
+    using test_set = btree_set<int, detail::comparator<int>, std::allocator<int>, 16>;
+
+    for (int N : {0, 1, 10, 100, 1000}) {
+        for (int M : {0, 1, 10, 100, 1000}) {
+            test_set t;
+            std::set<int> should;
+            for (int i = 0; i < N; i++) {
+                t.insert(2 * i);
+                should.insert(2 * i);
+            }
+
+            // every third element is already present
+            std::vector<int> data;
+            for (int i = 0; i < M; i++) {
+                data.push_back(3 * i);
+                should.insert(3 * i);
+            }
+
+            t.insertSorted(data.begin(), data.end());
+            EXPECT_EQ(should.size(), t.size());
+            EXPECT_TRUE(t.check());
+            EXPECT_TRUE(std::equal(should.begin(), should.end(), t.begin()));
+        }
+    }
+}
+
+TEST(BTreeSet, InsertAllMerge) {
+    using test_set = btree_set<int, detail::comparator<int>, std::allocator<int>, 16>;
+    using test_multiset = btree_multiset<int, detail::comparator<int>, std::allocator<int>, 16>;
+
+    // merge comparably sized trees with overlapping elements
+    test_set a;
+    test_set b;
+    test_multiset ma;
+    test_multiset mb;
+    for (int i = 0; i < 5000; i++) {
+        a.insert(2 * i);
+        b.insert(3 * i);
+        ma.insert(2 * i);
+        mb.insert(3 * i);
+    }
+
+    a.insertAll(b);
+    std::set<int> should;
+    for (int i = 0; i < 5000; i++) {
+        should.insert(2 * i);
+        should.insert(3 * i);
+    }
+    EXPECT_EQ(should.size(), a.size());
+    EXPECT_TRUE(a.check());
+    EXPECT_TRUE(std::equal(should.begin(), should.end(), a.begin()));
+
+    // multisets retain duplicates
+    ma.insertAll(mb);
+    EXPECT_EQ(10000, ma.size());
+    EXPECT_TRUE(ma.check());
+    EXPECT_TRUE(std::is_sorted(ma.begin(), ma.end()));
+    EXPECT_EQ(2, std::count(ma.begin(), ma.end(), 6));
+
+    // the merged tree remains usable
+    a.insert(-1);
+    EXPECT_TRUE(a.contains(-1));
+    EXPECT_TRUE(a.check());
+}
+
+TEST(BTreeSet, HasMoreThan) {
+    using test_set = btree_set<int, detail::comparator<int>, std::allocator<int>, 16>;
+
+    test_set t;
+    EXPECT_FALSE(t.hasMoreThan(0));
+
+    for (int i = 0; i < 1000; i++) {
+        t.insert(i);
+    }
+    EXPECT_TRUE(t.hasMoreThan(0));
+    EXPECT_TRUE(t.hasMoreThan(999));
+    EXPECT_FALSE(t.hasMoreThan(1000));
+    EXPECT_FALSE(t.hasMoreThan(5000));
+
+    // merging a small sorted range into a large tree inserts its elements
+    std::vector<int> few = {-2, -1, 2000};
+    t.insertSorted(few.begin(), few.end());
+    EXPECT_EQ(1003, t.size());
+    EXPECT_TRUE(t.check());
+    EXPECT_TRUE(t.contains(-2));
+    EXPECT_TRUE(t.contains(2000));
+}
+
 TEST(BTreeSet, Clear) {
     using test_set = btree_set<int, detail::comparator<int>, std::allocator<int>, 16>;
 
@@ -712,6 +825,30 @@ TEST(Performance, Load) {
     time("bulk-load", [&]() { auto t = btree_set<int>::load(data.begin(), data.end()); });
 }
 
+TEST(Performance, Merge) {
+    int N = 1 << 20;
+
+    // two sets of the same size, as merged by a semi-naive evaluation
+    btree_set<int> a;
+    btree_set<int> b;
+    for (int i = 0; i < N; i++) {
+        a.insert(2 * i);
+        b.insert(2 * i + 1);
+    }
+
+    // take time for hinted insertion
+    time("hinted merge", [&]() {
+        btree_set<int> t = a;
+        t.insert(b.begin(), b.end());
+    });
+
+    // take time for merging and rebuilding the tree
+    time("bulk merge", [&]() {
+        btree_set<int> t = a;
+        t.insertAll(b);
+    });
+}
+
 TEST(BTreeSet, Parallel) {
     //        const int N = 600000000;
     //        const int N = 100000;
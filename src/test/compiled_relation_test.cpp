@@ -15,6 +15,9 @@
  ***********************************************************************/
 
 #include "CompiledRelation.h"
+#include "SynthesiserRelation.h"
+#include "Table.h"
+#include "TupleArena.h"
 #include "test.h"
 
 namespace souffle {
@@ -871,5 +874,157 @@ TEST(Relation, PartitionBug_InsertAll) {
     EXPECT_EQ(all, is);
 }
 
+TEST(TupleArena, Basic) {
+    using tuple_type = Tuple<RamDomain, 3>;
+    TupleArena<tuple_type, 4> arena;
+    EXPECT_EQ(0, arena.getNumBlocks());
+
+    // the addresses of the elements remain stable across blocks
+    std::vector<const tuple_type*> copies;
+    for (RamDomain i = 0; i < 10; i++) {
+        copies.push_back(&arena.insert(tuple_type({{i, i + 1, i + 2}})));
+    }
+    EXPECT_EQ(3, arena.getNumBlocks());
+    for (RamDomain i = 0; i < 10; i++) {
+        EXPECT_EQ(tuple_type({{i, i + 1, i + 2}}), *copies[i]);
+    }
+
+    // a released element is reused by the next insertion
+    const tuple_type* last = &arena.insert(tuple_type({{10, 11, 12}}));
+    arena.release(*last);
+    EXPECT_EQ(last, &arena.insert(tuple_type({{20, 21, 22}})));
+    EXPECT_EQ(tuple_type({{20, 21, 22}}), *last);
+
+    arena.clear();
+    EXPECT_EQ(0, arena.getNumBlocks());
+    EXPECT_EQ(0, arena.getMemoryUsage());
+}
+
+/**
+ * The tuple store of an indirect relation of arity 8, as synthesized for wide relations with
+ * several indexes, together with its master index.
+ */
+template <typename Store>
+struct IndirectRelation {
+    using tuple_type = Tuple<RamDomain, 8>;
+    using index_type = btree_set<const tuple_type*,
+            index_utils::deref_compare<typename index_utils::comparator<0, 1, 2, 3, 4, 5, 6, 7>>>;
+
+    Store data;
+    index_type index;
+};
+
+/** Inserts into an indirect relation storing its tuples in an arena, without locking */
+bool insert(IndirectRelation<TupleArena<Tuple<RamDomain, 8>>>& rel, const Tuple<RamDomain, 8>& t) {
+    if (rel.index.contains(&t)) {
+        return false;
+    }
+    const auto* copy = &rel.data.insert(t);
+    if (!rel.index.insert(copy)) {
+        rel.data.release(*copy);
+        return false;
+    }
+    return true;
+}
+
+/** Inserts into an indirect relation storing its tuples in a table, under a lock */
+bool insert(IndirectRelation<Table<Tuple<RamDomain, 8>>>& rel, const Tuple<RamDomain, 8>& t, Lock& lock) {
+    auto lease = lock.acquire();
+    if (rel.index.contains(&t)) {
+        return false;
+    }
+    rel.index.insert(&rel.data.insert(t));
+    return true;
+}
+
+/** Creates the i-th tuple of the insertion benchmark, repeating each tuple twice */
+Tuple<RamDomain, 8> getTuple(int i) {
+    RamDomain k = i / 2;
+    return Tuple<RamDomain, 8>({{k % 7, k, k * 3, k % 11, -k, k / 5, k % 13, k + 1}});
+}
+
+TEST(TupleArena, ParallelInsert) {
+    const int N = 100000;
+    IndirectRelation<TupleArena<Tuple<RamDomain, 8>>> rel;
+
+    std::atomic<int> inserted(0);
+#pragma omp parallel for
+    for (int i = 0; i < N; i++) {
+        if (insert(rel, getTuple(i))) {
+            inserted++;
+        }
+    }
+
+    // each tuple is inserted once and retained at a stable address
+    EXPECT_EQ(N / 2, inserted.load());
+    EXPECT_EQ(N / 2, rel.index.size());
+    for (int i = 0; i < N; i += 2) {
+        const auto cur = getTuple(i);
+        EXPECT_TRUE(rel.index.contains(&cur));
+    }
+    for (const auto* cur : rel.index) {
+        EXPECT_TRUE(rel.index.contains(cur));
+    }
+}
+
+TEST(TupleArena, Performance) {
+    // whether to print the recorded times and memory to stdout
+    // should be false unless developing
+    const bool ECHO_TIME = false;
+
+    const int N = 1000000;
+
+    // the previous layout, serializing insertions by a lock
+    IndirectRelation<Table<Tuple<RamDomain, 8>>> locked;
+    Lock lock;
+    time_point start = now();
+#pragma omp parallel for
+    for (int i = 0; i < N; i++) {
+        insert(locked, getTuple(i), lock);
+    }
+    time_point end = now();
+    long lockedTime = duration_in_us(start, end);
+
+    // the arena, inserting concurrently
+    IndirectRelation<TupleArena<Tuple<RamDomain, 8>>> arena;
+    start = now();
+#pragma omp parallel for
+    for (int i = 0; i < N; i++) {
+        insert(arena, getTuple(i));
+    }
+    end = now();
+    long arenaTime = duration_in_us(start, end);
+
+    EXPECT_EQ(locked.index.size(), arena.index.size());
+
+    // the arena only exceeds the memory of the retained tuples by its partially filled blocks
+    const std::size_t tupleBytes = arena.index.size() * sizeof(Tuple<RamDomain, 8>);
+    const std::size_t blockBytes = 1024 * sizeof(Tuple<RamDomain, 8>);
+    EXPECT_LT(tupleBytes, arena.data.getMemoryUsage());
+    EXPECT_LT(arena.data.getMemoryUsage(), tupleBytes + 2 * MAX_THREADS * blockBytes);
+
+    if (ECHO_TIME) {
+        std::cout << "threads: " << MAX_THREADS << ", tuples: " << arena.index.size() << "\n";
+        std::cout << "locked table: " << lockedTime << "us, arena: " << arenaTime << "us\n";
+        std::cout << "arena memory: " << arena.data.getMemoryUsage() << " bytes in "
+                  << arena.data.getNumBlocks() << " blocks\n";
+    }
+}
+
+TEST(Relation, IndirectLayout) {
+    // narrow relations or few indexes store their tuples directly
+    EXPECT_FALSE(SynthesiserRelation::isIndirectLayout(2, 4, 0));
+    EXPECT_FALSE(SynthesiserRelation::isIndirectLayout(8, 1, 0));
+    EXPECT_FALSE(SynthesiserRelation::isIndirectLayout(12, 1, 0));
+
+    // wide relations with several indexes store their tuples once
+    EXPECT_TRUE(SynthesiserRelation::isIndirectLayout(8, 3, 0));
+    EXPECT_TRUE(SynthesiserRelation::isIndirectLayout(12, 2, 0));
+    EXPECT_TRUE(SynthesiserRelation::isIndirectLayout(8, 3, 1000000));
+
+    // unless they are known to be small
+    EXPECT_FALSE(SynthesiserRelation::isIndirectLayout(8, 3, 100));
+}
+
 }  // namespace ram
 }  // end namespace souffle
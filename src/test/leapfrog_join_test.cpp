@@ -0,0 +1,270 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2019, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file leapfrog_join_test.cpp
+ *
+ * Tests the leapfrog joins over b-tree indexes, evaluating rules with
+ * cyclic bodies such as triangle and clique queries.
+ *
+ ***********************************************************************/
+
+#include "test.h"
+
+#include "BTree.h"
+#include "CompiledTuple.h"
+#include "LeapfrogJoin.h"
+#include "Util.h"
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace souffle {
+
+namespace test {
+
+using Edge = ram::Tuple<RamDomain, 2>;
+using Graph = btree_set<Edge>;
+
+/** The lower bound operation of a graph */
+struct LowerBound {
+    const Graph* graph;
+
+    Graph::iterator operator()(const Edge& key) const {
+        return graph->lower_bound(key);
+    }
+};
+
+using Cursor = BTreeLeapfrogCursor<Graph::iterator, Edge, LowerBound>;
+
+/** Creates a cursor over the source nodes of the edges of a graph */
+Cursor sources(const Graph& graph) {
+    const Edge low = {{MIN_RAM_DOMAIN, MIN_RAM_DOMAIN}};
+    return makeLeapfrogCursor(graph.begin(), graph.end(), low, 0, LowerBound{&graph});
+}
+
+/** Creates a cursor over the successors of a node of a graph */
+Cursor successors(const Graph& graph, RamDomain node) {
+    const Edge low = {{node, MIN_RAM_DOMAIN}};
+    const Edge high = {{node, MAX_RAM_DOMAIN}};
+    return makeLeapfrogCursor(
+            graph.lower_bound(low), graph.upper_bound(high), low, 1, LowerBound{&graph});
+}
+
+/** Collects the values enumerated by a leapfrog join */
+std::vector<RamDomain> collect(LeapfrogJoin join) {
+    std::vector<RamDomain> res;
+    for (; !join.atEnd(); join.next()) {
+        res.push_back(join.getValue());
+    }
+    return res;
+}
+
+/** Creates a graph of the given edges */
+Graph toGraph(const std::vector<std::pair<RamDomain, RamDomain>>& edges) {
+    Graph graph;
+    for (const auto& cur : edges) {
+        graph.insert(Edge({{cur.first, cur.second}}));
+    }
+    return graph;
+}
+
+TEST(LeapfrogJoin, Intersection) {
+    Graph graph = toGraph({{0, 1}, {0, 3}, {0, 4}, {0, 8}, {0, 9}, {1, 2}, {1, 3}, {1, 8}, {1, 9}, {2, 0},
+            {2, 3}, {2, 7}, {2, 9}});
+
+    Cursor a = successors(graph, 0);
+    Cursor b = successors(graph, 1);
+    Cursor c = successors(graph, 2);
+    EXPECT_EQ(std::vector<RamDomain>({3, 9}), collect({&a, &b, &c}));
+
+    // a single cursor enumerates its distinct values
+    Cursor all = sources(graph);
+    EXPECT_EQ(std::vector<RamDomain>({0, 1, 2}), collect({&all}));
+
+    // intersections with themselves
+    Cursor d = successors(graph, 1);
+    Cursor e = successors(graph, 1);
+    EXPECT_EQ(std::vector<RamDomain>({2, 3, 8, 9}), collect({&d, &e}));
+}
+
+TEST(LeapfrogJoin, Empty) {
+    Graph graph = toGraph({{0, 1}, {0, 3}, {1, 2}, {1, 4}});
+
+    // disjoint ranges
+    Cursor a = successors(graph, 0);
+    Cursor b = successors(graph, 1);
+    EXPECT_TRUE(LeapfrogJoin({&a, &b}).atEnd());
+
+    // empty ranges
+    Cursor c = successors(graph, 0);
+    Cursor d = successors(graph, 5);
+    EXPECT_TRUE(LeapfrogJoin({&c, &d}).atEnd());
+
+    // no cursors
+    EXPECT_TRUE(LeapfrogJoin(std::vector<LeapfrogCursor*>()).atEnd());
+}
+
+TEST(LeapfrogJoin, Bounds) {
+    Graph graph = toGraph({{0, MIN_RAM_DOMAIN}, {0, 0}, {0, MAX_RAM_DOMAIN}, {1, MIN_RAM_DOMAIN},
+            {1, MAX_RAM_DOMAIN}});
+
+    Cursor a = successors(graph, 0);
+    Cursor b = successors(graph, 1);
+    EXPECT_EQ(std::vector<RamDomain>({MIN_RAM_DOMAIN, MAX_RAM_DOMAIN}), collect({&a, &b}));
+}
+
+/**
+ * Counts the triangles of a graph, i.e., the results of t(x,y,z) :- e(x,y), e(y,z), e(x,z),
+ * by a leapfrog triejoin over the variable order x, y, z.
+ */
+std::size_t countTrianglesLeapfrog(const Graph& graph) {
+    std::size_t count = 0;
+    Cursor x1 = sources(graph);
+    Cursor x2 = sources(graph);
+    for (LeapfrogJoin x({&x1, &x2}); !x.atEnd(); x.next()) {
+        Cursor y1 = successors(graph, x.getValue());
+        Cursor y2 = sources(graph);
+        for (LeapfrogJoin y({&y1, &y2}); !y.atEnd(); y.next()) {
+            Cursor z1 = successors(graph, y.getValue());
+            Cursor z2 = successors(graph, x.getValue());
+            for (LeapfrogJoin z({&z1, &z2}); !z.atEnd(); z.next()) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+/** Counts the triangles of a graph by nested index lookups in the order of the atoms */
+std::size_t countTrianglesNested(const Graph& graph) {
+    std::size_t count = 0;
+    for (const Edge& xy : graph) {
+        auto end = graph.upper_bound(Edge({{xy[1], MAX_RAM_DOMAIN}}));
+        for (auto it = graph.lower_bound(Edge({{xy[1], MIN_RAM_DOMAIN}})); it != end; ++it) {
+            if (graph.contains(Edge({{xy[0], (*it)[1]}}))) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+/**
+ * Counts the 4-cliques of a graph, i.e., the results of
+ * c(w,x,y,z) :- e(w,x), e(w,y), e(w,z), e(x,y), e(x,z), e(y,z).
+ */
+std::size_t countCliquesLeapfrog(const Graph& graph) {
+    std::size_t count = 0;
+    Cursor w1 = sources(graph);
+    for (LeapfrogJoin w({&w1}); !w.atEnd(); w.next()) {
+        Cursor x1 = successors(graph, w.getValue());
+        Cursor x2 = sources(graph);
+        for (LeapfrogJoin x({&x1, &x2}); !x.atEnd(); x.next()) {
+            Cursor y1 = successors(graph, w.getValue());
+            Cursor y2 = successors(graph, x.getValue());
+            Cursor y3 = sources(graph);
+            for (LeapfrogJoin y({&y1, &y2, &y3}); !y.atEnd(); y.next()) {
+                Cursor z1 = successors(graph, w.getValue());
+                Cursor z2 = successors(graph, x.getValue());
+                Cursor z3 = successors(graph, y.getValue());
+                for (LeapfrogJoin z({&z1, &z2, &z3}); !z.atEnd(); z.next()) {
+                    count++;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+/** Counts the 4-cliques of a graph by nested loops */
+std::size_t countCliquesNested(const Graph& graph) {
+    std::size_t count = 0;
+    for (const Edge& wx : graph) {
+        for (const Edge& xy : graph) {
+            if (xy[0] != wx[1] || !graph.contains(Edge({{wx[0], xy[1]}}))) {
+                continue;
+            }
+            for (const Edge& yz : graph) {
+                if (yz[0] == xy[1] && graph.contains(Edge({{wx[0], yz[1]}})) &&
+                        graph.contains(Edge({{wx[1], yz[1]}}))) {
+                    count++;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+/** Creates a random graph of the given number of nodes and edges */
+Graph randomGraph(RamDomain nodes, std::size_t edges) {
+    std::mt19937 random(0);
+    std::uniform_int_distribution<RamDomain> node(0, nodes - 1);
+    Graph graph;
+    while (graph.size() < edges) {
+        graph.insert(Edge({{node(random), node(random)}}));
+    }
+    return graph;
+}
+
+TEST(LeapfrogJoin, Triangles) {
+    // the complete graph of 10 nodes including self-loops
+    Graph complete;
+    for (RamDomain i = 0; i < 10; i++) {
+        for (RamDomain j = 0; j < 10; j++) {
+            complete.insert(Edge({{i, j}}));
+        }
+    }
+    EXPECT_EQ(1000, countTrianglesLeapfrog(complete));
+    EXPECT_EQ(10000, countCliquesLeapfrog(complete));
+
+    Graph graph = randomGraph(100, 2000);
+    EXPECT_EQ(countTrianglesNested(graph), countTrianglesLeapfrog(graph));
+    EXPECT_EQ(countCliquesNested(graph), countCliquesLeapfrog(graph));
+}
+
+TEST(LeapfrogJoin, Performance) {
+    // whether to print the recorded times to stdout
+    // should be false unless developing
+    const bool ECHO_TIME = false;
+
+    // a node connected in both directions to all other nodes, producing a quadratic number of
+    // intermediate results for the join of the first two atoms of the triangle query
+    const RamDomain N = 2000;
+    Graph star;
+    for (RamDomain i = 1; i <= N; i++) {
+        star.insert(Edge({{0, i}}));
+        star.insert(Edge({{i, 0}}));
+    }
+
+    // and a random graph
+    Graph graph = randomGraph(1000, 50000);
+
+    for (const Graph* cur : {&star, &graph}) {
+        time_point start = now();
+        std::size_t nested = countTrianglesNested(*cur);
+        time_point end = now();
+        long nestedTime = duration_in_us(start, end);
+
+        start = now();
+        std::size_t leapfrog = countTrianglesLeapfrog(*cur);
+        end = now();
+        long leapfrogTime = duration_in_us(start, end);
+
+        EXPECT_EQ(nested, leapfrog);
+        if (ECHO_TIME) {
+            std::cout << "triangles: " << leapfrog << ", nested loops: " << nestedTime
+                      << "us, leapfrog: " << leapfrogTime << "us" << std::endl;
+        }
+    }
+}
+
+}  // end namespace test
+}  // end namespace souffle
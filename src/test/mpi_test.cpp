@@ -14,9 +14,15 @@
  *
  ***********************************************************************/
 
+#include <array>
+#include <iostream>
+#include <set>
+#include <string>
 #include <vector>
 
 #include "Mpi.h"
+#include "SymbolTable.h"
+#include "Util.h"
 #include "test.h"
 
 namespace souffle {
@@ -31,5 +37,192 @@ TEST(mpi, mpi) {
         EXPECT_EQ(mpi::commSize(), 1);
     }
 }
+
+/** A minimal relation of binary tuples offering the interface of synthesized relations */
+class Relation {
+    std::set<std::array<int, 2>> tuples;
+
+public:
+    std::set<std::array<int, 2>>::const_iterator begin() const {
+        return tuples.begin();
+    }
+    std::set<std::array<int, 2>>::const_iterator end() const {
+        return tuples.end();
+    }
+    bool insert(const int* tuple) {
+        std::array<int, 2> t = {{tuple[0], tuple[1]}};
+        return tuples.insert(t).second;
+    }
+    bool contains(const std::array<int, 2>& tuple) const {
+        return tuples.count(tuple) > 0;
+    }
+    std::size_t size() const {
+        return tuples.size();
+    }
+    bool empty() const {
+        return tuples.empty();
+    }
+    void purge() {
+        tuples.clear();
+    }
+};
+
+TEST(mpi, partition) {
+    const int size = mpi::commSize();
+
+    Relation rel;
+    for (int i = 0; i < 1000; ++i) {
+        int tuple[] = {i, i % 7};
+        rel.insert(tuple);
+    }
+    Relation all = rel;
+
+    // only owned tuples are retained, and the shares of all processes cover the relation
+    mpi::partition<int>(rel, 2);
+    for (const auto& tuple : rel) {
+        EXPECT_EQ(mpi::commRank(), mpi::owner(tuple, 2, size));
+    }
+    mpi::allGather<int>(rel, 2);
+    EXPECT_EQ(all.size(), rel.size());
+}
+
+TEST(mpi, broadcast) {
+    Relation rel;
+    std::vector<std::string> symbols;
+    if (mpi::commRank() == 0) {
+        int tuple[] = {1, 2};
+        rel.insert(tuple);
+        symbols = {"a", "", "bc"};
+    }
+    mpi::broadcast<int>(rel, 2, 0);
+    mpi::broadcast(symbols, 0);
+    std::array<int, 2> tuple = {{1, 2}};
+    EXPECT_EQ(1, rel.size());
+    EXPECT_TRUE(rel.contains(tuple));
+    EXPECT_EQ(std::vector<std::string>({"a", "", "bc"}), symbols);
+    EXPECT_EQ(0, mpi::allMin(mpi::commRank()));
+}
+
+TEST(mpi, DataParallelClosure) {
+    // edges of a cycle with chords, its transitive closure is the complete graph
+    const int N = 50;
+    Relation edge;
+    for (int i = 0; i < N; ++i) {
+        int cycle[] = {i, (i + 1) % N};
+        int chord[] = {i, (i * 7) % N};
+        edge.insert(cycle);
+        edge.insert(chord);
+    }
+
+    // semi-naive evaluation of path(x,z) :- path(x,y), edge(y,z) on the shares of the delta
+    Relation path = edge;
+    Relation delta = path;
+    mpi::partition<int>(delta, 2);
+    int iterations = 0;
+    while (true) {
+        Relation fresh;
+        for (const auto& t : delta) {
+            for (const auto& e : edge) {
+                std::array<int, 2> tuple = {{t[0], e[1]}};
+                if (t[1] == e[0] && !path.contains(tuple)) {
+                    fresh.insert(tuple.data());
+                }
+            }
+        }
+        mpi::allGather<int>(fresh, 2);
+        if (fresh.empty()) {
+            break;
+        }
+        for (const auto& t : fresh) {
+            path.insert(t.data());
+        }
+        delta = fresh;
+        mpi::partition<int>(delta, 2);
+        ++iterations;
+    }
+
+    // all processes agree on the complete result
+    EXPECT_EQ(N * N, path.size());
+    EXPECT_EQ(iterations, mpi::allMin(iterations));
+}
+TEST(mpi, SymbolTable) {
+    // whether to print the recorded times to stdout
+    // should be false unless developing
+    const bool ECHO_TIME = false;
+
+    const int N = 100000;
+    const int rank = mpi::commRank();
+    const int size = mpi::commSize();
+
+    // constants of the program are known to all processes
+    SymbolTable table({"a", "b"});
+
+    if (rank == 0) {
+        // the master loads the input relations and serves the other processes
+        std::vector<std::string> input;
+        for (int i = 0; i < N; ++i) {
+            input.push_back("input" + std::to_string(i));
+        }
+        table.insert(input);
+        table.handleMpiMessages(size - 1);
+
+        // all symbols created by the other processes have been added
+        EXPECT_EQ(std::size_t(2 + N + (size - 1) * (N / 5)), table.size());
+        return;
+    }
+
+    // resolving input symbols, the first of them obtains all symbols of the master
+    time_point start = now();
+    int mismatches = 0;
+    for (int i = 0; i < N; ++i) {
+        mismatches += table.resolve(i + 2) != "input" + std::to_string(i);
+    }
+    long resolveTime = duration_in_ns(start, now());
+
+    // looking up known symbols is local
+    start = now();
+    for (int i = 0; i < N; ++i) {
+        mismatches += table.lookup("input" + std::to_string(i)) != i + 2;
+    }
+    long lookupTime = duration_in_ns(start, now());
+
+    // creating symbols requires a round-trip each
+    start = now();
+    for (int i = 0; i < N / 10; ++i) {
+        const std::string symbol = std::to_string(rank) + "new" + std::to_string(i);
+        mismatches += table.resolve(table.lookup(symbol)) != symbol;
+    }
+    long createTime = duration_in_ns(start, now());
+
+    // creating a batch of symbols, as loaders do, requires a single round-trip
+    start = now();
+    std::vector<std::string> batch;
+    for (int i = 0; i < N / 10; ++i) {
+        batch.push_back(std::to_string(rank) + "batch" + std::to_string(i));
+    }
+    batch.push_back("input0");
+    std::vector<RamDomain> indices = table.lookup(batch);
+    for (int i = 0; i < N / 10; ++i) {
+        mismatches += table.resolve(indices[i]) != batch[i];
+    }
+    mismatches += indices.back() != 2;
+    long batchTime = duration_in_ns(start, now());
+
+    EXPECT_EQ(0, mismatches);
+    EXPECT_EQ(0, table.lookup("a"));
+    EXPECT_TRUE(table.contains("input0"));
+    EXPECT_FALSE(table.contains("missing"));
+
+    if (ECHO_TIME) {
+        std::cout << "rank " << rank << " - resolve: " << (N * 1000.0) / resolveTime
+                  << " M ops/s, lookup: " << (N * 1000.0) / lookupTime
+                  << " M ops/s, create: " << (N / 10 * 1000.0) / createTime
+                  << " M ops/s, batch: " << (N / 10 * 1000.0) / batchTime << " M ops/s" << std::endl;
+    }
+
+    mpi::send(0, SymbolTable::exitTag());
+    mpi::recv(0, SymbolTable::exitTag());
+}
+
 }  // namespace test
 }  // namespace souffle
@@ -0,0 +1,196 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2019, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file profile_log_test.cpp
+ *
+ * Tests the streaming binary log of profile events.
+ *
+ ***********************************************************************/
+
+#include "test.h"
+
+#include "ProfileDatabase.h"
+#include "ProfileLog.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+using namespace souffle;
+using namespace souffle::profile;
+
+namespace test {
+
+namespace {
+
+std::string tempLog() {
+    return "/tmp/profile_log_test_" + std::to_string(getpid()) + ".log";
+}
+
+/** Copies the first bytes of a file, mimicking a log whose writer is still appending */
+void truncateCopy(const std::string& from, const std::string& to, std::streamoff size) {
+    std::ifstream in(from, std::ios::binary);
+    std::string bytes(size, '\0');
+    in.read(&bytes[0], size);
+    std::ofstream(to, std::ios::binary | std::ios::trunc).write(bytes.data(), size);
+}
+
+}  // namespace
+
+TEST(ProfileLog, RoundTrip) {
+    const std::string filename = tempLog();
+    {
+        ProfileLogWriter log(filename);
+        EXPECT_TRUE(log.isOpen());
+        log.log(LogEventKind::Config, "@config", {"threads", "4"}, {});
+        log.log(LogEventKind::Text, "@text;stratum;0;relation;A;name", {"A"}, {});
+        log.log(LogEventKind::Time, "@time;starttime", {}, {1000});
+        log.log(LogEventKind::Timing, "@t-nonrecursive-relation;A;a.dl [1:1-1:10];", {},
+                {1000, 3000, 10, 20, 42, 0});
+        log.log(LogEventKind::Quantity, "@n-nonrecursive-relation;B;b.dl [2:1-2:10];", {}, {7, 0});
+        log.log(LogEventKind::Utilisation, "@utilisation", {}, {2000, 5, 6, 128});
+    }
+    EXPECT_TRUE(ProfileLogReader::isLog(filename));
+
+    ProfileDatabase db;
+    ProfileLogReader reader(filename);
+    reader.read(db);
+
+    auto* threads = dynamic_cast<TextEntry*>(db.lookupEntry({"program", "configuration", "threads"}));
+    EXPECT_TRUE(threads != nullptr && threads->getText() == "4");
+    auto* stratum = dynamic_cast<TextEntry*>(
+            db.lookupEntry({"program", "stratum", "0", "relation", "A", "name"}));
+    EXPECT_TRUE(stratum != nullptr && stratum->getText() == "A");
+    auto* start = dynamic_cast<TimeEntry*>(db.lookupEntry({"program", "starttime"}));
+    EXPECT_TRUE(start != nullptr && start->getTime().count() == 1000);
+    auto* runtime = dynamic_cast<DurationEntry*>(db.lookupEntry({"program", "relation", "A", "runtime"}));
+    EXPECT_TRUE(runtime != nullptr && runtime->getStart().count() == 1000);
+    EXPECT_TRUE(runtime != nullptr && runtime->getEnd().count() == 3000);
+    auto* size = dynamic_cast<SizeEntry*>(db.lookupEntry({"program", "relation", "A", "num-tuples"}));
+    EXPECT_TRUE(size != nullptr && size->getSize() == 42);
+    auto* rss = dynamic_cast<SizeEntry*>(db.lookupEntry({"program", "relation", "A", "maxRSS", "post"}));
+    EXPECT_TRUE(rss != nullptr && rss->getSize() == 20);
+    auto* number = dynamic_cast<SizeEntry*>(db.lookupEntry({"program", "relation", "B", "num-tuples"}));
+    EXPECT_TRUE(number != nullptr && number->getSize() == 7);
+    auto* usertime = dynamic_cast<SizeEntry*>(
+            db.lookupEntry({"program", "usage", "timepoint", "2000", "usertime"}));
+    EXPECT_TRUE(usertime != nullptr && usertime->getSize() == 6);
+
+    std::remove(filename.c_str());
+}
+
+TEST(ProfileLog, Incremental) {
+    const std::string filename = tempLog();
+    const std::string partial = filename + ".partial";
+    {
+        // small blocks, such that the writer has to wait for the file
+        ProfileLogWriter log(filename, 64, 2);
+        for (int i = 0; i < 100; ++i) {
+            log.log(LogEventKind::Time, "@time;t" + std::to_string(i), {}, {i});
+        }
+    }
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    const std::streamoff size = file.tellg();
+
+    // a log cut within its last event
+    ProfileDatabase db;
+    truncateCopy(filename, partial, size - 3);
+    ProfileLogReader reader(partial);
+    reader.read(db);
+    EXPECT_TRUE(db.lookupEntry({"program", "t98"}) != nullptr);
+    EXPECT_TRUE(db.lookupEntry({"program", "t99"}) == nullptr);
+
+    // the remainder of the event once it has been written
+    truncateCopy(filename, partial, size);
+    reader.read(db);
+    auto* last = dynamic_cast<TimeEntry*>(db.lookupEntry({"program", "t99"}));
+    EXPECT_TRUE(last != nullptr && last->getTime().count() == 99);
+
+    EXPECT_FALSE(ProfileLogReader::isLog(__FILE__));
+
+    std::remove(filename.c_str());
+    std::remove(partial.c_str());
+}
+
+TEST(ProfileLog, Corrupt) {
+    const std::string filename = tempLog();
+    const std::string other = filename + ".other";
+    {
+        ProfileLogWriter log(filename);
+        log.log(LogEventKind::Time, "@time;starttime", {}, {1000});
+    }
+    {
+        ProfileLogWriter log(other);
+        log.log(LogEventKind::Time, "@time;endtime", {}, {2000});
+    }
+    {
+        // an event of an unknown kind, followed by a valid event
+        std::ofstream file(filename, std::ios::binary | std::ios::app);
+        const char unknown[] = {42, 0, 0, 0, 0};
+        file.write(unknown, sizeof(unknown));
+        std::ifstream in(other, std::ios::binary);
+        in.seekg(getLogMagic().size());
+        file << in.rdbuf();
+    }
+
+    ProfileDatabase db;
+    ProfileLogReader reader(filename);
+    reader.read(db);
+    EXPECT_TRUE(db.lookupEntry({"program", "starttime"}) != nullptr);
+    EXPECT_TRUE(db.lookupEntry({"program", "endtime"}) == nullptr);
+
+    std::remove(filename.c_str());
+    std::remove(other.c_str());
+}
+
+TEST(ProfileLog, Closed) {
+    const std::string filename = tempLog();
+    ProfileLogWriter log(filename, 64, 2);
+    log.log(LogEventKind::Time, "@time;starttime", {}, {1000});
+    log.close();
+
+    // events after closing neither block nor reach the file
+    for (int i = 0; i < 100; ++i) {
+        log.log(LogEventKind::Time, "@time;t" + std::to_string(i), {}, {i});
+    }
+    ProfileDatabase db;
+    ProfileLogReader reader(filename);
+    reader.read(db);
+    EXPECT_TRUE(db.lookupEntry({"program", "starttime"}) != nullptr);
+    EXPECT_TRUE(db.lookupEntry({"program", "t0"}) == nullptr);
+
+    std::remove(filename.c_str());
+}
+
+TEST(ProfileLog, Concurrent) {
+    const std::string filename = tempLog();
+    {
+        ProfileLogWriter log(filename, 256, 2);
+#pragma omp parallel for
+        for (int i = 0; i < 1000; ++i) {
+            log.log(LogEventKind::Quantity, "@n-nonrecursive-relation;R" + std::to_string(i) + ";r.dl;", {},
+                    {i, 0});
+        }
+    }
+    ProfileDatabase db;
+    ProfileLogReader reader(filename);
+    reader.read(db);
+    for (int i = 0; i < 1000; ++i) {
+        auto* size = dynamic_cast<SizeEntry*>(
+                db.lookupEntry({"program", "relation", "R" + std::to_string(i), "num-tuples"}));
+        EXPECT_TRUE(size != nullptr && size->getSize() == size_t(i));
+    }
+    std::remove(filename.c_str());
+}
+
+}  // namespace test
@@ -0,0 +1,67 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2019, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ram_adaptive_query_test.cpp
+ *
+ * Tests the cost estimate choosing the variants of adaptive queries.
+ *
+ ***********************************************************************/
+
+#include "test.h"
+
+#include "RamStatement.h"
+
+#include <array>
+#include <vector>
+
+namespace souffle {
+
+namespace test {
+
+using Scans = std::vector<std::array<size_t, 3>>;
+
+TEST(AdaptiveQuery, SingleScan) {
+    EXPECT_EQ(0, RamAdaptiveQuery::estimateCost({}));
+
+    // a full scan enumerates every tuple, a scan binding all arguments at most one
+    EXPECT_EQ(100, RamAdaptiveQuery::estimateCost({{{100, 2, 0}}}));
+    EXPECT_EQ(1, RamAdaptiveQuery::estimateCost({{{100, 2, 2}}}));
+    EXPECT_EQ(10, RamAdaptiveQuery::estimateCost({{{100, 2, 1}}}));
+
+    // empty relations are taken to hold a tuple, nullary relations to be a test
+    EXPECT_EQ(1, RamAdaptiveQuery::estimateCost({{{0, 2, 0}}}));
+    EXPECT_EQ(1, RamAdaptiveQuery::estimateCost({{{5, 0, 0}}}));
+}
+
+TEST(AdaptiveQuery, NestedScans) {
+    // 100 tuples, each joined with 10 tuples
+    EXPECT_EQ(1100, RamAdaptiveQuery::estimateCost({{{100, 2, 0}}, {{100, 2, 1}}}));
+
+    // a lookup binding all arguments adds one test per enclosing tuple
+    EXPECT_EQ(200, RamAdaptiveQuery::estimateCost({{{100, 1, 0}}, {{50, 2, 2}}}));
+}
+
+TEST(AdaptiveQuery, JoinOrder) {
+    // r(x,y) :- s(x), delta_r(x,z), e(z,y). with 5 tuples in s and 200 in e
+
+    // a large delta relation is nested in the scan of the small relation s ...
+    const Scans smallFirst = {{{5, 1, 0}}, {{200, 2, 1}}, {{200, 2, 1}}};
+    const Scans largeDeltaFirst = {{{200, 2, 0}}, {{5, 1, 1}}, {{200, 2, 1}}};
+    EXPECT_LT(RamAdaptiveQuery::estimateCost(smallFirst), RamAdaptiveQuery::estimateCost(largeDeltaFirst));
+
+    // ... while a small delta relation is scanned first
+    const Scans smallDeltaInner = {{{5, 1, 0}}, {{5, 2, 1}}, {{200, 2, 1}}};
+    const Scans smallDeltaFirst = {{{5, 2, 0}}, {{5, 1, 1}}, {{200, 2, 1}}};
+    EXPECT_LT(RamAdaptiveQuery::estimateCost(smallDeltaFirst),
+            RamAdaptiveQuery::estimateCost(smallDeltaInner));
+}
+
+}  // end namespace test
+}  // end namespace souffle
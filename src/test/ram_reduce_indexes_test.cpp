@@ -0,0 +1,128 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2019, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ram_reduce_indexes_test.cpp
+ *
+ * Tests the limit on the number of indexes of relations.
+ *
+ ***********************************************************************/
+
+#include "test.h"
+
+#include "AstTranslationUnit.h"
+#include "AstTranslator.h"
+#include "DebugReport.h"
+#include "ErrorReport.h"
+#include "ParserDriver.h"
+#include "RamIndexAnalysis.h"
+#include "RamTransformer.h"
+#include "RamTransforms.h"
+#include "RamTranslationUnit.h"
+#include "RamVisitor.h"
+#include "SymbolTable.h"
+
+#include <memory>
+#include <string>
+
+namespace souffle {
+
+namespace test {
+
+namespace {
+
+/** Searches A on each of its columns and on the first two of them */
+const std::string program = R"(
+    .decl A(x:number, y:number, z:number)
+    .decl B(x:number)
+    .decl R(x:number, y:number, z:number)
+    .decl S(x:number, y:number, z:number)
+    .decl T(x:number, y:number, z:number)
+    .decl U(x:number, y:number, z:number)
+    .output R, S, T, U
+
+    A(1, 2, 3).
+    A(2, 3, 1).
+    A(3, 1, 2).
+    B(1).
+    B(2).
+
+    R(x, y, z) :- B(x), A(x, y, z).
+    S(x, y, z) :- B(y), A(x, y, z).
+    T(x, y, z) :- B(z), A(x, y, z).
+    U(x, y, z) :- B(x), B(y), A(x, y, z).
+)";
+
+std::unique_ptr<RamTranslationUnit> translate(SymbolTable& sym, ErrorReport& e, DebugReport& d) {
+    std::unique_ptr<AstTranslationUnit> tu = ParserDriver::parseTranslationUnit(program, sym, e, d);
+    std::unique_ptr<RamTranslationUnit> ramTu = AstTranslator().translateUnit(*tu);
+    // the index operations as before the reduction in the transformation pipeline
+    RamLoopTransformer(std::make_unique<RamTransformerSequence>(std::make_unique<ExpandFilterTransformer>(),
+                               std::make_unique<HoistConditionsTransformer>(),
+                               std::make_unique<MakeIndexTransformer>()))
+            .apply(*ramTu);
+    return ramTu;
+}
+
+/** Obtains the indexes of A */
+MinIndexSelection& getIndexes(RamTranslationUnit& tu) {
+    return tu.getAnalysis<RamIndexAnalysis>()->getIndexes(*tu.getProgram()->getRelation("A"));
+}
+
+/** Checks whether every search of A is answered by a prefix of one of its indexes */
+bool coversSearches(RamTranslationUnit& tu) {
+    auto* idxAnalysis = tu.getAnalysis<RamIndexAnalysis>();
+    const MinIndexSelection& indexes = getIndexes(tu);
+    bool covered = true;
+    visitDepthFirst(*tu.getProgram(), [&](const RamIndexOperation& op) {
+        if (op.getRelation().getName() != "A") {
+            return;
+        }
+        SearchSignature search = idxAnalysis->getSearchSignature(&op);
+        SearchSignature prefix = 0;
+        for (int column : indexes.getLexOrder(search)) {
+            if ((search & (1 << column)) == 0) {
+                break;
+            }
+            prefix |= 1 << column;
+        }
+        covered = covered && prefix == search;
+    });
+    return covered;
+}
+
+}  // namespace
+
+TEST(ReduceIndexes, Unlimited) {
+    SymbolTable sym;
+    ErrorReport e;
+    DebugReport d;
+    auto tu = translate(sym, e, d);
+    EXPECT_EQ(3, getIndexes(*tu).getAllOrders().size());
+
+    // a limit above the number of indexes leaves the program untouched
+    EXPECT_FALSE(ReduceIndexesTransformer(3).apply(*tu));
+    EXPECT_EQ(3, getIndexes(*tu).getAllOrders().size());
+    EXPECT_TRUE(coversSearches(*tu));
+}
+
+TEST(ReduceIndexes, Limit) {
+    for (size_t limit = 1; limit <= 2; ++limit) {
+        SymbolTable sym;
+        ErrorReport e;
+        DebugReport d;
+        auto tu = translate(sym, e, d);
+        EXPECT_TRUE(ReduceIndexesTransformer(limit).apply(*tu));
+        EXPECT_TRUE(getIndexes(*tu).getAllOrders().size() <= limit);
+        EXPECT_TRUE(coversSearches(*tu));
+    }
+}
+
+}  // end namespace test
+}  // end namespace souffle
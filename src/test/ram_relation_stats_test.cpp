@@ -8,113 +8,100 @@
 
 /************************************************************************
  *
- * @file ram_relation_stats_test.h
+ * @file ram_relation_stats_test.cpp
  *
- * Tests for the ram relation statistics extraction utility.
+ * Tests for the relation statistics extraction utility.
  *
  ***********************************************************************/
 
-#include "IOSystem.h"
-#include "Interpreter.h"
-#include "ReadStream.h"
 #include "test.h"
 
-#include <fstream>
-#include <memory>
+#include "CompiledTuple.h"
+#include "RelationStats.h"
 
-using namespace souffle;
+#include <vector>
+
+namespace souffle {
 
 namespace test {
 
+template <std::size_t Arity>
+using Relation = std::vector<ram::Tuple<RamDomain, Arity>>;
+
 TEST(Stats, Basic) {
     // create a table
-    InterpreterRelation rel(3);
+    Relation<3> rel;
 
     // add some values
-    rel.insert(1, 1, 1);
-    rel.insert(1, 2, 1);
-    rel.insert(1, 3, 2);
-    rel.insert(1, 4, 2);
+    rel.push_back({{1, 1, 1}});
+    rel.push_back({{1, 2, 1}});
+    rel.push_back({{1, 3, 2}});
+    rel.push_back({{1, 4, 2}});
 
-    RelationStats stats = RelationStats::extractFrom(rel);
+    RelationStats stats = RelationStats::extractFrom(rel, 3);
+
+    EXPECT_EQ(4, stats.getSampleSize());
+    EXPECT_EQ(4, stats.getCardinality());
+    EXPECT_EQ(3, stats.getArity());
 
     EXPECT_EQ(1, stats.getEstimatedCardinality(0));
     EXPECT_EQ(4, stats.getEstimatedCardinality(1));
     EXPECT_EQ(2, stats.getEstimatedCardinality(2));
+
+    EXPECT_EQ(4, stats.getEstimatedMaxFrequency(0));
+    EXPECT_EQ(1, stats.getEstimatedMaxFrequency(1));
+    EXPECT_EQ(2, stats.getEstimatedMaxFrequency(2));
+}
+
+TEST(Stats, Empty) {
+    Relation<2> rel;
+
+    RelationStats stats = RelationStats::extractFrom(rel, 2);
+
+    EXPECT_EQ(0, stats.getSampleSize());
+    EXPECT_EQ(0, stats.getCardinality());
+    EXPECT_EQ(0, stats.getEstimatedCardinality(0));
+    EXPECT_EQ(1, stats.getSkew(1));
 }
 
 TEST(Stats, Function) {
     // create a table
-    InterpreterRelation rel(2);
+    Relation<2> rel;
 
     // add some values
     for (int i = 0; i < 10000; i++) {
-        rel.insert(i, i % 5);
+        rel.push_back({{i, i % 5}});
     }
 
-    RelationStats stats = RelationStats::extractFrom(rel, 100);
+    RelationStats stats = RelationStats::extractFrom(rel, 2, 100);
 
     EXPECT_EQ(100, stats.getSampleSize());
     EXPECT_EQ(10000, stats.getCardinality());
 
     EXPECT_EQ(10000, stats.getEstimatedCardinality(0));
-    EXPECT_EQ(500, stats.getEstimatedCardinality(1));
+    EXPECT_EQ(5, stats.getEstimatedCardinality(1));
 }
 
-TEST(Stats, Convergence) {
-    // load a table
-    InterpreterRelation rel(2);
-
-    SymbolTable symTable;
-
-    SymbolMask mask(2);
-    mask.setSymbol(0);
-    mask.setSymbol(1);
-
-    {
-        std::fstream in(BUILDDIR "../tests/evaluation/hmmer/facts/DirectFlow.facts");
-
-        IODirectives ioDirectives(
-                {{"IO", "file"}, {"filename", BUILDDIR "../tests/evaluation/hmmer/facts/DirectFlow.facts"},
-                        {"delimiter", "\t"}});
-        // if file not found => be done
-        if (!in.is_open()) return;
-
-        std::unique_ptr<ReadStream> reader =
-                IOSystem::getInstance().getReader(mask, symTable, ioDirectives, false);
-        reader->readAll(rel);
+TEST(Stats, Skew) {
+    // a key column where half of the tuples share the same value
+    Relation<2> rel;
+    for (int i = 0; i < 10000; i++) {
+        rel.push_back({{(i % 2 == 0) ? 0 : i, i}});
     }
 
-    std::cout << rel.size() << "\n";
+    RelationStats stats = RelationStats::extractFrom(rel, 2);
 
-    InterpreterRelation rel2(3);
+    EXPECT_EQ(1000, stats.getSampleSize());
 
-    for (const auto& cur : rel) {
-        rel2.insert(cur[0], cur[1], 1);
-    }
+    // the most common value is estimated within a few percent
+    EXPECT_LT(4500, stats.getEstimatedMaxFrequency(0));
+    EXPECT_LT(stats.getEstimatedMaxFrequency(0), 5500);
+    EXPECT_LT(100, stats.getSkew(0));
 
-    RelationStats full = RelationStats::extractFrom(rel2);
-
-    RelationStats s10 = RelationStats::extractFrom(rel2, 10);
-    RelationStats s100 = RelationStats::extractFrom(rel2, 100);
-    RelationStats s1000 = RelationStats::extractFrom(rel2, 1000);
-    RelationStats s10000 = RelationStats::extractFrom(rel2, 10000);
-
-    for (int i = 0; i < 3; i++) {
-        std::cout << "Card " << i << ":\n";
-        std::cout << "\t" << s10.getEstimatedCardinality(i) << " - "
-                  << (s10.getEstimatedCardinality(i) - full.getEstimatedCardinality(i)) << "\n";
-        std::cout << "\t" << s100.getEstimatedCardinality(i) << " - "
-                  << (s100.getEstimatedCardinality(i) - full.getEstimatedCardinality(i)) << "\n";
-        std::cout << "\t" << s1000.getEstimatedCardinality(i) << " - "
-                  << (s1000.getEstimatedCardinality(i) - full.getEstimatedCardinality(i)) << "\n";
-        std::cout << "\t" << s10000.getEstimatedCardinality(i) << " - "
-                  << (s10000.getEstimatedCardinality(i) - full.getEstimatedCardinality(i)) << "\n";
-        std::cout << "\t" << full.getEstimatedCardinality(i) << " - "
-                  << (full.getEstimatedCardinality(i) - full.getEstimatedCardinality(i)) << "\n";
-
-        std::cout << "\n";
-    }
+    // the unique column is not skewed
+    EXPECT_EQ(10000, stats.getEstimatedCardinality(1));
+    EXPECT_EQ(1, stats.getSkew(1));
 }
 
 }  // end namespace test
+}  // end namespace souffle
@@ -0,0 +1,211 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2019, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file read_stream_csv_test.cpp
+ *
+ * Tests souffle's CSV readers.
+ *
+ ***********************************************************************/
+
+#include "test.h"
+
+#include "IODirectives.h"
+#include "IOSystem.h"
+#include "RamTypes.h"
+#include "SymbolTable.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace souffle;
+
+namespace test {
+
+/** A relation collecting all inserted tuples */
+class TupleCollector {
+public:
+    TupleCollector(size_t arity) : arity(arity) {}
+
+    void insert(const RamDomain* tuple) {
+        tuples.emplace_back(tuple, tuple + arity);
+    }
+
+    size_t arity;
+    std::vector<std::vector<RamDomain>> tuples;
+};
+
+/** A temporary fact file, removed when going out of scope */
+class FactFile {
+public:
+    FactFile(const std::string& content) {
+        char name[] = "/tmp/souffle_csv_XXXXXX";
+        int fd = mkstemp(name);
+        close(fd);
+        fileName = name;
+        std::ofstream out(fileName, std::ios::binary);
+        out << content;
+    }
+
+    ~FactFile() {
+        std::remove(fileName.c_str());
+    }
+
+    std::string fileName;
+};
+
+/** Read the given file with the given IO type */
+TupleCollector read(const std::string& ioType, const FactFile& file, const std::vector<bool>& symbolMask,
+        SymbolTable& symbolTable, std::map<std::string, std::string> directives = {}) {
+    directives["IO"] = ioType;
+    directives["name"] = "test";
+    directives["filename"] = file.fileName;
+    IODirectives ioDirectives(directives);
+    TupleCollector relation(symbolMask.size());
+    IOSystem::getInstance().getReader(symbolMask, symbolTable, ioDirectives, false)->readAll(relation);
+    return relation;
+}
+
+TEST(ReadMappedFileCSV, MatchesReadFileCSV) {
+    std::string content;
+    for (int i = 0; i < 20000; ++i) {
+        content += std::to_string(i - 10000) + "\tsym" + std::to_string(i % 97) + "\t";
+        content += std::to_string(i * 7) + (i % 3 == 0 ? "\r\n" : "\n");
+    }
+    FactFile file(content);
+    std::vector<bool> symbolMask = {false, true, false};
+
+    SymbolTable fileSymbols;
+    SymbolTable mappedSymbols;
+    auto expected = read("file", file, symbolMask, fileSymbols);
+    auto actual = read("mmap", file, symbolMask, mappedSymbols);
+
+    EXPECT_EQ(20000, expected.tuples.size());
+    EXPECT_EQ(expected.tuples.size(), actual.tuples.size());
+    EXPECT_TRUE(expected.tuples == actual.tuples);
+
+    // symbols are numbered in order of appearance
+    EXPECT_EQ(fileSymbols.size(), mappedSymbols.size());
+    for (size_t i = 0; i < fileSymbols.size(); ++i) {
+        EXPECT_EQ(fileSymbols.resolve(i), mappedSymbols.resolve(i));
+    }
+}
+
+TEST(ReadMappedFileCSV, Directives) {
+    FactFile file("x,y,z\n1,a,2\n3,b,4\n");
+    std::vector<bool> symbolMask = {false, true};
+    SymbolTable symbolTable;
+
+    auto relation = read("mmap", file, symbolMask, symbolTable,
+            {{"delimiter", ","}, {"headers", "true"}, {"columns", "2:1"}});
+
+    EXPECT_EQ(2, relation.tuples.size());
+    EXPECT_EQ(2, relation.tuples[0][0]);
+    EXPECT_EQ("a", symbolTable.resolve(relation.tuples[0][1]));
+    EXPECT_EQ(4, relation.tuples[1][0]);
+    EXPECT_EQ("b", symbolTable.resolve(relation.tuples[1][1]));
+}
+
+TEST(ReadMappedFileCSV, Errors) {
+    std::vector<bool> symbolMask = {false, false};
+    SymbolTable symbolTable;
+
+    FactFile badNumber("1\t2\n3\tx\n");
+    try {
+        read("mmap", badNumber, symbolMask, symbolTable);
+        EXPECT_TRUE(false);
+    } catch (std::invalid_argument& e) {
+        EXPECT_TRUE(std::string(e.what()).find("Error converting number <x> in column 2 in line 2") !=
+                    std::string::npos);
+    }
+
+    FactFile missing("1\t2\n3\n");
+    try {
+        read("mmap", missing, symbolMask, symbolTable);
+        EXPECT_TRUE(false);
+    } catch (std::invalid_argument& e) {
+        EXPECT_TRUE(std::string(e.what()).find("Values missing in line 2") != std::string::npos);
+    }
+}
+
+/** A relation receiving tuples in batches */
+class BatchCollector : public TupleCollector {
+public:
+    BatchCollector(size_t arity) : TupleCollector(arity) {}
+
+    void insertBatch(const RamDomain* tuples, size_t numTuples) {
+        for (size_t i = 0; i < numTuples; ++i) {
+            insert(tuples + i * arity);
+        }
+        batches++;
+    }
+
+    size_t batches = 0;
+};
+
+TEST(ReadStream, Batches) {
+    std::string content;
+    for (int i = 0; i < 10000; ++i) {
+        content += std::to_string(i) + "\t" + std::to_string(-i) + "\n";
+    }
+    FactFile file(content);
+    std::vector<bool> symbolMask = {false, false};
+
+    for (const std::string ioType : {"file", "mmap"}) {
+        SymbolTable symbolTable;
+        IODirectives ioDirectives({{"IO", ioType}, {"name", "test"}, {"filename", file.fileName}});
+        BatchCollector relation(2);
+        IOSystem::getInstance().getReader(symbolMask, symbolTable, ioDirectives, false)->readAll(relation);
+
+        // relations with a batch insertion receive whole batches
+        EXPECT_LT(1, relation.batches);
+        EXPECT_LT(relation.batches, 10);
+        EXPECT_EQ(10000, relation.tuples.size());
+        for (size_t i = 0; i < relation.tuples.size(); ++i) {
+            EXPECT_EQ(RamDomain(i), relation.tuples[i][0]);
+            EXPECT_EQ(-RamDomain(i), relation.tuples[i][1]);
+        }
+    }
+}
+
+TEST(ReadMappedFileCSV, Throughput) {
+    // whether to print the recorded times to stdout
+    // should be false unless developing
+    const bool ECHO_TIME = false;
+
+    const int N = 1000000;  // number of lines
+    std::string content;
+    for (int i = 0; i < N; ++i) {
+        content += std::to_string(i) + "\t" + std::to_string(i % 1000);
+        content += "\tsym" + std::to_string(i % 10000) + "\n";
+    }
+    FactFile file(content);
+    std::vector<bool> symbolMask = {false, false, true};
+
+    for (const std::string ioType : {"file", "mmap"}) {
+        SymbolTable symbolTable;
+        auto start = std::chrono::high_resolution_clock::now();
+        auto relation = read(ioType, file, symbolMask, symbolTable);
+        auto end = std::chrono::high_resolution_clock::now();
+        EXPECT_EQ(N, relation.tuples.size());
+        if (ECHO_TIME) {
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+            std::cout << "IO=" << ioType << ": " << N << " lines in " << ms << " ms" << std::endl;
+        }
+    }
+}
+
+}  // namespace test
@@ -0,0 +1,279 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2019, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file record_table_test.cpp
+ *
+ * Tests the concurrent record maps of the interpreters and synthesized programs.
+ *
+ ***********************************************************************/
+
+#include "test.h"
+
+#include "CompiledRecord.h"
+#include "CompiledTuple.h"
+#include "RecordTable.h"
+#include "Util.h"
+
+#include <iostream>
+#include <map>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace souffle {
+
+namespace test {
+
+TEST(RecordTable, Basics) {
+    RecordTable table;
+
+    RamDomain a[] = {1, 2};
+    RamDomain b[] = {2, 1};
+
+    RamDomain ra = table.pack(a, 2);
+    RamDomain rb = table.pack(b, 2);
+
+    // references are distinct from the null reference and each other
+    EXPECT_NE(0, ra);
+    EXPECT_NE(0, rb);
+    EXPECT_NE(ra, rb);
+
+    // packing is idempotent and independent of the location of the tuple
+    RamDomain c[] = {1, 2};
+    EXPECT_EQ(ra, table.pack(a, 2));
+    EXPECT_EQ(ra, table.pack(c, 2));
+
+    EXPECT_EQ(1, table.unpack(ra, 2)[0]);
+    EXPECT_EQ(2, table.unpack(ra, 2)[1]);
+    EXPECT_EQ(2, table.unpack(rb, 2)[0]);
+    EXPECT_EQ(1, table.unpack(rb, 2)[1]);
+
+    // the tuple is copied on packing
+    a[0] = 5;
+    EXPECT_EQ(1, table.unpack(ra, 2)[0]);
+}
+
+TEST(RecordTable, Arities) {
+    RecordTable table;
+
+    // records of different arities are independent
+    RamDomain empty[] = {0};
+    std::vector<RamDomain> large(100);
+    for (std::size_t i = 0; i < large.size(); ++i) {
+        large[i] = i;
+    }
+
+    EXPECT_EQ(table.pack(empty, 0), table.pack(empty, 0));
+    EXPECT_EQ(table.pack(&large[0], 1), table.pack(&large[0], 100));
+
+    RamDomain ref = table.pack(&large[0], 100);
+    for (std::size_t i = 0; i < large.size(); ++i) {
+        EXPECT_EQ(large[i], table.unpack(ref, 100)[i]);
+    }
+    EXPECT_EQ(0, table.unpack(table.pack(&large[0], 1), 1)[0]);
+}
+
+TEST(RecordTable, ManyRecords) {
+    const RamDomain N = 100000;
+
+    RecordTable table;
+
+    // build a list of nested records, spanning multiple blocks of storage
+    RamDomain list = 0;
+    std::vector<RamDomain> refs;
+    for (RamDomain i = 0; i < N; ++i) {
+        RamDomain cell[] = {i, list};
+        list = table.pack(cell, 2);
+        refs.push_back(list);
+    }
+
+    for (RamDomain i = N - 1; i >= 0; --i) {
+        const RamDomain* cell = table.unpack(list, 2);
+        EXPECT_EQ(i, cell[0]);
+        EXPECT_EQ(refs[i], list);
+        list = cell[1];
+    }
+    EXPECT_EQ(0, list);
+}
+
+TEST(RecordTable, ParallelPack) {
+    const RamDomain N = 100000;
+
+    RecordTable table;
+    std::vector<RamDomain> refs(N);
+
+    // every record is packed twice concurrently, both must observe the same reference
+#pragma omp parallel for
+    for (RamDomain i = 0; i < 2 * N; ++i) {
+        RamDomain tuple[] = {i % N, -(i % N), 7};
+        RamDomain ref = table.pack(tuple, 3);
+        if (i < N) {
+            refs[i] = ref;
+        }
+    }
+
+    std::vector<bool> seen(N + 1, false);
+    for (RamDomain i = 0; i < N; ++i) {
+        RamDomain tuple[] = {i, -i, 7};
+        EXPECT_EQ(refs[i], table.pack(tuple, 3));
+        EXPECT_LT(0, refs[i]);
+        EXPECT_LT(refs[i], N + 1);
+        EXPECT_FALSE(seen[refs[i]]);
+        seen[refs[i]] = true;
+
+        const RamDomain* res = table.unpack(refs[i], 3);
+        EXPECT_EQ(i, res[0]);
+        EXPECT_EQ(-i, res[1]);
+        EXPECT_EQ(7, res[2]);
+    }
+}
+
+TEST(CompiledRecord, PackUnpack) {
+    using tuple = ram::Tuple<RamDomain, 5>;
+
+    tuple a = {{1, 2, 3, 4, 5}};
+    tuple b = {{5, 4, 3, 2, 1}};
+
+    RamDomain ra = pack(a);
+    RamDomain rb = pack(b);
+    EXPECT_FALSE(isNull<tuple>(ra));
+    EXPECT_NE(ra, rb);
+    EXPECT_EQ(ra, pack(tuple(a)));
+
+    EXPECT_EQ(a, unpack<tuple>(ra));
+    EXPECT_EQ(b, unpack<tuple>(rb));
+
+    // two distinct records from three packs, the last one hitting the first record
+    EXPECT_EQ(2, detail::getRecordMap<tuple>().size());
+    EXPECT_EQ(3, detail::getRecordMap<tuple>().getPackCount());
+}
+
+/**
+ * The previous record map of the interpreters, serving as a baseline for the throughput.
+ */
+class OrderedRecordMap {
+    int arity;
+    std::map<std::vector<RamDomain>, RamDomain> r2i;
+    std::vector<std::vector<RamDomain>> i2r;
+
+public:
+    OrderedRecordMap(int arity) : arity(arity), i2r(1) {}
+
+    RamDomain pack(const RamDomain* tuple) {
+        std::vector<RamDomain> tmp(tuple, tuple + arity);
+        RamDomain index;
+#pragma omp critical(record_pack)
+        {
+            auto pos = r2i.find(tmp);
+            if (pos != r2i.end()) {
+                index = pos->second;
+            } else {
+#pragma omp critical(record_unpack)
+                {
+                    i2r.push_back(tmp);
+                    index = i2r.size() - 1;
+                    r2i[tmp] = index;
+                }
+            }
+        }
+        return index;
+    }
+
+    const RamDomain* unpack(RamDomain index) {
+        const RamDomain* res;
+#pragma omp critical(record_unpack)
+        res = &(i2r[index][0]);
+        return res;
+    }
+};
+
+/** The number of records packed by each thread when measuring the throughput */
+const RamDomain RECORDS_PER_THREAD = 200000;
+
+/**
+ * Measures the throughput of packing and unpacking lists of nested records, each thread
+ * building its own list, for the given packing and unpacking operations. Returns a checksum
+ * of the unpacked records.
+ */
+template <typename Pack, typename Unpack>
+std::size_t measureThroughput(const std::string& name, const Pack& pack, const Unpack& unpack, int threads) {
+    // whether to print the recorded times to stdout
+    // should be false unless developing
+    const bool ECHO_TIME = false;
+
+    const RamDomain N = RECORDS_PER_THREAD;
+
+    std::vector<RamDomain> lists(threads);
+    std::size_t checksum = 0;
+
+    time_point start = now();
+#pragma omp parallel for num_threads(threads)
+    for (int t = 0; t < threads; ++t) {
+        RamDomain list = 0;
+        for (RamDomain i = 0; i < N; ++i) {
+            RamDomain cell[] = {i, t, list};
+            list = pack(cell);
+        }
+        lists[t] = list;
+    }
+    time_point end = now();
+    long packTime = duration_in_ns(start, end);
+
+    start = now();
+#pragma omp parallel for num_threads(threads) reduction(+ : checksum)
+    for (int t = 0; t < threads; ++t) {
+        RamDomain list = lists[t];
+        while (list != 0) {
+            const RamDomain* cell = unpack(list);
+            checksum += cell[0];
+            checksum += pack(cell) == list;
+            list = cell[2];
+        }
+    }
+    end = now();
+    long lookupTime = duration_in_ns(start, end);
+
+    if (ECHO_TIME) {
+        std::cout << name << " - threads: " << threads
+                  << ", pack throughput: " << (N * threads * 1000.0) / packTime
+                  << " M ops/s, repack+unpack throughput: " << (2 * N * threads * 1000.0) / lookupTime
+                  << " M ops/s" << std::endl;
+    }
+
+    return checksum;
+}
+
+TEST(RecordTable, PackUnpackThroughput) {
+#ifdef _OPENMP
+    const int maxThreads = omp_get_max_threads();
+#else
+    const int maxThreads = 1;
+#endif
+
+    const std::size_t N = RECORDS_PER_THREAD;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        // the sum of all list elements and one for each successful repacking
+        const std::size_t expected = threads * (N + (N * (N - 1)) / 2);
+
+        RecordTable table;
+        EXPECT_EQ(expected,
+                measureThroughput("record table", [&](const RamDomain* tuple) { return table.pack(tuple, 3); },
+                        [&](RamDomain ref) { return table.unpack(ref, 3); }, threads));
+
+        OrderedRecordMap map(3);
+        EXPECT_EQ(expected, measureThroughput("ordered map", [&](const RamDomain* tuple) { return map.pack(tuple); },
+                                    [&](RamDomain ref) { return map.unpack(ref); }, threads));
+    }
+}
+
+}  // end namespace test
+}  // end namespace souffle
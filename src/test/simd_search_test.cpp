@@ -0,0 +1,229 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2019, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file simd_search_test.cpp
+ *
+ * Test cases and microbenchmarks for the SIMD search strategy of b-trees.
+ *
+ ***********************************************************************/
+
+#include "test.h"
+
+#include "BTree.h"
+#include "CompiledIndexUtils.h"
+#include "CompiledTuple.h"
+#include "SimdSearch.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace souffle {
+namespace test {
+
+using namespace ram;
+using detail::binary_search;
+using detail::linear_search;
+using detail::simd_search;
+
+/** Obtains n sorted random tuples with values in [0, range) */
+template <std::size_t Arity, typename Comp>
+std::vector<Tuple<RamDomain, Arity>> getSortedTuples(std::size_t n, int range, std::mt19937& random) {
+    std::uniform_int_distribution<RamDomain> values(0, range - 1);
+    std::vector<Tuple<RamDomain, Arity>> res(n);
+    for (auto& tuple : res) {
+        for (std::size_t i = 0; i < Arity; ++i) {
+            tuple[i] = values(random);
+        }
+    }
+    Comp comp;
+    std::sort(res.begin(), res.end(),
+            [&](const Tuple<RamDomain, Arity>& a, const Tuple<RamDomain, Arity>& b) { return comp.less(a, b); });
+    return res;
+}
+
+/**
+ * Counts the lookups in sorted ranges of up to 40 tuples, as found in b-tree nodes,
+ * for which the SIMD search strategy deviates from the binary search strategy.
+ */
+template <std::size_t Arity, unsigned... Columns>
+int countDeviations() {
+    using tuple = Tuple<RamDomain, Arity>;
+    using comp_type = index_utils::comparator<Columns...>;
+    std::mt19937 random(Arity);
+    comp_type comp;
+    int deviations = 0;
+    for (std::size_t n = 0; n <= 40; ++n) {
+        // small ranges of values lead to duplicates and equal prefixes
+        auto keys = getSortedTuples<Arity, comp_type>(n, 4, random);
+        auto probes = getSortedTuples<Arity, comp_type>(20, 5, random);
+        const tuple* a = keys.data();
+        const tuple* b = keys.data() + keys.size();
+        for (const auto& k : probes) {
+            // multiple equal elements may be found, the lower bound is the first of them
+            const tuple* found = simd_search()(k, a, b, comp);
+            const tuple* lower = binary_search().lower_bound(k, a, b, comp);
+            if (found != lower) deviations++;
+            if (simd_search().lower_bound(k, a, b, comp) != lower) deviations++;
+            if (simd_search().upper_bound(k, a, b, comp) != binary_search().upper_bound(k, a, b, comp)) {
+                deviations++;
+            }
+        }
+    }
+    return deviations;
+}
+
+TEST(SimdSearch, Bounds) {
+    EXPECT_EQ(0, (countDeviations<1, 0>()));
+    EXPECT_EQ(0, (countDeviations<2, 0, 1>()));
+    EXPECT_EQ(0, (countDeviations<2, 1, 0>()));
+    EXPECT_EQ(0, (countDeviations<2, 1>()));
+    EXPECT_EQ(0, (countDeviations<3, 0, 1, 2>()));
+    EXPECT_EQ(0, (countDeviations<3, 2, 0>()));
+    EXPECT_EQ(0, (countDeviations<4, 3, 1, 0, 2>()));
+    EXPECT_EQ(0, (countDeviations<9, 8, 0, 4, 1, 2, 3, 5, 6, 7>()));
+}
+
+TEST(SimdSearch, InstructionSets) {
+#ifdef SOUFFLE_SIMD_SEARCH
+    using tuple = Tuple<RamDomain, 3>;
+    using comp_type = index_utils::comparator<2, 0, 1>;
+    std::mt19937 random(3);
+    auto keys = getSortedTuples<3, comp_type>(37, 3, random);
+    auto probes = getSortedTuples<3, comp_type>(100, 4, random);
+    comp_type comp;
+    const auto instructionSet = simd_utils::getInstructionSet();
+    for (std::size_t n = 0; n <= keys.size(); ++n) {
+        const tuple* a = keys.data();
+        const tuple* b = keys.data() + n;
+        for (const auto& k : probes) {
+            std::size_t lower = binary_search().lower_bound(k, a, b, comp) - a;
+            std::size_t upper = binary_search().upper_bound(k, a, b, comp) - a;
+            if (instructionSet != simd_utils::InstructionSet::NONE) {
+                EXPECT_EQ(lower, (simd_utils::scanSSE4<3, false, 2, 0, 1>(a->data, n, k.data)));
+                EXPECT_EQ(upper, (simd_utils::scanSSE4<3, true, 2, 0, 1>(a->data, n, k.data)));
+            }
+            if (instructionSet == simd_utils::InstructionSet::AVX2) {
+                EXPECT_EQ(lower, (simd_utils::scanAVX2<3, false, 2, 0, 1>(a->data, n, k.data)));
+                EXPECT_EQ(upper, (simd_utils::scanAVX2<3, true, 2, 0, 1>(a->data, n, k.data)));
+            }
+        }
+    }
+#endif
+}
+
+TEST(SimdSearch, BTree) {
+    using tuple = Tuple<RamDomain, 2>;
+    using comp_type = index_utils::comparator<1, 0>;
+    using simd_set = btree_set<tuple, comp_type, std::allocator<tuple>, 256, simd_search>;
+    using simd_multiset = btree_multiset<tuple, comp_type, std::allocator<tuple>, 256, simd_search>;
+
+    std::mt19937 random(2);
+    std::uniform_int_distribution<RamDomain> values(-1000, 1000);
+    simd_set set;
+    simd_multiset multiset;
+    std::multiset<tuple> should;
+    for (int i = 0; i < 20000; ++i) {
+        tuple t = {{values(random), values(random) / 100}};
+        set.insert(t);
+        multiset.insert(t);
+        should.insert(t);
+    }
+
+    EXPECT_TRUE(set.check());
+    EXPECT_TRUE(multiset.check());
+    EXPECT_EQ(std::set<tuple>(should.begin(), should.end()).size(), set.size());
+    EXPECT_EQ(should.size(), multiset.size());
+    for (int i = 0; i < 1000; ++i) {
+        tuple t = {{values(random), values(random) / 100}};
+        EXPECT_EQ(should.count(t) > 0, set.contains(t));
+        EXPECT_EQ(should.count(t), std::size_t(std::distance(multiset.lower_bound(t), multiset.upper_bound(t))));
+    }
+}
+
+/**
+ * Times inserting random tuples into a b-tree and looking them up, using the given search strategy,
+ * and returns the number of tuples found
+ */
+template <std::size_t Arity, typename Strategy>
+std::size_t benchmark(const std::string& name, bool echoTime) {
+    using tuple = Tuple<RamDomain, Arity>;
+    using comp_type = typename index_utils::get_full_index<Arity>::type::comparator;
+    using set_type = btree_set<tuple, comp_type, std::allocator<tuple>, 256, Strategy>;
+
+    std::mt19937 random(Arity);
+    std::uniform_int_distribution<RamDomain> values(0, 1000);
+    std::vector<tuple> data(1 << 16);
+    for (auto& t : data) {
+        for (std::size_t i = 0; i < Arity; ++i) {
+            t[i] = values(random);
+        }
+    }
+
+    time_point start = now();
+    set_type set;
+    for (const auto& t : data) {
+        set.insert(t);
+    }
+    time_point end = now();
+    long insertTime = duration_in_us(start, end);
+
+    std::size_t found = 0;
+    start = now();
+    for (const auto& t : data) {
+        found += set.contains(t);
+    }
+    end = now();
+    long lookupTime = duration_in_us(start, end);
+
+    // repeated lookups in a tree fitting into the cache, dominated by the search in nodes
+    set_type small(data.begin(), data.begin() + (1 << 12));
+    start = now();
+    for (const auto& t : data) {
+        found += small.contains(t);
+    }
+    end = now();
+    long cachedTime = duration_in_us(start, end);
+
+    if (echoTime) {
+        std::cout << "arity " << Arity << " - " << name << ": insert " << insertTime << "us, lookup "
+                  << lookupTime << "us, lookup (cached) " << cachedTime << "us" << std::endl;
+    }
+    return found;
+}
+
+TEST(Performance, SimdSearch) {
+    // whether to print the recorded times to stdout
+    // should be false unless developing
+    const bool ECHO_TIME = false;
+
+    std::size_t found = benchmark<1, linear_search>("linear", ECHO_TIME);
+    EXPECT_EQ(found, (benchmark<1, binary_search>("binary", ECHO_TIME)));
+    EXPECT_EQ(found, (benchmark<1, simd_search>("simd", ECHO_TIME)));
+
+    found = benchmark<2, linear_search>("linear", ECHO_TIME);
+    EXPECT_EQ(found, (benchmark<2, binary_search>("binary", ECHO_TIME)));
+    EXPECT_EQ(found, (benchmark<2, simd_search>("simd", ECHO_TIME)));
+
+    found = benchmark<3, linear_search>("linear", ECHO_TIME);
+    EXPECT_EQ(found, (benchmark<3, binary_search>("binary", ECHO_TIME)));
+    EXPECT_EQ(found, (benchmark<3, simd_search>("simd", ECHO_TIME)));
+
+    found = benchmark<4, linear_search>("linear", ECHO_TIME);
+    EXPECT_EQ(found, (benchmark<4, binary_search>("binary", ECHO_TIME)));
+    EXPECT_EQ(found, (benchmark<4, simd_search>("simd", ECHO_TIME)));
+}
+
+}  // namespace test
+}  // namespace souffle
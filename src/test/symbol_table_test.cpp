@@ -18,6 +18,12 @@
 #include "test.h"
 
 #include <functional>
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace souffle;
 
@@ -140,4 +146,100 @@ TEST(SymbolTable, Inserts) {
     if (ECHO_TIME) std::cout << "Time to insert " << N << " new elements: " << n << " ns" << std::endl;
 }
 
+TEST(SymbolTable, ParallelInserts) {
+    const size_t N = 100000;
+
+    SymbolTable X;
+    std::vector<RamDomain> indices(N);
+
+    // every symbol is inserted twice concurrently, both must observe the same index
+#pragma omp parallel for
+    for (size_t i = 0; i < 2 * N; ++i) {
+        RamDomain index = X.lookup(std::to_string(i % N) + "string");
+        if (i < N) {
+            indices[i] = index;
+        }
+    }
+
+    EXPECT_EQ(N, X.size());
+
+    std::vector<bool> seen(N, false);
+    for (size_t i = 0; i < N; ++i) {
+        std::string symbol = std::to_string(i) + "string";
+        EXPECT_EQ(indices[i], X.lookup(symbol));
+        EXPECT_EQ(symbol, X.resolve(indices[i]));
+        EXPECT_LT(static_cast<size_t>(indices[i]), N);
+        EXPECT_FALSE(seen[indices[i]]);
+        seen[indices[i]] = true;
+    }
+}
+
+TEST(SymbolTable, ParallelResolveWhileInserting) {
+    const size_t N = 100000;
+
+    SymbolTable X;
+    bool consistent = true;
+
+    // half of the threads insert new symbols, the other half resolves every index reported by size()
+#pragma omp parallel for reduction(&& : consistent)
+    for (size_t i = 0; i < 2 * N; ++i) {
+        if (i % 2 == 0) {
+            X.lookup(std::to_string(i / 2) + "string");
+        } else {
+            const size_t size = X.size();
+            if (size > 0) {
+                const std::string& symbol = X.resolve(static_cast<RamDomain>((i * 7919) % size));
+                consistent = consistent && symbol.size() > std::string("string").size();
+            }
+        }
+    }
+
+    EXPECT_TRUE(consistent);
+    EXPECT_EQ(N, X.size());
+}
+
+TEST(SymbolTable, ParallelLookupThroughput) {
+    // whether to print the recorded times to stdout
+    // should be false unless developing
+    const bool ECHO_TIME = false;
+
+    const size_t N = 1000000;  // number of lookups per measurement
+    const size_t M = 10000;    // number of distinct symbols
+
+    SymbolTable X;
+    std::vector<std::string> A;
+    A.reserve(M);
+    for (size_t i = 0; i < M; ++i) {
+        A.push_back(std::to_string(i) + "string");
+        X.insert(A.back());
+    }
+
+#ifdef _OPENMP
+    const int maxThreads = omp_get_max_threads();
+#else
+    const int maxThreads = 1;
+#endif
+
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        size_t checksum = 0;
+        time_point start = now();
+#pragma omp parallel for num_threads(threads) reduction(+ : checksum)
+        for (size_t i = 0; i < N; ++i) {
+            const std::string& symbol = A[(i * 7919) % M];
+            checksum += X.resolve(X.lookup(symbol)).size();
+        }
+        time_point end = now();
+        long n = duration_in_ns(start, end);
+
+        if (ECHO_TIME) {
+            std::cout << "Threads: " << threads << ", lookup+resolve throughput: " << (N * 1000.0) / n
+                      << " M ops/s" << std::endl;
+        }
+
+        EXPECT_LT(N, checksum);
+    }
+
+    EXPECT_EQ(M, X.size());
+}
+
 }  // end namespace test